@@ -0,0 +1,89 @@
+#include "cfg.h"
+
+namespace {
+
+struct UsedRegistersCollector {
+    std::vector<Register> operator()(const CasInstruction& instruction) const {
+        return {instruction.addr, instruction.expected, instruction.desired};
+    }
+    std::vector<Register> operator()(const FaiInstruction& instruction) const {
+        return {instruction.addr, instruction.increment};
+    }
+    std::vector<Register> operator()(const FetchOpInstruction& instruction) const {
+        return {instruction.addr, instruction.operand};
+    }
+    std::vector<Register> operator()(const LoadInstruction& instruction) const {
+        return {instruction.addr};
+    }
+    std::vector<Register> operator()(const StoreInstruction& instruction) const {
+        return {instruction.addr, instruction.src};
+    }
+    std::vector<Register> operator()(const FenceInstruction&) const {
+        return {};
+    }
+    std::vector<Register> operator()(const RegisterConstantAssignment&) const {
+        return {};
+    }
+    std::vector<Register> operator()(const RegisterBinOpAssignment& instruction) const {
+        return {instruction.lhs, instruction.rhs};
+    }
+    std::vector<Register> operator()(const IfInstruction& instruction) const {
+        return {instruction.cond};
+    }
+};
+
+struct DefinedRegisterCollector {
+    std::optional<Register> operator()(const CasInstruction& instruction) const {
+        return instruction.dst;
+    }
+    std::optional<Register> operator()(const FaiInstruction& instruction) const {
+        return instruction.dst;
+    }
+    std::optional<Register> operator()(const FetchOpInstruction& instruction) const {
+        return instruction.dst;
+    }
+    std::optional<Register> operator()(const LoadInstruction& instruction) const {
+        return instruction.dst;
+    }
+    std::optional<Register> operator()(const StoreInstruction&) const {
+        return std::nullopt;
+    }
+    std::optional<Register> operator()(const FenceInstruction&) const {
+        return std::nullopt;
+    }
+    std::optional<Register> operator()(const RegisterConstantAssignment& instruction) const {
+        return instruction.dst;
+    }
+    std::optional<Register> operator()(const RegisterBinOpAssignment& instruction) const {
+        return instruction.dst;
+    }
+    std::optional<Register> operator()(const IfInstruction&) const {
+        return std::nullopt;
+    }
+};
+
+}  // namespace
+
+std::vector<Register> GetUsedRegisters(const Instruction& instruction) {
+    return std::visit(UsedRegistersCollector{}, instruction);
+}
+
+std::optional<Register> GetDefinedRegister(const Instruction& instruction) {
+    return std::visit(DefinedRegisterCollector{}, instruction);
+}
+
+std::vector<size_t> GetSuccessors(const std::vector<Instruction>& instructions, size_t ip) {
+    if (auto if_instruction = std::get_if<IfInstruction>(&instructions[ip])) {
+        if (if_instruction->instr_on_success == ip + 1) {
+            return {ip + 1};
+        }
+        return {ip + 1, if_instruction->instr_on_success};
+    }
+    return {ip + 1};
+}
+
+bool IsThreadLocal(const Instruction& instruction) {
+    return std::holds_alternative<RegisterConstantAssignment>(instruction)
+        || std::holds_alternative<RegisterBinOpAssignment>(instruction)
+        || std::holds_alternative<IfInstruction>(instruction);
+}
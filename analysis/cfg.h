@@ -0,0 +1,20 @@
+#ifndef CFG_H
+#define CFG_H
+#include "../instruction/instruction.h"
+
+#include <optional>
+#include <vector>
+
+// registers whose values are read by the instruction
+std::vector<Register> GetUsedRegisters(const Instruction& instruction);
+
+// register whose value is overwritten by the instruction
+std::optional<Register> GetDefinedRegister(const Instruction& instruction);
+
+// instructions that may be executed right after the one at `ip`, instructions.size() stands for thread completion
+std::vector<size_t> GetSuccessors(const std::vector<Instruction>& instructions, size_t ip);
+
+// true for instructions that touch neither shared memory nor store buffers
+bool IsThreadLocal(const Instruction& instruction);
+
+#endif //CFG_H
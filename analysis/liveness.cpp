@@ -0,0 +1,63 @@
+#include "liveness.h"
+#include "cfg.h"
+
+namespace {
+
+std::vector<bool> GetLiveOnCompletion(const ProgramDescriptor& descriptor, size_t thread_id, bool verdict_only) {
+    if (!verdict_only || !descriptor.final_condition) {
+        return std::vector<bool>(descriptor.register_name.size(), true);
+    }
+    std::vector<bool> live(descriptor.register_name.size(), false);
+    for (auto& node : descriptor.final_condition->nodes) {
+        if (auto atom = std::get_if<RegisterEquals>(&node); atom && atom->thread_id == thread_id) {
+            live[atom->reg] = true;
+        }
+    }
+    return live;
+}
+
+}  // namespace
+
+LivenessInfo ComputeLiveness(const ProgramDescriptor& descriptor, size_t threads_cnt, bool verdict_only) {
+    auto& instructions = descriptor.instructions;
+    size_t registers_cnt = descriptor.register_name.size();
+    LivenessInfo info;
+    for (size_t tid = 0; tid < threads_cnt; ++tid) {
+        std::vector<std::vector<bool>> live_in(instructions.size() + 1, std::vector<bool>(registers_cnt, false));
+        live_in[instructions.size()] = GetLiveOnCompletion(descriptor, tid, verdict_only);
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t ip = instructions.size(); ip > 0; --ip) {
+                size_t cur = ip - 1;
+                std::vector<bool> live(registers_cnt, false);
+                for (size_t successor : GetSuccessors(instructions, cur)) {
+                    for (Register reg = 0; reg < registers_cnt; ++reg) {
+                        if (live_in[successor][reg]) {
+                            live[reg] = true;
+                        }
+                    }
+                }
+                if (auto defined = GetDefinedRegister(instructions[cur])) {
+                    live[*defined] = false;
+                }
+                for (Register reg : GetUsedRegisters(instructions[cur])) {
+                    live[reg] = true;
+                }
+                if (live != live_in[cur]) {
+                    live_in[cur] = std::move(live);
+                    changed = true;
+                }
+            }
+        }
+        auto& thread_live_registers = info.live_registers.emplace_back(instructions.size() + 1);
+        for (size_t ip = 0; ip <= instructions.size(); ++ip) {
+            for (Register reg = 0; reg < registers_cnt; ++reg) {
+                if (live_in[ip][reg]) {
+                    thread_live_registers[ip].push_back(reg);
+                }
+            }
+        }
+    }
+    return info;
+}
@@ -0,0 +1,23 @@
+#ifndef LIVENESS_H
+#define LIVENESS_H
+#include "../common/program_descriptor.h"
+
+#include <vector>
+
+/**
+ * Registers whose current values may still be read before being overwritten.
+ * Values of other registers don't affect the rest of the execution, so they are masked
+ * when states are compared.
+ */
+struct LivenessInfo {
+    // [thread][ip] -> live registers before executing the instruction, ip == instructions.size() is thread completion
+    std::vector<std::vector<std::vector<Register>>> live_registers;
+};
+
+/**
+ * Registers are observable after thread completion: all of them, or, when only the verdict of the final
+ * condition matters, the ones mentioned in it.
+ */
+LivenessInfo ComputeLiveness(const ProgramDescriptor& descriptor, size_t threads_cnt, bool verdict_only);
+
+#endif //LIVENESS_H
@@ -0,0 +1,17 @@
+#include "program_analysis.h"
+
+std::shared_ptr<const ProgramAnalysis> AnalyzeProgram(
+        const ProgramDescriptor& descriptor,
+        const std::vector<size_t>& instruction_pointers,
+        const ExplorationOptions& options
+) {
+    auto analysis = std::make_shared<ProgramAnalysis>();
+    if (options.await_spin_loops) {
+        analysis->spin_loops = FindSpinLoops(descriptor);
+    }
+    if (options.eager_private_propagation) {
+        analysis->shared_access = AnalyzeSharedAccess(descriptor, instruction_pointers);
+    }
+    analysis->liveness = ComputeLiveness(descriptor, instruction_pointers.size(), options.verdict_only);
+    return analysis;
+}
@@ -0,0 +1,35 @@
+#ifndef PROGRAM_ANALYSIS_H
+#define PROGRAM_ANALYSIS_H
+#include "spin_loops.h"
+#include "liveness.h"
+#include "shared_access.h"
+#include "../common/program_descriptor.h"
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+struct ExplorationOptions {
+    // threads in busy-wait loops are blocked until some other transition changes a value they read
+    bool await_spin_loops = false;
+    // pending writes to cells accessed by a single thread are propagated right away instead of branching on them
+    bool eager_private_propagation = false;
+    // only the verdict of the final condition is reported, so registers it doesn't mention are dead in completed
+    // threads; outcomes that differ only in them are merged
+    bool verdict_only = false;
+};
+
+// results of static analyses used during exploration, shared by all explored states
+struct ProgramAnalysis {
+    std::optional<SpinLoopInfo> spin_loops;
+    LivenessInfo liveness;
+    std::optional<SharedAccessInfo> shared_access;
+};
+
+std::shared_ptr<const ProgramAnalysis> AnalyzeProgram(
+        const ProgramDescriptor& descriptor,
+        const std::vector<size_t>& instruction_pointers,
+        const ExplorationOptions& options
+);
+
+#endif //PROGRAM_ANALYSIS_H
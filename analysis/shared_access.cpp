@@ -0,0 +1,138 @@
+#include "shared_access.h"
+#include "cfg.h"
+
+#include <set>
+
+namespace {
+
+// possible values of a register, std::nullopt stands for any value
+using ValueSet = std::optional<std::set<uint64_t>>;
+using RegistersValues = std::vector<ValueSet>;
+
+// sets bigger than this are not worth tracking
+constexpr size_t kMaxValueSetSize = 64;
+
+bool Join(RegistersValues& dst, const RegistersValues& src) {
+    bool changed = false;
+    for (size_t reg = 0; reg < dst.size(); ++reg) {
+        if (!dst[reg]) {
+            continue;
+        }
+        if (!src[reg]) {
+            dst[reg] = std::nullopt;
+            changed = true;
+            continue;
+        }
+        size_t old_size = dst[reg]->size();
+        dst[reg]->insert(src[reg]->begin(), src[reg]->end());
+        if (dst[reg]->size() > kMaxValueSetSize) {
+            dst[reg] = std::nullopt;
+        }
+        changed |= !dst[reg] || dst[reg]->size() != old_size;
+    }
+    return changed;
+}
+
+std::optional<Register> GetAddressRegister(const Instruction& instruction) {
+    if (auto load = std::get_if<LoadInstruction>(&instruction)) {
+        return load->addr;
+    }
+    if (auto store = std::get_if<StoreInstruction>(&instruction)) {
+        return store->addr;
+    }
+    if (auto cas = std::get_if<CasInstruction>(&instruction)) {
+        return cas->addr;
+    }
+    if (auto fai = std::get_if<FaiInstruction>(&instruction)) {
+        return fai->addr;
+    }
+    if (auto fetch_op = std::get_if<FetchOpInstruction>(&instruction)) {
+        return fetch_op->addr;
+    }
+    return std::nullopt;
+}
+
+// branches whose condition is known to be zero or known to be non-zero have a single successor
+std::vector<size_t> GetReachableSuccessors(const std::vector<Instruction>& instructions, size_t ip, const RegistersValues& values) {
+    auto if_instruction = std::get_if<IfInstruction>(&instructions[ip]);
+    if (!if_instruction || !values[if_instruction->cond]) {
+        return GetSuccessors(instructions, ip);
+    }
+    auto& cond_values = *values[if_instruction->cond];
+    if (!cond_values.count(0)) {
+        return {if_instruction->instr_on_success};
+    }
+    if (cond_values.size() == 1) {
+        return {ip + 1};
+    }
+    return GetSuccessors(instructions, ip);
+}
+
+// cells the thread may access, std::nullopt if any cell
+std::optional<std::set<MemoryCell>> GetAccessedCells(const ProgramDescriptor& descriptor, size_t entry) {
+    auto& instructions = descriptor.instructions;
+    std::vector<std::optional<RegistersValues>> values_before(instructions.size() + 1);
+    values_before[entry] = RegistersValues(descriptor.register_name.size(), std::set<uint64_t>{0});
+    std::vector<size_t> worklist = {entry};
+    while (!worklist.empty()) {
+        size_t ip = worklist.back();
+        worklist.pop_back();
+        if (ip == instructions.size()) {
+            continue;
+        }
+        RegistersValues values = *values_before[ip];
+        if (auto assignment = std::get_if<RegisterConstantAssignment>(&instructions[ip])) {
+            values[assignment->dst] = std::set<uint64_t>{assignment->value};
+        } else if (auto defined = GetDefinedRegister(instructions[ip])) {
+            values[*defined] = std::nullopt;
+        }
+        for (size_t successor : GetReachableSuccessors(instructions, ip, values)) {
+            if (!values_before[successor]) {
+                values_before[successor] = values;
+                worklist.push_back(successor);
+            } else if (Join(*values_before[successor], values)) {
+                worklist.push_back(successor);
+            }
+        }
+    }
+    std::set<MemoryCell> cells;
+    for (size_t ip = 0; ip < instructions.size(); ++ip) {
+        auto address = GetAddressRegister(instructions[ip]);
+        if (!values_before[ip] || !address) {
+            continue;
+        }
+        auto& address_values = (*values_before[ip])[*address];
+        if (!address_values) {
+            return std::nullopt;
+        }
+        cells.insert(address_values->begin(), address_values->end());
+    }
+    return cells;
+}
+
+}  // namespace
+
+bool SharedAccessInfo::IsPrivate(MemoryCell cell) const {
+    return owner[cell].has_value();
+}
+
+SharedAccessInfo AnalyzeSharedAccess(const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers) {
+    std::vector<size_t> accessors_cnt(descriptor.memory_size, 0);
+    std::vector<size_t> last_accessor(descriptor.memory_size, 0);
+    for (size_t tid = 0; tid < instruction_pointers.size(); ++tid) {
+        auto cells = GetAccessedCells(descriptor, instruction_pointers[tid]);
+        for (MemoryCell cell = 0; cell < descriptor.memory_size; ++cell) {
+            if (!cells || cells->count(cell)) {
+                ++accessors_cnt[cell];
+                last_accessor[cell] = tid;
+            }
+        }
+    }
+    SharedAccessInfo info{std::vector<std::optional<size_t>>(descriptor.memory_size)};
+    for (MemoryCell cell = 0; cell < descriptor.memory_size; ++cell) {
+        if (accessors_cnt[cell] == 1) {
+            info.owner[cell] = last_accessor[cell];
+        }
+    }
+    return info;
+}
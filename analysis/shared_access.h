@@ -0,0 +1,26 @@
+#ifndef SHARED_ACCESS_H
+#define SHARED_ACCESS_H
+#include "../common/program_descriptor.h"
+
+#include <optional>
+#include <vector>
+
+/**
+ * Cells accessed (loaded, stored or modified) by a single thread only. Propagation of such a cell's
+ * write commutes with every step of other threads, so it may be done right away instead of
+ * being one more nondeterministic choice.
+ */
+struct SharedAccessInfo {
+    // the only thread accessing the cell, std::nullopt if the cell is shared or not accessed at all
+    std::vector<std::optional<size_t>> owner;
+
+    [[nodiscard]] bool IsPrivate(MemoryCell cell) const;
+};
+
+/**
+ * Addresses are resolved by propagating sets of constants assigned to registers along the thread's
+ * control flow, an address computed in any other way makes the access conflict with every cell
+ */
+SharedAccessInfo AnalyzeSharedAccess(const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers);
+
+#endif //SHARED_ACCESS_H
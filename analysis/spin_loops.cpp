@@ -0,0 +1,61 @@
+#include "spin_loops.h"
+#include "cfg.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace {
+
+bool IsSpinLoop(const std::vector<Instruction>& instructions, size_t head, size_t back_edge) {
+    std::unordered_set<Register> defined_in_body;
+    for (size_t ip = head; ip <= back_edge; ++ip) {
+        if (auto defined = GetDefinedRegister(instructions[ip])) {
+            defined_in_body.insert(*defined);
+        }
+    }
+    std::unordered_set<Register> defined_in_iteration;
+    for (size_t ip = head; ip <= back_edge; ++ip) {
+        const Instruction& instruction = instructions[ip];
+        if (!IsThreadLocal(instruction) && !std::holds_alternative<LoadInstruction>(instruction)) {
+            return false;
+        }
+        if (auto if_instruction = std::get_if<IfInstruction>(&instruction); if_instruction && ip != back_edge) {
+            // only exits from the loop are allowed inside of the body
+            if (if_instruction->instr_on_success >= head && if_instruction->instr_on_success <= back_edge) {
+                return false;
+            }
+        }
+        for (Register reg : GetUsedRegisters(instruction)) {
+            // value carried over from the previous iteration
+            if (defined_in_body.count(reg) && !defined_in_iteration.count(reg)) {
+                return false;
+            }
+        }
+        if (auto defined = GetDefinedRegister(instruction)) {
+            defined_in_iteration.insert(*defined);
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+SpinLoopInfo FindSpinLoops(const ProgramDescriptor& descriptor) {
+    auto& instructions = descriptor.instructions;
+    SpinLoopInfo info{std::vector<std::optional<SpinLoop>>(instructions.size())};
+    for (size_t ip = 0; ip < instructions.size(); ++ip) {
+        auto if_instruction = std::get_if<IfInstruction>(&instructions[ip]);
+        if (!if_instruction || if_instruction->instr_on_success > ip) {
+            continue;
+        }
+        size_t head = if_instruction->instr_on_success;
+        if (info.loop_by_head[head] || !IsSpinLoop(instructions, head, ip)) {
+            continue;
+        }
+        size_t loads = std::count_if(instructions.begin() + head, instructions.begin() + ip + 1, [] (const Instruction& instruction) {
+            return std::holds_alternative<LoadInstruction>(instruction);
+        });
+        info.loop_by_head[head] = SpinLoop{head, ip, loads == 1};
+    }
+    return info;
+}
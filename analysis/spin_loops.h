@@ -0,0 +1,30 @@
+#ifndef SPIN_LOOPS_H
+#define SPIN_LOOPS_H
+#include "../common/program_descriptor.h"
+
+#include <optional>
+#include <vector>
+
+/**
+ * Busy-wait loop: instructions [head, back_edge] only load from shared memory and compute registers,
+ * the conditional jump at back_edge returns to head. Registers read in the body are either
+ * loop invariant or defined earlier in the same iteration, so an iteration that jumps back
+ * leaves the thread in the same state until some other transition changes a value it reads.
+ */
+struct SpinLoop {
+    size_t head;
+    size_t back_edge;
+    // the body has a single load, so whether an iteration exits depends on one read value only. A thread may
+    // wait for that value to change only then: loops reading several values may exit on a snapshot taken
+    // between writes of other threads, which a dry run at a single point in time never sees
+    bool single_load;
+};
+
+struct SpinLoopInfo {
+    // spin loop starting at the instruction, if any
+    std::vector<std::optional<SpinLoop>> loop_by_head;
+};
+
+SpinLoopInfo FindSpinLoops(const ProgramDescriptor& descriptor);
+
+#endif //SPIN_LOOPS_H
@@ -0,0 +1,335 @@
+#include "exploration.h"
+#include "../axiomatic/graph_explorer.h"
+#include "../common/binary_program.h"
+#include "../executors/controllable_executor.h"
+#include "../memory_subsystem/memory_subsystem_factory.h"
+#include "../parser/litmus.h"
+
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Bounds of a single run. The memory kept by an exploration is dominated by the keys of visited states:
+ * a few words per event of a graph or per word of an operational state and the node of the set.
+ */
+struct Budget {
+    Budget(const ExplorationConfig& config, const std::atomic<bool>& cancelled)
+        : config_(config)
+        , cancelled_(cancelled)
+        , start_(Clock::now()) {
+    }
+
+    // status the run stopped with, if it was interrupted
+    std::optional<ExplorationStatus> status;
+    size_t states = 0;
+
+    // accounts for a new visited state, false once the run has to stop
+    bool Visit(size_t bytes) {
+        ++states;
+        memory_used_ += kBytesPerState + bytes;
+        if (cancelled_.load(std::memory_order_relaxed)) {
+            status = ExplorationStatus::CANCELLED;
+        } else if (config_.max_states && states > *config_.max_states) {
+            status = ExplorationStatus::STATE_LIMIT;
+        } else if (config_.memory_limit_bytes && memory_used_ > *config_.memory_limit_bytes) {
+            status = ExplorationStatus::MEMORY_LIMIT;
+        } else if (config_.time_limit && states % kStatesPerClockCheck == 0 && GetElapsedTime() > *config_.time_limit) {
+            status = ExplorationStatus::TIMEOUT;
+        }
+        return !status;
+    }
+
+    std::chrono::milliseconds GetElapsedTime() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start_);
+    }
+
+private:
+    static constexpr size_t kBytesPerState = 64;
+    static constexpr size_t kStatesPerClockCheck = 64;
+
+    const ExplorationConfig& config_;
+    const std::atomic<bool>& cancelled_;
+    Clock::time_point start_;
+    size_t memory_used_ = 0;
+};
+
+// passes every distinct outcome of terminated executions to the callbacks
+struct OutcomeSink {
+    OutcomeSink(const ProgramDescriptor& descriptor, const ExplorationConfig& config, const ExplorationCallbacks& callbacks)
+        : descriptor_(descriptor)
+        , config_(config)
+        , callbacks_(callbacks) {
+    }
+
+    size_t executions = 0;
+    std::optional<ExplorationStatus> status;
+    bool found = false;
+
+    // false once the run has to stop
+    bool Complete(const Outcome& outcome) {
+        ++executions;
+        if (!outcomes_.insert(outcome).second) {
+            return true;
+        }
+        if (callbacks_.on_outcome && !callbacks_.on_outcome(outcome)) {
+            status = ExplorationStatus::STOPPED;
+        }
+        if (!found && descriptor_.final_condition && descriptor_.final_condition->IsTarget(outcome)) {
+            found = true;
+            if (callbacks_.on_target) {
+                callbacks_.on_target(outcome);
+            }
+            if (config_.stop_at_target && !status) {
+                status = ExplorationStatus::TARGET_FOUND;
+            }
+        }
+        return !status;
+    }
+
+    size_t GetOutcomesCount() const {
+        return outcomes_.size();
+    }
+
+private:
+    const ProgramDescriptor& descriptor_;
+    const ExplorationConfig& config_;
+    const ExplorationCallbacks& callbacks_;
+    std::set<Outcome> outcomes_;
+};
+
+struct CallbackGraphExplorer : GraphExplorer {
+    CallbackGraphExplorer(const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, MemoryModel model, Budget& budget, OutcomeSink& sink)
+        : GraphExplorer(descriptor, instruction_pointers, model, false)
+        , budget_(budget)
+        , sink_(sink) {
+    }
+
+protected:
+    bool VisitGraph(const ExecutionGraph& graph) override {
+        return budget_.Visit(kBytesPerEvent * graph.events.size());
+    }
+
+    void CompleteExecution(const ExecutionGraph& graph, const ThreadSubsystem& threads) override {
+        ++executions_;
+        if (!sink_.Complete(GetOutcome(graph, threads))) {
+            stopped_ = true;
+        }
+    }
+
+private:
+    static constexpr size_t kBytesPerEvent = 40;
+
+    Budget& budget_;
+    OutcomeSink& sink_;
+};
+
+// depth-first search over the states of the operational subsystems, the one of the `mc` mode without printing
+struct OperationalExplorer {
+    OperationalExplorer(Budget& budget, OutcomeSink& sink)
+        : budget_(budget)
+        , sink_(sink) {
+    }
+
+    void Explore(const ControllableExecutor& initial) {
+        StateKey key = initial.GetStateKey();
+        size_t bytes = key.size() * sizeof(uint64_t);
+        visited_.insert(std::move(key));
+        if (!budget_.Visit(bytes)) {
+            return;
+        }
+        Visit(initial);
+    }
+
+private:
+    // false once the search has to stop
+    bool Visit(const ControllableExecutor& state) {
+        if (state.IsTerminal()) {
+            return sink_.Complete(state.GetOutcome());
+        }
+        auto running_threads = state.GetThreadsNextPossibleSteps();
+        auto propagations = state.GetPropagateTransitions();
+        for (size_t selection = 0; selection < running_threads.size() + propagations.size(); ++selection) {
+            auto next = state.Clone();
+            next.SelectTransition(selection, running_threads, propagations);
+            StateKey key = next.GetStateKey();
+            size_t bytes = key.size() * sizeof(uint64_t);
+            if (!visited_.insert(std::move(key)).second) {
+                continue;
+            }
+            if (!budget_.Visit(bytes) || !Visit(next)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    Budget& budget_;
+    OutcomeSink& sink_;
+    std::unordered_set<StateKey, StateKeyHash> visited_;
+};
+
+bool IsOperationalModel(const std::string& model) {
+    return model == "sc" || model == "tso" || model == "pso" || model == "ra";
+}
+
+}  // namespace
+
+ProgramPtr OpenProgram(const std::string& path) {
+    if (IsLitmusPath(path)) {
+        LitmusProgram litmus = ParseLitmusFile(path);
+        return CreateProgram(std::move(litmus.descriptor), std::move(litmus.instruction_pointers));
+    }
+    return CreateProgram(LoadProgram(path));
+}
+
+ProgramPtr CreateProgram(ProgramDescriptor descriptor, std::vector<size_t> instruction_pointers) {
+    auto program = std::make_shared<LoadedProgram>();
+    program->descriptor = std::move(descriptor);
+    program->instruction_pointers = std::move(instruction_pointers);
+    return program;
+}
+
+std::shared_ptr<const Bytecode> LoadedProgram::GetBytecode() const {
+    {
+        std::lock_guard lock{mutex_};
+        if (bytecode_) {
+            return bytecode_;
+        }
+    }
+    // compiled without the lock, a program compiled twice concurrently keeps the first bytecode
+    auto bytecode = std::make_shared<const Bytecode>(CompileBytecode(descriptor));
+    std::lock_guard lock{mutex_};
+    if (!bytecode_) {
+        bytecode_ = std::move(bytecode);
+    }
+    return bytecode_;
+}
+
+std::shared_ptr<const ProgramAnalysis> LoadedProgram::GetAnalysis(const std::vector<size_t>& entry_points, const ExplorationOptions& options) const {
+    AnalysisKey key{entry_points, options.await_spin_loops, options.eager_private_propagation, options.verdict_only};
+    {
+        std::lock_guard lock{mutex_};
+        auto it = analyses_.find(key);
+        if (it != analyses_.end()) {
+            return it->second;
+        }
+    }
+    auto analysis = AnalyzeProgram(descriptor, entry_points, options);
+    std::lock_guard lock{mutex_};
+    if (analyses_.size() >= kMaxCachedAnalyses) {
+        analyses_.clear();
+    }
+    return analyses_.emplace(std::move(key), std::move(analysis)).first->second;
+}
+
+Exploration::Exploration(ProgramPtr program, ExplorationConfig config)
+    : program_(std::move(program))
+    , config_(std::move(config)) {
+    if (!program_) {
+        throw std::runtime_error{"Exploration of a null program"};
+    }
+    if (config_.instruction_pointers.empty()) {
+        config_.instruction_pointers = program_->instruction_pointers;
+    }
+    if (config_.instruction_pointers.empty()) {
+        throw std::runtime_error{"Expected positive number of instruction pointers"};
+    }
+    for (size_t ip : config_.instruction_pointers) {
+        if (ip >= program_->descriptor.instructions.size()) {
+            throw std::runtime_error{"Instruction pointer " + std::to_string(ip) + " is out of the program"};
+        }
+    }
+    auto& final_condition = program_->descriptor.final_condition;
+    if (final_condition && final_condition->GetMaxThreadId() >= config_.instruction_pointers.size()) {
+        throw std::runtime_error{"Final condition refers to a thread that is not started"};
+    }
+    if (config_.mode == ExplorationMode::GRAPH) {
+        ParseMemoryModel(config_.model);
+    } else if (!IsOperationalModel(config_.model)) {
+        throw std::runtime_error{"Unknown operational model, there is no implementation for it as of now"};
+    }
+}
+
+ExplorationResult Exploration::Run(const ExplorationCallbacks& callbacks) {
+    const ProgramDescriptor& descriptor = program_->descriptor;
+    Budget budget{config_, cancelled_};
+    OutcomeSink sink{descriptor, config_, callbacks};
+    if (config_.mode == ExplorationMode::GRAPH) {
+        CallbackGraphExplorer explorer{descriptor, config_.instruction_pointers, ParseMemoryModel(config_.model), budget, sink};
+        explorer.Explore();
+    } else {
+        auto memory_subsystem = CreateMemorySubsystem(descriptor, config_.instruction_pointers.size(), config_.model);
+        auto initial = CreateControllableExecutor(std::move(memory_subsystem), descriptor, config_.instruction_pointers,
+                                                  program_->GetAnalysis(config_.instruction_pointers, config_.options), program_->GetBytecode());
+        OperationalExplorer explorer{budget, sink};
+        explorer.Explore(initial);
+    }
+
+    ExplorationResult result;
+    // the budget is checked before a state is explored, the sink after, so only one of them may have stopped the run
+    result.status = budget.status.value_or(sink.status.value_or(ExplorationStatus::COMPLETED));
+    result.states = budget.states;
+    result.executions = sink.executions;
+    result.outcomes = sink.GetOutcomesCount();
+    if (descriptor.final_condition && (sink.found || result.status == ExplorationStatus::COMPLETED)) {
+        result.found = sink.found;
+    }
+    result.time = budget.GetElapsedTime();
+    return result;
+}
+
+void Exploration::Cancel() {
+    cancelled_.store(true, std::memory_order_relaxed);
+}
+
+const ExplorationConfig& Exploration::GetConfig() const {
+    return config_;
+}
+
+std::string FormatOutcome(const ProgramDescriptor& descriptor, const Outcome& outcome) {
+    std::ostringstream os;
+    const char* separator = "";
+    for (size_t tid = 0; tid < outcome.registers.size(); ++tid) {
+        for (Register reg = 0; reg < outcome.registers[tid].size(); ++reg) {
+            os << separator << tid << ':' << descriptor.register_name[reg] << '=' << outcome.registers[tid][reg];
+            separator = " ";
+        }
+    }
+    for (MemoryCell cell = 0; cell < outcome.memory.size(); ++cell) {
+        os << separator;
+        if (cell < descriptor.memory_name.size()) {
+            os << descriptor.memory_name[cell];
+        } else {
+            os << cell;
+        }
+        os << '=' << outcome.memory[cell];
+        separator = " ";
+    }
+    return os.str();
+}
+
+std::string GetExplorationStatusName(ExplorationStatus status) {
+    switch (status) {
+        case ExplorationStatus::COMPLETED:
+            return "completed";
+        case ExplorationStatus::TARGET_FOUND:
+            return "target-found";
+        case ExplorationStatus::STOPPED:
+            return "stopped";
+        case ExplorationStatus::CANCELLED:
+            return "cancelled";
+        case ExplorationStatus::STATE_LIMIT:
+            return "state-limit";
+        case ExplorationStatus::TIMEOUT:
+            return "timeout";
+        case ExplorationStatus::MEMORY_LIMIT:
+            return "memory-limit";
+    }
+    throw std::runtime_error{"Unknown exploration status"};
+}
@@ -0,0 +1,130 @@
+#ifndef EXPLORATION_H
+#define EXPLORATION_H
+#include "../analysis/program_analysis.h"
+#include "../common/program_descriptor.h"
+#include "../condition/outcome.h"
+#include "../instruction/bytecode.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/**
+ * Interface of the `wmm` library: a program is loaded once and shared by any number of explorations, which
+ * report outcomes through callbacks instead of printing them. A loaded program is never modified (its bytecode
+ * and analyses are computed on demand under a lock), so explorations of it may run concurrently in different
+ * threads; a single exploration is run by one thread at a time and keeps all of its state to itself.
+ */
+struct LoadedProgram {
+    ProgramDescriptor descriptor;
+    // entry points used when an exploration doesn't set its own (every thread of a litmus test)
+    std::vector<size_t> instruction_pointers;
+
+    // compiled by the first operational exploration and shared by the following ones
+    std::shared_ptr<const Bytecode> GetBytecode() const;
+    // computed once for every set of entry points and options
+    std::shared_ptr<const ProgramAnalysis> GetAnalysis(const std::vector<size_t>& instruction_pointers, const ExplorationOptions& options) const;
+
+private:
+    using AnalysisKey = std::tuple<std::vector<size_t>, bool, bool, bool>;
+
+    // bounds the memory kept by analyses, all of them are dropped once there are more
+    static constexpr size_t kMaxCachedAnalyses = 64;
+
+    mutable std::mutex mutex_;
+    mutable std::shared_ptr<const Bytecode> bytecode_;
+    mutable std::map<AnalysisKey, std::shared_ptr<const ProgramAnalysis>> analyses_;
+};
+
+using ProgramPtr = std::shared_ptr<const LoadedProgram>;
+
+// reads a program in the text or the compiled form, or a `.litmus` test
+ProgramPtr OpenProgram(const std::string& path);
+
+ProgramPtr CreateProgram(ProgramDescriptor descriptor, std::vector<size_t> instruction_pointers = {});
+
+enum class ExplorationMode {
+    // execution graphs consistent with an axiomatic model, as in the `graph` mode (sc, tso and pso)
+    GRAPH,
+    // states of the operational subsystems, as in the `mc` mode (sc, tso, pso and ra)
+    OPERATIONAL
+};
+
+struct ExplorationConfig {
+    ExplorationMode mode = ExplorationMode::GRAPH;
+    std::string model = "sc";
+    // entry points of the threads, the ones of the program if empty
+    std::vector<size_t> instruction_pointers;
+    // used by the operational mode only
+    ExplorationOptions options;
+    // whether to stop at the first witness (for "exists") or counterexample (for "forall") of the final condition
+    bool stop_at_target = true;
+    // bounds on the consistent graphs or the operational states visited, the time of a run and the memory it keeps
+    std::optional<size_t> max_states;
+    std::optional<std::chrono::milliseconds> time_limit;
+    std::optional<size_t> memory_limit_bytes;
+};
+
+struct ExplorationCallbacks {
+    // called once for every distinct outcome, the exploration stops if it returns false
+    std::function<bool(const Outcome&)> on_outcome;
+    // called with the witness or the counterexample of the final condition
+    std::function<void(const Outcome&)> on_target;
+};
+
+enum class ExplorationStatus {
+    // every reachable state was visited
+    COMPLETED,
+    TARGET_FOUND,
+    // stopped by the outcome callback
+    STOPPED,
+    CANCELLED,
+    STATE_LIMIT,
+    TIMEOUT,
+    MEMORY_LIMIT
+};
+
+struct ExplorationResult {
+    ExplorationStatus status = ExplorationStatus::COMPLETED;
+    // consistent graphs or operational states
+    size_t states = 0;
+    // terminated executions, outcomes are the distinct ones among them
+    size_t executions = 0;
+    size_t outcomes = 0;
+    // whether the final condition target was found, known once it is found or the exploration is completed
+    std::optional<bool> found;
+    std::chrono::milliseconds time{0};
+};
+
+struct Exploration {
+    // throws if the model, the mode or the entry points don't fit the program
+    Exploration(ProgramPtr program, ExplorationConfig config);
+
+    // explores in the calling thread, the callbacks are called from it as well
+    ExplorationResult Run(const ExplorationCallbacks& callbacks = {});
+
+    // may be called from any thread: the current run and the later ones return CANCELLED soon after
+    void Cancel();
+
+    const ExplorationConfig& GetConfig() const;
+
+private:
+    ProgramPtr program_;
+    ExplorationConfig config_;
+    std::atomic<bool> cancelled_{false};
+};
+
+// "0:r=1 1:r=0 x=1", registers of every thread and then the memory
+std::string FormatOutcome(const ProgramDescriptor& descriptor, const Outcome& outcome);
+
+std::string GetExplorationStatusName(ExplorationStatus status);
+
+#endif //EXPLORATION_H
@@ -0,0 +1,169 @@
+#include "consistency.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+bool IsBarrier(const Event& event) {
+    return event.type == EventType::RMW || (event.type == EventType::WRITE && event.mode == AccessMode::SEQ_CST);
+}
+
+bool IsBarrierFence(const Event& event) {
+    return event.type == EventType::FENCE && event.mode != AccessMode::RLX;
+}
+
+bool IsPreservedProgramOrder(const Event& first, const Event& second, size_t fences_between, MemoryModel model) {
+    if (first.IsRead() || IsBarrier(first) || IsBarrier(second) || fences_between > 0) {
+        return true;
+    }
+    if (second.IsRead()) {
+        return false;
+    }
+    return model == MemoryModel::TSO || first.cell == second.cell;
+}
+
+}  // namespace
+
+MemoryModel ParseMemoryModel(const std::string& name) {
+    if (name == "sc") {
+        return MemoryModel::SC;
+    } else if (name == "tso") {
+        return MemoryModel::TSO;
+    } else if (name == "pso") {
+        return MemoryModel::PSO;
+    }
+    throw std::runtime_error{"Unknown memory model, execution graphs support sc, tso and pso"};
+}
+
+std::string GetMemoryModelName(MemoryModel model) {
+    switch (model) {
+        case MemoryModel::SC:
+            return "sc";
+        case MemoryModel::TSO:
+            return "tso";
+        case MemoryModel::PSO:
+            return "pso";
+    }
+    return {};
+}
+
+GraphRelations::GraphRelations(const ExecutionGraph& graph)
+    : po(graph.events.size())
+    , rf(graph.events.size())
+    , co(graph.events.size()) {
+    for (auto& thread : graph.thread_events) {
+        for (size_t j = 0; j < thread.size(); ++j) {
+            for (size_t i = 0; i < j; ++i) {
+                po.Add(thread[i], thread[j]);
+            }
+        }
+    }
+    for (size_t event = 0; event < graph.events.size(); ++event) {
+        if (graph.rf[event]) {
+            rf.Add(*graph.rf[event], event);
+        }
+    }
+    for (auto& order : graph.co) {
+        for (size_t j = 0; j < order.size(); ++j) {
+            for (size_t i = 0; i < j; ++i) {
+                co.Add(order[i], order[j]);
+            }
+        }
+    }
+    // an rmw reads from its immediate coherence predecessor, it is not in fr with itself
+    fr = rf.Inverse().Compose(co);
+    fr.RemoveIdentity();
+}
+
+bool IsConsistent(const ExecutionGraph& graph, MemoryModel model) {
+    for (size_t event = 0; event < graph.events.size(); ++event) {
+        if (graph.events[event].type != EventType::RMW) {
+            continue;
+        }
+        auto& order = graph.co[graph.events[event].cell];
+        auto position = std::find(order.begin(), order.end(), event);
+        if (*(position - 1) != *graph.rf[event]) {
+            return false;
+        }
+    }
+
+    GraphRelations relations(graph);
+    Relation communication = relations.rf | relations.co | relations.fr;
+    if (model == MemoryModel::SC) {
+        return (relations.po | communication).IsAcyclic();
+    }
+
+    // coherence: program order restricted to accesses of the same cell
+    size_t events_cnt = graph.events.size();
+    Relation po_loc(events_cnt);
+    for (auto& thread : graph.thread_events) {
+        for (size_t j = 0; j < thread.size(); ++j) {
+            const Event& second = graph.events[thread[j]];
+            for (size_t i = 0; i < j; ++i) {
+                const Event& first = graph.events[thread[i]];
+                if (first.type != EventType::FENCE && second.type != EventType::FENCE && first.cell == second.cell) {
+                    po_loc.Add(thread[i], thread[j]);
+                }
+            }
+        }
+    }
+    Relation ppo = GetPreservedProgramOrder(graph, model);
+    // external reads-from
+    Relation rfe(events_cnt);
+    for (size_t event = 0; event < events_cnt; ++event) {
+        if (graph.rf[event] && graph.events[*graph.rf[event]].thread_id != graph.events[event].thread_id) {
+            rfe.Add(*graph.rf[event], event);
+        }
+    }
+    if (!(po_loc | communication).IsAcyclic()) {
+        return false;
+    }
+    return (ppo | rfe | relations.co | relations.fr).IsAcyclic();
+}
+
+Relation GetPreservedProgramOrder(const ExecutionGraph& graph, MemoryModel model) {
+    Relation ppo(graph.events.size());
+    for (auto& thread : graph.thread_events) {
+        // fences_before[i]: number of barrier fences among the first i events of the thread
+        std::vector<size_t> fences_before(thread.size() + 1, 0);
+        for (size_t i = 0; i < thread.size(); ++i) {
+            fences_before[i + 1] = fences_before[i] + IsBarrierFence(graph.events[thread[i]]);
+        }
+        for (size_t j = 0; j < thread.size(); ++j) {
+            const Event& second = graph.events[thread[j]];
+            if (second.type == EventType::FENCE) {
+                continue;
+            }
+            for (size_t i = 0; i < j; ++i) {
+                const Event& first = graph.events[thread[i]];
+                if (first.type == EventType::FENCE) {
+                    continue;
+                }
+                if (model == MemoryModel::SC || IsPreservedProgramOrder(first, second, fences_before[j] - fences_before[i + 1], model)) {
+                    ppo.Add(thread[i], thread[j]);
+                }
+            }
+        }
+    }
+    return ppo;
+}
+
+std::optional<std::vector<size_t>> FindScCycle(const ExecutionGraph& graph) {
+    GraphRelations relations(graph);
+    return (relations.po | relations.rf | relations.co | relations.fr).FindCycle();
+}
+
+std::string GetEdgeName(const GraphRelations& relations, size_t from, size_t to) {
+    if (relations.po.Contains(from, to)) {
+        return "po";
+    } else if (relations.rf.Contains(from, to)) {
+        return "rf";
+    } else if (relations.co.Contains(from, to)) {
+        return "co";
+    } else if (relations.fr.Contains(from, to)) {
+        return "fr";
+    }
+    return "?";
+}
@@ -0,0 +1,49 @@
+#ifndef CONSISTENCY_H
+#define CONSISTENCY_H
+#include "execution_graph.h"
+#include "relation.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+enum class MemoryModel {
+    SC, TSO, PSO
+};
+
+MemoryModel ParseMemoryModel(const std::string& name);
+std::string GetMemoryModelName(MemoryModel model);
+
+// basic relations of an execution graph, po and co are transitive
+struct GraphRelations {
+    explicit GraphRelations(const ExecutionGraph& graph);
+
+    Relation po;
+    Relation rf;
+    Relation co;
+    // from-read: rf^-1 ; co
+    Relation fr;
+};
+
+/**
+ * Axiomatic counterparts of the operational subsystems. Every model requires atomicity of rmw events
+ * (an rmw is the immediate coherence successor of the write it reads from) and coherence:
+ * acyclic(po-loc | rf | co | fr). On top of that
+ *  - SC: acyclic(po | rf | co | fr);
+ *  - TSO: acyclic(ppo | rfe | co | fr), where ppo is po without pairs of a write followed by a read
+ *    unless a barrier (non-relaxed fence, rmw or SEQ_CST write) is in between;
+ *  - PSO: same as TSO, ppo also drops pairs of writes to different cells.
+ * fr relates a read to writes coherence-later than the one it reads from.
+ */
+bool IsConsistent(const ExecutionGraph& graph, MemoryModel model);
+
+// program order between memory accesses that the model keeps, all of it under SC
+Relation GetPreservedProgramOrder(const ExecutionGraph& graph, MemoryModel model);
+
+// cycle in po | rf | co | fr (the graph is not sequentially consistent), events in order
+std::optional<std::vector<size_t>> FindScCycle(const ExecutionGraph& graph);
+
+// name of a relation among po, rf, co and fr containing the edge
+std::string GetEdgeName(const GraphRelations& relations, size_t from, size_t to);
+
+#endif //CONSISTENCY_H
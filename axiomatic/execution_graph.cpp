@@ -0,0 +1,128 @@
+#include "execution_graph.h"
+#include "../utility/print_util.h"
+
+#include <algorithm>
+
+bool Event::IsRead() const {
+    return type == EventType::READ || type == EventType::RMW;
+}
+
+bool Event::IsWrite() const {
+    return type == EventType::INIT || type == EventType::WRITE || type == EventType::RMW;
+}
+
+ExecutionGraph::ExecutionGraph(size_t memory_size, size_t threads_cnt)
+    : thread_events(threads_cnt)
+    , co(memory_size) {
+    for (MemoryCell cell = 0; cell < memory_size; ++cell) {
+        events.push_back(Event{EventType::INIT, threads_cnt, cell, 0, AccessMode::RLX, cell, 0, 0});
+        rf.emplace_back();
+        co[cell].push_back(cell);
+    }
+}
+
+size_t ExecutionGraph::AddEvent(const Event& event) {
+    size_t id = events.size();
+    events.push_back(event);
+    events.back().po_index = thread_events[event.thread_id].size();
+    thread_events[event.thread_id].push_back(id);
+    rf.emplace_back();
+    return id;
+}
+
+void ExecutionGraph::SetReadsFrom(size_t read, size_t write) {
+    rf[read] = write;
+}
+
+void ExecutionGraph::InsertCoherence(size_t write, size_t position) {
+    auto& order = co[events[write].cell];
+    order.insert(order.begin() + position, write);
+}
+
+size_t ExecutionGraph::GetThreadsCount() const {
+    return thread_events.size();
+}
+
+size_t ExecutionGraph::GetMemorySize() const {
+    return co.size();
+}
+
+uint64_t ExecutionGraph::GetFinalValue(MemoryCell cell) const {
+    return events[co[cell].back()].written_value;
+}
+
+std::vector<uint64_t> ExecutionGraph::GetKey() const {
+    auto encode = [this] (size_t event) -> uint64_t {
+        return (static_cast<uint64_t>(events[event].thread_id) << 32) | events[event].po_index;
+    };
+    std::vector<uint64_t> key;
+    for (auto& thread : thread_events) {
+        key.push_back(thread.size());
+        for (size_t event : thread) {
+            const Event& cur = events[event];
+            key.push_back(static_cast<uint64_t>(cur.type));
+            key.push_back(cur.cell);
+            key.push_back(cur.written_value);
+            if (rf[event]) {
+                key.push_back(encode(*rf[event]));
+            }
+        }
+    }
+    for (auto& order : co) {
+        for (size_t write : order) {
+            key.push_back(encode(write));
+        }
+    }
+    return key;
+}
+
+void ExecutionGraph::PrintEventId(std::ostream& os, size_t event) const {
+    if (events[event].type == EventType::INIT) {
+        os << "init";
+    } else {
+        os << events[event].thread_id << ':' << events[event].po_index;
+    }
+}
+
+void ExecutionGraph::PrintEvent(std::ostream& os, size_t event, const std::vector<std::string>& memory_name, const InstructionText& instructions_str) const {
+    const Event& cur = events[event];
+    PrintEventId(os, event);
+    if (cur.type == EventType::FENCE) {
+        os << " F";
+    } else {
+        os << ' ' << (cur.type == EventType::READ ? "R" : cur.type == EventType::RMW ? "U" : "W") << ' ';
+        if (cur.cell < memory_name.size()) {
+            os << memory_name[cur.cell];
+        } else {
+            os << '#' << cur.cell;
+        }
+        if (cur.IsRead()) {
+            os << ' ' << cur.read_value;
+        }
+        if (cur.IsWrite()) {
+            os << (cur.IsRead() ? " -> " : " ") << cur.written_value;
+        }
+    }
+    if (cur.type != EventType::INIT && cur.ip < instructions_str.size()) {
+        os << " (" << instructions_str[cur.ip] << ')';
+    }
+}
+
+void ExecutionGraph::Print(std::ostream& os, const std::vector<std::string>& memory_name, const InstructionText& instructions_str, size_t indent) const {
+    for (size_t tid = 0; tid < thread_events.size(); ++tid) {
+        os << Indent{indent} << "Thread #" << tid << '\n';
+        for (size_t event : thread_events[tid]) {
+            os << Indent{indent + 1};
+            PrintEvent(os, event, memory_name, instructions_str);
+            if (rf[event]) {
+                os << ", reads from ";
+                PrintEventId(os, *rf[event]);
+            }
+            if (events[event].IsWrite()) {
+                auto& order = co[events[event].cell];
+                os << ", coherence index " << std::find(order.begin(), order.end(), event) - order.begin();
+            }
+            os << '\n';
+        }
+    }
+}
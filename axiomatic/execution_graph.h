@@ -0,0 +1,73 @@
+#ifndef EXECUTION_GRAPH_H
+#define EXECUTION_GRAPH_H
+#include "../common/memory_primitives.h"
+#include "../instruction/access_mode.h"
+#include "../common/instruction_text.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+enum class EventType {
+    INIT, READ, WRITE, RMW, FENCE
+};
+
+// memory access of a thread, derived from the transition label of the instruction that performed it
+struct Event {
+    EventType type;
+    // threads count for initial writes
+    size_t thread_id;
+    // position in the program order of the thread (cell for initial writes)
+    size_t po_index;
+    // instruction that generated the event
+    size_t ip;
+    AccessMode mode;
+    MemoryCell cell;
+    uint64_t read_value;
+    uint64_t written_value;
+
+    bool IsRead() const;
+    bool IsWrite() const;
+};
+
+/**
+ * Execution graph: events of every thread in program order (po), reads-from (rf) edges
+ * and coherence order (co) of writes to every cell. Every cell starts with an initial write of zero,
+ * which is the first one in its coherence order.
+ */
+struct ExecutionGraph {
+    ExecutionGraph(size_t memory_size, size_t threads_cnt);
+
+    // appends the event to the end of its thread, returns its index in `events`
+    size_t AddEvent(const Event& event);
+    // write the event reads from
+    void SetReadsFrom(size_t read, size_t write);
+    // puts the write at the position in the coherence order of its cell
+    void InsertCoherence(size_t write, size_t position);
+
+    size_t GetThreadsCount() const;
+    size_t GetMemorySize() const;
+    // value of the coherence-latest write to the cell
+    uint64_t GetFinalValue(MemoryCell cell) const;
+
+    // canonical encoding, independent of the order events were added in
+    std::vector<uint64_t> GetKey() const;
+
+    void Print(std::ostream& os, const std::vector<std::string>& memory_name, const InstructionText& instructions_str, size_t indent = 0) const;
+    // "tid:po_index" or "init"
+    void PrintEventId(std::ostream& os, size_t event) const;
+    void PrintEvent(std::ostream& os, size_t event, const std::vector<std::string>& memory_name, const InstructionText& instructions_str) const;
+
+    std::vector<Event> events;
+    // indices of events of every thread in program order
+    std::vector<std::vector<size_t>> thread_events;
+    // write every read (or rmw) event reads from
+    std::vector<std::optional<size_t>> rf;
+    // writes of every cell in coherence order
+    std::vector<std::vector<size_t>> co;
+};
+
+#endif //EXECUTION_GRAPH_H
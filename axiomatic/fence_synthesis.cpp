@@ -0,0 +1,210 @@
+#include "fence_synthesis.h"
+#include "robustness.h"
+#include "../utility/print_util.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+std::string TrimInstruction(const std::string& instruction) {
+    size_t end = instruction.find_last_not_of(' ');
+    return end == std::string::npos ? std::string{} : instruction.substr(0, end + 1);
+}
+
+bool HitsAll(const std::vector<size_t>& chosen, const std::vector<std::set<size_t>>& sets) {
+    for (auto& set : sets) {
+        bool hit = false;
+        for (size_t element : chosen) {
+            if (set.count(element) > 0) {
+                hit = true;
+                break;
+            }
+        }
+        if (!hit) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// tries all subsets of `universe` of size `size` in lexicographic order, starting from the element `start`
+bool FindHittingSet(const std::vector<size_t>& universe, size_t start, size_t size, std::vector<size_t>& chosen,
+                    const std::vector<std::set<size_t>>& sets) {
+    if (chosen.size() == size) {
+        return HitsAll(chosen, sets);
+    }
+    for (size_t i = start; i + (size - chosen.size()) <= universe.size(); ++i) {
+        chosen.push_back(universe[i]);
+        if (FindHittingSet(universe, i + 1, size, chosen, sets)) {
+            return true;
+        }
+        chosen.pop_back();
+    }
+    return false;
+}
+
+// smallest set of elements intersecting every given set, sets are few and small (one per found violation)
+std::set<size_t> FindMinimumHittingSet(const std::vector<std::set<size_t>>& sets) {
+    std::set<size_t> elements;
+    for (auto& set : sets) {
+        elements.insert(set.begin(), set.end());
+    }
+    std::vector<size_t> universe(elements.begin(), elements.end());
+    std::vector<size_t> chosen;
+    for (size_t size = 0; size <= universe.size(); ++size) {
+        if (FindHittingSet(universe, 0, size, chosen, sets)) {
+            break;
+        }
+    }
+    return {chosen.begin(), chosen.end()};
+}
+
+}  // namespace
+
+PatchedProgram InsertFences(const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, const std::set<size_t>& fences_after) {
+    size_t instructions_cnt = descriptor.instructions.size();
+    // new_ip[ip]: position of the original instruction in the patched program, the end is mapped as well
+    std::vector<size_t> new_ip(instructions_cnt + 1);
+    size_t fences_before = 0;
+    for (size_t ip = 0; ip <= instructions_cnt; ++ip) {
+        new_ip[ip] = ip + fences_before;
+        fences_before += fences_after.count(ip);
+    }
+
+    PatchedProgram patched{descriptor, {}, {}};
+    auto& patched_descriptor = patched.descriptor;
+    patched_descriptor.instructions.clear();
+    patched_descriptor.instructions_str.ClearInstructions();
+    for (size_t ip = 0; ip < instructions_cnt; ++ip) {
+        Instruction instruction = descriptor.instructions[ip];
+        if (auto* if_instruction = std::get_if<IfInstruction>(&instruction)) {
+            if_instruction->instr_on_success = new_ip[if_instruction->instr_on_success];
+        }
+        patched_descriptor.instructions.push_back(instruction);
+        patched_descriptor.instructions_str.AppendInstruction(descriptor.instructions_str, ip);
+        patched.original_ip.push_back(ip);
+        if (fences_after.count(ip) > 0) {
+            patched_descriptor.instructions.emplace_back(FenceInstruction{AccessMode::SEQ_CST});
+            patched_descriptor.instructions_str.AddToken({SourceToken::Kind::KEYWORD, static_cast<uint64_t>(KeywordToken::FENCE)});
+            patched_descriptor.instructions_str.AddToken({SourceToken::Kind::KEYWORD, static_cast<uint64_t>(KeywordToken::SEQ_CST)});
+            patched_descriptor.instructions_str.EndInstruction();
+            patched.original_ip.push_back(ip);
+        }
+    }
+    for (size_t ip : instruction_pointers) {
+        if (ip > instructions_cnt) {
+            throw std::runtime_error{"Instruction pointer " + std::to_string(ip) + " is out of the program"};
+        }
+        patched.instruction_pointers.push_back(new_ip[ip]);
+    }
+    return patched;
+}
+
+void PrintProgram(std::ostream& os, const ProgramDescriptor& descriptor) {
+    if (!descriptor.memory_name.empty()) {
+        os << "shared_state:";
+        for (auto& name : descriptor.memory_name) {
+            os << ' ' << name;
+        }
+        os << ";\n";
+    }
+    if (descriptor.memory_size > descriptor.memory_name.size()) {
+        os << "reserve_space: " << descriptor.memory_size - descriptor.memory_name.size() << ";\n";
+    }
+    for (size_t ip = 0; ip < descriptor.instructions_str.size(); ++ip) {
+        os << TrimInstruction(descriptor.instructions_str[ip]) << ";\n";
+    }
+    if (descriptor.final_condition) {
+        descriptor.final_condition->Print(os, descriptor.memory_name, descriptor.register_name);
+        os << ";\n";
+    }
+}
+
+FenceSynthesizer::FenceSynthesizer(const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, MemoryModel model, bool tracing_on)
+    : descriptor_(descriptor)
+    , instruction_pointers_(instruction_pointers)
+    , model_(model)
+    , tracing_on_(tracing_on) {
+    if (model == MemoryModel::SC) {
+        throw std::runtime_error{"Fence synthesis needs a weak memory model, tso or pso"};
+    }
+}
+
+void FenceSynthesizer::Synthesize() {
+    while (true) {
+        PatchedProgram patched = InsertFences(descriptor_, instruction_pointers_, fences_after_);
+        RobustnessChecker checker(patched.descriptor, patched.instruction_pointers, model_, false);
+        checker.Explore();
+        ++explorations_;
+        auto& violation = checker.GetViolation();
+        if (!violation) {
+            return;
+        }
+
+        // fence events only have po edges, dropping them from the cycle leaves po edges between their neighbours
+        const ExecutionGraph& graph = violation->graph;
+        std::vector<size_t> cycle;
+        for (size_t event : violation->cycle) {
+            if (graph.events[event].type != EventType::FENCE) {
+                cycle.push_back(event);
+            }
+        }
+        // writes between the ends of every pair of accesses in the cycle the model may reorder
+        Relation ppo = GetPreservedProgramOrder(graph, model_);
+        std::set<size_t> candidates;
+        for (size_t i = 0; i < cycle.size(); ++i) {
+            size_t first = cycle[i];
+            size_t second = cycle[(i + 1) % cycle.size()];
+            const Event& from = graph.events[first];
+            const Event& to = graph.events[second];
+            if (from.type == EventType::INIT || from.thread_id != to.thread_id || ppo.Contains(first, second)) {
+                continue;
+            }
+            auto& thread = graph.thread_events[from.thread_id];
+            for (size_t j = from.po_index; j < to.po_index; ++j) {
+                const Event& event = graph.events[thread[j]];
+                if (event.type == EventType::WRITE) {
+                    candidates.insert(patched.original_ip[event.ip]);
+                }
+            }
+        }
+        if (candidates.empty()) {
+            throw std::runtime_error{"Violation of robustness can't be fixed with fences"};
+        }
+        if (tracing_on_) {
+            std::cout << "Violation #" << violations_.size() + 1 << ", a fence is needed after one of:\n";
+            for (size_t ip : candidates) {
+                std::cout << Indent{1} << ip << ": " << TrimInstruction(descriptor_.instructions_str[ip]) << '\n';
+            }
+        }
+        violations_.push_back(std::move(candidates));
+        fences_after_ = FindMinimumHittingSet(violations_);
+    }
+}
+
+const std::set<size_t>& FenceSynthesizer::GetFences() const {
+    return fences_after_;
+}
+
+void FenceSynthesizer::PrintResult() const {
+    if (fences_after_.empty()) {
+        std::cout << "Program is robust against " << GetMemoryModelName(model_) << ", no fences are needed\n";
+    } else {
+        std::cout << "Fences restoring sequential consistency under " << GetMemoryModelName(model_) << " are inserted after:\n";
+        for (size_t ip : fences_after_) {
+            std::cout << Indent{1} << ip << ": " << TrimInstruction(descriptor_.instructions_str[ip]) << '\n';
+        }
+        PatchedProgram patched = InsertFences(descriptor_, instruction_pointers_, fences_after_);
+        std::cout << "Patched program:\n";
+        PrintProgram(std::cout, patched.descriptor);
+        std::cout << "Instruction pointers:";
+        for (size_t ip : patched.instruction_pointers) {
+            std::cout << ' ' << ip;
+        }
+        std::cout << '\n';
+    }
+    std::cout << "Violations found: " << violations_.size() << '\n';
+    std::cout << "Explorations: " << explorations_ << '\n';
+}
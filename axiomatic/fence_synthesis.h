@@ -0,0 +1,54 @@
+#ifndef FENCE_SYNTHESIS_H
+#define FENCE_SYNTHESIS_H
+#include "consistency.h"
+#include "../common/program_descriptor.h"
+
+#include <ostream>
+#include <set>
+#include <vector>
+
+// program with SEQ_CST fences inserted after some instructions
+struct PatchedProgram {
+    ProgramDescriptor descriptor;
+    std::vector<size_t> instruction_pointers;
+    // instruction of the original program every instruction comes from, fences map to the instruction before them
+    std::vector<size_t> original_ip;
+};
+
+// inserts `fence SEQ_CST` right after each of the given instructions, jump targets and entry points are shifted
+PatchedProgram InsertFences(const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, const std::set<size_t>& fences_after);
+
+// program text that can be parsed again
+void PrintProgram(std::ostream& os, const ProgramDescriptor& descriptor);
+
+/**
+ * Searches for a smallest set of writes such that a SEQ_CST fence after each of them makes the program
+ * robust against TSO/PSO. Every violation of robustness is a cycle in po | rf | co | fr, some of its edges are
+ * pairs of accesses of one thread that the model may reorder (a write followed by a read, for PSO also by a write
+ * to another cell); a fence after the write of any such pair breaks the cycle.
+ *
+ * Violations found by previous explorations are kept: each of them gives a set of writes one of which must be
+ * fenced. The next candidate placement is a minimum hitting set of all the sets collected so far, so it breaks
+ * every known cycle at once; only when the patched program is robust the search ends. Since a fence is added only
+ * when some violation requires it, the result is minimal among placements of fences after writes.
+ */
+struct FenceSynthesizer {
+    FenceSynthesizer(const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, MemoryModel model, bool tracing_on);
+
+    void Synthesize();
+    void PrintResult() const;
+    // instructions of the original program followed by a fence
+    const std::set<size_t>& GetFences() const;
+
+private:
+    const ProgramDescriptor& descriptor_;
+    std::vector<size_t> instruction_pointers_;
+    MemoryModel model_;
+    bool tracing_on_;
+    // for every violation found, writes (of the original program) a fence after any of which breaks its cycle
+    std::vector<std::set<size_t>> violations_;
+    std::set<size_t> fences_after_;
+    size_t explorations_ = 0;
+};
+
+#endif //FENCE_SYNTHESIS_H
@@ -0,0 +1,210 @@
+#include "graph_explorer.h"
+#include "../analysis/cfg.h"
+#include "../memory_subsystem/memory_transition_labels.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+GraphExplorer::GraphExplorer(const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, MemoryModel model, bool tracing_on)
+    : descriptor_(descriptor)
+    , model_(model)
+    , tracing_on_(tracing_on)
+    , instruction_pointers_(instruction_pointers)
+    , spin_loops_(FindSpinLoops(descriptor))
+    , bytecode_(CompileBytecode(descriptor)) {
+    auto& final_condition = descriptor.final_condition;
+    if (final_condition && final_condition->GetMaxThreadId() >= instruction_pointers.size()) {
+        throw std::runtime_error{"Final condition refers to a thread that is not started"};
+    }
+}
+
+void GraphExplorer::Explore() {
+    State initial{ExecutionGraph{descriptor_.memory_size, instruction_pointers_.size()}, ThreadSubsystem{descriptor_, instruction_pointers_}};
+    for (auto& thread : initial.threads.threads) {
+        if (!RunLocalInstructions(thread)) {
+            return;
+        }
+    }
+    visited_.insert(initial.graph.GetKey());
+    ++consistent_graphs_;
+    if (!VisitGraph(initial.graph)) {
+        stopped_ = true;
+        return;
+    }
+    Explore(initial);
+}
+
+void GraphExplorer::Explore(const State& state) {
+    auto running_threads = state.threads.GetRunningThreads();
+    if (running_threads.empty()) {
+        CompleteExecution(state.graph, state.threads);
+        return;
+    }
+    for (size_t tid : running_threads) {
+        if (stopped_) {
+            return;
+        }
+        const Thread& thread = state.threads[tid];
+        size_t ip = thread.GetInstructionPointer();
+        const Instruction& instruction = thread.GetInstruction(ip);
+        MemoryTransitionLabel label = GetTransitionLabelByInstruction(instruction, thread.GetRegisters());
+        auto dst = GetDefinedRegister(instruction);
+
+        if (auto* read = std::get_if<ReadLabel>(&label)) {
+            for (size_t write : state.graph.co[read->src]) {
+                State next = state;
+                uint64_t value = next.graph.events[write].written_value;
+                size_t event = next.graph.AddEvent(Event{EventType::READ, tid, 0, ip, read->mode, read->src, value, 0});
+                next.graph.SetReadsFrom(event, write);
+                next.threads[tid].SetLocalValue(*dst, value);
+                Visit(std::move(next), tid);
+            }
+        } else if (auto* write = std::get_if<WriteLabel>(&label)) {
+            // the initial write always stays the first one
+            for (size_t position = 1; position <= state.graph.co[write->dst].size(); ++position) {
+                State next = state;
+                size_t event = next.graph.AddEvent(Event{EventType::WRITE, tid, 0, ip, write->mode, write->dst, 0, write->value});
+                next.graph.InsertCoherence(event, position);
+                Visit(std::move(next), tid);
+            }
+        } else if (auto* rmw = std::get_if<RmwLabel>(&label)) {
+            auto& order = state.graph.co[rmw->src];
+            for (size_t position = 0; position < order.size(); ++position) {
+                State next = state;
+                uint64_t cell_value = next.graph.events[order[position]].written_value;
+                uint64_t result = rmw->modification.Apply(cell_value);
+                size_t event = next.graph.AddEvent(Event{EventType::RMW, tid, 0, ip, rmw->mode, rmw->src, result, cell_value});
+                next.graph.SetReadsFrom(event, order[position]);
+                next.graph.InsertCoherence(event, position + 1);
+                next.threads[tid].SetLocalValue(*dst, result);
+                Visit(std::move(next), tid);
+            }
+        } else if (auto* fence = std::get_if<FenceLabel>(&label)) {
+            State next = state;
+            next.graph.AddEvent(Event{EventType::FENCE, tid, 0, ip, fence->mode, 0, 0, 0});
+            Visit(std::move(next), tid);
+        }
+    }
+}
+
+void GraphExplorer::Visit(State state, size_t thread_id) {
+    if (stopped_) {
+        return;
+    }
+    Thread& thread = state.threads[thread_id];
+    thread.AdvanceInstructionPointer();
+    if (!RunLocalInstructions(thread)) {
+        return;
+    }
+    if (state.graph.thread_events[thread_id].size() > kMaxThreadEvents) {
+        throw std::runtime_error{"Thread #" + std::to_string(thread_id) + " made more than " + std::to_string(kMaxThreadEvents) + " memory accesses, execution graphs of the program may be infinite"};
+    }
+    if (!visited_.insert(state.graph.GetKey()).second || !IsConsistent(state.graph, model_)) {
+        return;
+    }
+    ++consistent_graphs_;
+    if (!VisitGraph(state.graph)) {
+        stopped_ = true;
+        return;
+    }
+    Explore(state);
+}
+
+bool GraphExplorer::VisitGraph(const ExecutionGraph&) {
+    return true;
+}
+
+bool GraphExplorer::RunLocalInstructions(Thread& thread) const {
+    size_t jumps_back = 0;
+    size_t ip = RunThreadLocalOps(bytecode_, thread.GetRegisterFile(), thread.GetInstructionPointer());
+    // stopped at a jump back that is taken, unless it is a memory access or the end of the program
+    while (ip < bytecode_.ops.size() && IsThreadLocal(bytecode_.ops[ip])) {
+        if (++jumps_back > kMaxThreadEvents * bytecode_.ops.size()) {
+            throw std::runtime_error{"Thread-local computation does not terminate"};
+        }
+        size_t target = bytecode_.ops[ip].target;
+        auto& loop = spin_loops_.loop_by_head[target];
+        if (loop && loop->back_edge == ip) {
+            return false;
+        }
+        ip = RunThreadLocalOps(bytecode_, thread.GetRegisterFile(), target);
+    }
+    thread.MoveInstructionPointer(ip);
+    return true;
+}
+
+void GraphExplorer::CompleteExecution(const ExecutionGraph& graph, const ThreadSubsystem& threads) {
+    ++executions_;
+    Outcome outcome = GetOutcome(graph, threads);
+    auto& final_condition = descriptor_.final_condition;
+    if (final_condition) {
+        if (!final_condition->IsTarget(outcome)) {
+            return;
+        }
+        target_found_ = true;
+        stopped_ = true;
+        final_condition->Print(std::cout, descriptor_.memory_name, descriptor_.register_name);
+        if (final_condition->quantifier == ConditionQuantifier::EXISTS) {
+            std::cout << ": witness found\n";
+        } else {
+            std::cout << ": counterexample found\n";
+        }
+        std::cout << "Execution graph:\n";
+        graph.Print(std::cout, descriptor_.memory_name, descriptor_.instructions_str, 1);
+        PrintFinalState(graph, threads);
+        return;
+    }
+    if (tracing_on_) {
+        std::cout << "Execution graph:\n";
+        graph.Print(std::cout, descriptor_.memory_name, descriptor_.instructions_str, 1);
+    }
+    if (outcomes_.insert(outcome).second) {
+        PrintFinalState(graph, threads);
+    }
+}
+
+Outcome GraphExplorer::GetOutcome(const ExecutionGraph& graph, const ThreadSubsystem& threads) const {
+    Outcome outcome;
+    for (auto& thread : threads.threads) {
+        outcome.registers.push_back(thread.GetRegisters().GetValues());
+    }
+    for (MemoryCell cell = 0; cell < descriptor_.memory_size; ++cell) {
+        outcome.memory.push_back(graph.GetFinalValue(cell));
+    }
+    return outcome;
+}
+
+void GraphExplorer::PrintFinalState(const ExecutionGraph& graph, const ThreadSubsystem& threads) const {
+    std::cout << "Final state:\n";
+    threads.Print(std::cout);
+    std::cout << "Memory:\n";
+    for (MemoryCell cell = 0; cell < descriptor_.memory_size; ++cell) {
+        std::cout << Indent{1};
+        if (cell < descriptor_.memory_name.size()) {
+            std::cout << descriptor_.memory_name[cell];
+        } else {
+            std::cout << cell;
+        }
+        std::cout << ": " << graph.GetFinalValue(cell) << '\n';
+    }
+}
+
+void GraphExplorer::PrintVerdict() const {
+    std::cout << "Consistent graphs: " << consistent_graphs_ << '\n';
+    std::cout << "Complete executions: " << executions_ << '\n';
+    auto& final_condition = descriptor_.final_condition;
+    if (!final_condition) {
+        std::cout << "Distinct outcomes: " << outcomes_.size() << '\n';
+        return;
+    }
+    if (target_found_) {
+        return;
+    }
+    final_condition->Print(std::cout, descriptor_.memory_name, descriptor_.register_name);
+    if (final_condition->quantifier == ConditionQuantifier::EXISTS) {
+        std::cout << ": no consistent witness, the condition never holds\n";
+    } else {
+        std::cout << ": no consistent counterexample, the condition always holds\n";
+    }
+}
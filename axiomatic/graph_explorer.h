@@ -0,0 +1,72 @@
+#ifndef GRAPH_EXPLORER_H
+#define GRAPH_EXPLORER_H
+#include "execution_graph.h"
+#include "consistency.h"
+#include "../analysis/spin_loops.h"
+#include "../common/program_descriptor.h"
+#include "../instruction/bytecode.h"
+#include "../condition/outcome.h"
+#include "../executors/controllable_executor.h"
+#include "../thread_subsystem/thread_subsystem.h"
+
+#include <set>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * Axiomatic exploration: instead of interleaving steps of threads and store buffers, execution graphs
+ * are built event by event. A new read takes its value from any write already in the graph, a new write
+ * is put at any position of the coherence order of its cell; the graph is kept only if it is consistent
+ * with the memory model. Every consistent graph is explored once no matter in which order its events
+ * were added, so executions that differ only in the interleaving of independent steps are not repeated.
+ *
+ * Threads are executed by the same interpreter as in the operational mode. An iteration of a busy-wait loop
+ * that jumps back is not added to the graph: dropping it keeps the rest of the graph consistent, so
+ * every outcome is still reached while spinning threads produce finitely many graphs.
+ */
+struct GraphExplorer {
+    GraphExplorer(const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, MemoryModel model, bool tracing_on);
+
+    void Explore();
+    virtual void PrintVerdict() const;
+    virtual ~GraphExplorer() = default;
+
+protected:
+    // called for every new graph consistent with the model, exploration stops once it returns false
+    virtual bool VisitGraph(const ExecutionGraph& graph);
+    // called when all the threads of a consistent graph are completed
+    virtual void CompleteExecution(const ExecutionGraph& graph, const ThreadSubsystem& threads);
+    Outcome GetOutcome(const ExecutionGraph& graph, const ThreadSubsystem& threads) const;
+    void PrintFinalState(const ExecutionGraph& graph, const ThreadSubsystem& threads) const;
+
+    const ProgramDescriptor& descriptor_;
+    MemoryModel model_;
+    bool tracing_on_;
+    size_t consistent_graphs_ = 0;
+    size_t executions_ = 0;
+    bool stopped_ = false;
+
+private:
+    struct State {
+        ExecutionGraph graph;
+        ThreadSubsystem threads;
+    };
+
+    void Explore(const State& state);
+    // adds the state to the search if its graph is consistent and new
+    void Visit(State state, size_t thread_id);
+    // executes thread-local instructions up to the next memory access, false if the thread spins in a busy-wait loop
+    bool RunLocalInstructions(Thread& thread) const;
+
+    // no correct program with a finite state space makes that many memory accesses in a single thread
+    static constexpr size_t kMaxThreadEvents = 4096;
+
+    std::vector<size_t> instruction_pointers_;
+    SpinLoopInfo spin_loops_;
+    Bytecode bytecode_;
+    std::unordered_set<StateKey, StateKeyHash> visited_;
+    std::set<Outcome> outcomes_;
+    bool target_found_ = false;
+};
+
+#endif //GRAPH_EXPLORER_H
@@ -0,0 +1,110 @@
+#include "model_diff.h"
+#include "../utility/print_util.h"
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+std::vector<MemoryModel> ParseMemoryModels(const std::string& names) {
+    std::vector<MemoryModel> models;
+    size_t start = 0;
+    while (start <= names.size()) {
+        size_t end = std::min(names.find(',', start), names.size());
+        models.push_back(ParseMemoryModel(names.substr(start, end - start)));
+        start = end + 1;
+    }
+    // enumerators go from the strongest model to the weakest one
+    std::sort(models.begin(), models.end());
+    if (std::adjacent_find(models.begin(), models.end()) != models.end()) {
+        throw std::runtime_error{"Memory model is listed twice"};
+    }
+    return models;
+}
+
+ModelDiffExplorer::ModelDiffExplorer(const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, const std::vector<MemoryModel>& models, bool tracing_on)
+    : GraphExplorer(descriptor, instruction_pointers, models.back(), tracing_on)
+    , models_(models) {
+
+}
+
+void ModelDiffExplorer::CompleteExecution(const ExecutionGraph& graph, const ThreadSubsystem& threads) {
+    ++executions_;
+    Outcome outcome = GetOutcome(graph, threads);
+    auto it = strongest_model_.find(outcome);
+    // graphs are consistent with the weakest model, only stronger models than the known one are worth checking
+    size_t known = it == strongest_model_.end() ? models_.size() - 1 : it->second;
+    size_t strongest = known;
+    for (size_t i = 0; i < known; ++i) {
+        if (IsConsistent(graph, models_[i])) {
+            strongest = i;
+            break;
+        }
+    }
+    if (tracing_on_) {
+        std::cout << "Execution graph (" << GetMemoryModelName(models_[strongest]) << "):\n";
+        graph.Print(std::cout, descriptor_.memory_name, descriptor_.instructions_str, 1);
+    }
+    strongest_model_[outcome] = strongest;
+}
+
+const std::map<Outcome, size_t>& ModelDiffExplorer::GetStrongestModels() const {
+    return strongest_model_;
+}
+
+void ModelDiffExplorer::PrintOutcome(const Outcome& outcome) const {
+    std::cout << Indent{1};
+    for (size_t thread_id = 0; thread_id < outcome.registers.size(); ++thread_id) {
+        auto& registers = outcome.registers[thread_id];
+        for (size_t reg = 0; reg < registers.size(); ++reg) {
+            std::cout << thread_id << ':' << descriptor_.register_name[reg] << '=' << registers[reg] << ' ';
+        }
+    }
+    for (MemoryCell cell = 0; cell < outcome.memory.size(); ++cell) {
+        if (cell < descriptor_.memory_name.size()) {
+            std::cout << descriptor_.memory_name[cell];
+        } else {
+            std::cout << cell;
+        }
+        std::cout << '=' << outcome.memory[cell] << ' ';
+    }
+    std::cout << '\n';
+}
+
+void ModelDiffExplorer::PrintVerdict() const {
+    std::cout << "Consistent graphs (" << GetMemoryModelName(models_.back()) << "): " << consistent_graphs_ << '\n';
+    std::cout << "Complete executions: " << executions_ << '\n';
+    std::vector<size_t> outcomes_cnt(models_.size(), 0);
+    for (auto& [outcome, strongest] : strongest_model_) {
+        for (size_t i = strongest; i < models_.size(); ++i) {
+            ++outcomes_cnt[i];
+        }
+    }
+    for (size_t i = 0; i < models_.size(); ++i) {
+        std::cout << "Distinct outcomes (" << GetMemoryModelName(models_[i]) << "): " << outcomes_cnt[i] << '\n';
+    }
+    for (size_t i = 1; i < models_.size(); ++i) {
+        std::cout << "Allowed by " << GetMemoryModelName(models_[i]) << ", not by " << GetMemoryModelName(models_[i - 1]) << ":\n";
+        for (auto& [outcome, strongest] : strongest_model_) {
+            if (strongest == i) {
+                PrintOutcome(outcome);
+            }
+        }
+    }
+
+    auto& final_condition = descriptor_.final_condition;
+    if (!final_condition) {
+        return;
+    }
+    for (size_t i = 0; i < models_.size(); ++i) {
+        bool target_found = std::any_of(strongest_model_.begin(), strongest_model_.end(), [&](const auto& entry) {
+            return entry.second <= i && final_condition->IsTarget(entry.first);
+        });
+        final_condition->Print(std::cout, descriptor_.memory_name, descriptor_.register_name);
+        std::cout << " under " << GetMemoryModelName(models_[i]) << ": ";
+        if (final_condition->quantifier == ConditionQuantifier::EXISTS) {
+            std::cout << (target_found ? "witness found\n" : "the condition never holds\n");
+        } else {
+            std::cout << (target_found ? "counterexample found\n" : "the condition always holds\n");
+        }
+    }
+}
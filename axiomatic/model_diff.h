@@ -0,0 +1,35 @@
+#ifndef MODEL_DIFF_H
+#define MODEL_DIFF_H
+#include "graph_explorer.h"
+
+#include <map>
+#include <vector>
+
+/**
+ * Explores several memory models at once. SC graphs are TSO-consistent and TSO graphs are PSO-consistent,
+ * so the graphs of the weakest requested model contain the ones of all the others: they are explored once and
+ * every complete graph is checked against the stronger models, from the strongest one, until it is consistent.
+ * An outcome belongs to a model if some graph producing it is consistent with the model.
+ */
+struct ModelDiffExplorer : GraphExplorer {
+    // models are ordered from the strongest to the weakest
+    ModelDiffExplorer(const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, const std::vector<MemoryModel>& models, bool tracing_on);
+
+    void PrintVerdict() const override;
+    const std::map<Outcome, size_t>& GetStrongestModels() const;
+
+protected:
+    void CompleteExecution(const ExecutionGraph& graph, const ThreadSubsystem& threads) override;
+
+private:
+    void PrintOutcome(const Outcome& outcome) const;
+
+    std::vector<MemoryModel> models_;
+    // index of the strongest model that allows the outcome
+    std::map<Outcome, size_t> strongest_model_;
+};
+
+// comma separated list of models, e.g. "sc,tso,pso", ordered from the strongest to the weakest
+std::vector<MemoryModel> ParseMemoryModels(const std::string& names);
+
+#endif //MODEL_DIFF_H
@@ -0,0 +1,204 @@
+#include "relation.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+
+constexpr size_t kWordBits = 64;
+
+size_t WordsFor(size_t size) {
+    return (size + kWordBits - 1) / kWordBits;
+}
+
+// first set bit of the row with index >= start, `size` if there is none
+size_t FindNextBit(const uint64_t* row, size_t start, size_t size) {
+    size_t words = WordsFor(size);
+    size_t word = start / kWordBits;
+    if (word >= words) {
+        return size;
+    }
+    uint64_t current = row[word] & (~uint64_t{0} << (start % kWordBits));
+    while (current == 0) {
+        if (++word == words) {
+            return size;
+        }
+        current = row[word];
+    }
+    return word * kWordBits + __builtin_ctzll(current);
+}
+
+void OrRow(uint64_t* dst, const uint64_t* src, size_t words) {
+    for (size_t word = 0; word < words; ++word) {
+        dst[word] |= src[word];
+    }
+}
+
+}  // namespace
+
+Relation::Relation(size_t size)
+    : size_(size)
+    , words_(WordsFor(size))
+    , bits_(size * words_, 0) {
+
+}
+
+size_t Relation::Size() const {
+    return size_;
+}
+
+void Relation::Resize(size_t size) {
+    size_t words = WordsFor(size);
+    if (words == words_ && size >= size_) {
+        bits_.resize(size * words, 0);
+    } else {
+        std::vector<uint64_t> bits(size * words, 0);
+        size_t rows = std::min(size, size_);
+        size_t row_words = std::min(words, words_);
+        for (size_t from = 0; from < rows; ++from) {
+            std::copy(Row(from), Row(from) + row_words, bits.begin() + from * words);
+            // pairs with targets that are dropped
+            if (size < size_ && size % kWordBits != 0) {
+                bits[from * words + words - 1] &= (uint64_t{1} << (size % kWordBits)) - 1;
+            }
+        }
+        bits_ = std::move(bits);
+        words_ = words;
+    }
+    size_ = size;
+}
+
+uint64_t* Relation::Row(size_t from) {
+    return bits_.data() + from * words_;
+}
+
+const uint64_t* Relation::Row(size_t from) const {
+    return bits_.data() + from * words_;
+}
+
+void Relation::Add(size_t from, size_t to) {
+    Row(from)[to / kWordBits] |= uint64_t{1} << (to % kWordBits);
+}
+
+bool Relation::Contains(size_t from, size_t to) const {
+    return (Row(from)[to / kWordBits] >> (to % kWordBits)) & 1;
+}
+
+std::vector<size_t> Relation::Successors(size_t from) const {
+    std::vector<size_t> successors;
+    for (size_t to = FindNextBit(Row(from), 0, size_); to < size_; to = FindNextBit(Row(from), to + 1, size_)) {
+        successors.push_back(to);
+    }
+    return successors;
+}
+
+Relation& Relation::operator|=(const Relation& other) {
+    OrRow(bits_.data(), other.bits_.data(), bits_.size());
+    return *this;
+}
+
+Relation Relation::operator|(const Relation& other) const {
+    Relation result = *this;
+    result |= other;
+    return result;
+}
+
+Relation Relation::Compose(const Relation& other) const {
+    Relation result(size_);
+    for (size_t from = 0; from < size_; ++from) {
+        const uint64_t* row = Row(from);
+        for (size_t middle = FindNextBit(row, 0, size_); middle < size_; middle = FindNextBit(row, middle + 1, size_)) {
+            OrRow(result.Row(from), other.Row(middle), words_);
+        }
+    }
+    return result;
+}
+
+Relation Relation::Inverse() const {
+    Relation result(size_);
+    for (size_t from = 0; from < size_; ++from) {
+        const uint64_t* row = Row(from);
+        for (size_t to = FindNextBit(row, 0, size_); to < size_; to = FindNextBit(row, to + 1, size_)) {
+            result.Add(to, from);
+        }
+    }
+    return result;
+}
+
+void Relation::RemoveIdentity() {
+    for (size_t from = 0; from < size_; ++from) {
+        Row(from)[from / kWordBits] &= ~(uint64_t{1} << (from % kWordBits));
+    }
+}
+
+void Relation::TransitivelyClose() {
+    // Warshall: after step k every path through elements 0..k is a direct edge
+    for (size_t middle = 0; middle < size_; ++middle) {
+        const uint64_t* middle_row = Row(middle);
+        for (size_t from = 0; from < size_; ++from) {
+            if (Contains(from, middle)) {
+                OrRow(Row(from), middle_row, words_);
+            }
+        }
+    }
+}
+
+void Relation::AddClosed(size_t from, size_t to) {
+    if (Contains(from, to)) {
+        return;
+    }
+    // everything reaching `from` (and `from` itself) now reaches `to` and everything `to` reaches
+    std::vector<uint64_t> reached(Row(to), Row(to) + words_);
+    reached[to / kWordBits] |= uint64_t{1} << (to % kWordBits);
+    for (size_t source = 0; source < size_; ++source) {
+        if (source == from || Contains(source, from)) {
+            OrRow(Row(source), reached.data(), words_);
+        }
+    }
+}
+
+bool Relation::IsAcyclic() const {
+    return !FindCycle();
+}
+
+std::optional<std::vector<size_t>> Relation::FindCycle() const {
+    enum Color {
+        WHITE, GRAY, BLACK
+    };
+    std::vector<Color> color(size_, WHITE);
+    // vertex and the smallest successor that is not checked yet
+    std::vector<std::pair<size_t, size_t>> stack;
+    for (size_t start = 0; start < size_; ++start) {
+        if (color[start] != WHITE) {
+            continue;
+        }
+        color[start] = GRAY;
+        stack.emplace_back(start, 0);
+        while (!stack.empty()) {
+            auto& [vertex, next] = stack.back();
+            size_t to = FindNextBit(Row(vertex), next, size_);
+            if (to == size_) {
+                color[vertex] = BLACK;
+                stack.pop_back();
+                continue;
+            }
+            next = to + 1;
+            if (color[to] == GRAY) {
+                std::vector<size_t> cycle;
+                size_t position = stack.size();
+                while (stack[position - 1].first != to) {
+                    --position;
+                }
+                for (; position <= stack.size(); ++position) {
+                    cycle.push_back(stack[position - 1].first);
+                }
+                return cycle;
+            }
+            if (color[to] == WHITE) {
+                color[to] = GRAY;
+                stack.emplace_back(to, 0);
+            }
+        }
+    }
+    return std::nullopt;
+}
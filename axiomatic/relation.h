@@ -0,0 +1,50 @@
+#ifndef RELATION_H
+#define RELATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * Binary relation over elements 0..size-1 (events of an execution graph) stored as an adjacency matrix:
+ * every row is a bitset packed into 64-bit words, rows are contiguous. Union and composition
+ * are word-wise loops over whole rows, which compilers vectorize.
+ */
+struct Relation {
+    explicit Relation(size_t size = 0);
+
+    size_t Size() const;
+    // adds isolated elements to the end
+    void Resize(size_t size);
+
+    void Add(size_t from, size_t to);
+    bool Contains(size_t from, size_t to) const;
+    // elements related to `from`
+    std::vector<size_t> Successors(size_t from) const;
+
+    Relation& operator|=(const Relation& other);
+    Relation operator|(const Relation& other) const;
+    // sequential composition: (a, c) such that (a, b) is in this relation and (b, c) in the other one
+    Relation Compose(const Relation& other) const;
+    Relation Inverse() const;
+    void RemoveIdentity();
+
+    void TransitivelyClose();
+    // adds an edge to a transitively closed relation keeping it closed
+    void AddClosed(size_t from, size_t to);
+
+    bool IsAcyclic() const;
+    // elements of some cycle in order, the last one is related to the first
+    std::optional<std::vector<size_t>> FindCycle() const;
+
+private:
+    uint64_t* Row(size_t from);
+    const uint64_t* Row(size_t from) const;
+
+    size_t size_;
+    size_t words_;
+    std::vector<uint64_t> bits_;
+};
+
+#endif //RELATION_H
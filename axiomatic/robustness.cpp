@@ -0,0 +1,55 @@
+#include "robustness.h"
+
+#include <iostream>
+
+RobustnessChecker::RobustnessChecker(const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, MemoryModel model, bool tracing_on)
+    : GraphExplorer(descriptor, instruction_pointers, model, tracing_on) {
+
+}
+
+const std::optional<RobustnessViolation>& RobustnessChecker::GetViolation() const {
+    return violation_;
+}
+
+bool RobustnessChecker::VisitGraph(const ExecutionGraph& graph) {
+    if (model_ == MemoryModel::SC) {
+        return true;
+    }
+    auto cycle = FindScCycle(graph);
+    if (!cycle) {
+        return true;
+    }
+    violation_ = RobustnessViolation{graph, std::move(*cycle)};
+    return false;
+}
+
+void RobustnessChecker::CompleteExecution(const ExecutionGraph& graph, [[maybe_unused]] const ThreadSubsystem& threads) {
+    ++executions_;
+    if (tracing_on_) {
+        std::cout << "Execution graph:\n";
+        graph.Print(std::cout, descriptor_.memory_name, descriptor_.instructions_str, 1);
+    }
+}
+
+void RobustnessChecker::PrintVerdict() const {
+    std::cout << "Consistent graphs: " << consistent_graphs_ << '\n';
+    if (!violation_) {
+        std::cout << "Program is robust against " << GetMemoryModelName(model_) << ": every consistent execution graph is sequentially consistent\n";
+        return;
+    }
+    std::cout << "Program is not robust against " << GetMemoryModelName(model_) << ", execution graph that is not sequentially consistent:\n";
+    const ExecutionGraph& graph = violation_->graph;
+    graph.Print(std::cout, descriptor_.memory_name, descriptor_.instructions_str, 1);
+    std::cout << "Cycle in po | rf | co | fr:\n";
+    GraphRelations relations(graph);
+    auto& cycle = violation_->cycle;
+    for (size_t i = 0; i < cycle.size(); ++i) {
+        size_t from = cycle[i];
+        size_t to = cycle[(i + 1) % cycle.size()];
+        std::cout << Indent{1};
+        graph.PrintEvent(std::cout, from, descriptor_.memory_name, descriptor_.instructions_str);
+        std::cout << " -" << GetEdgeName(relations, from, to) << "-> ";
+        graph.PrintEventId(std::cout, to);
+        std::cout << '\n';
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef ROBUSTNESS_H
+#define ROBUSTNESS_H
+#include "graph_explorer.h"
+
+#include <optional>
+#include <vector>
+
+// execution graph consistent with a weak model that has a cycle in po | rf | co | fr
+struct RobustnessViolation {
+    ExecutionGraph graph;
+    std::vector<size_t> cycle;
+};
+
+/**
+ * Checks whether a weak model (TSO/PSO) allows executions that are not sequentially consistent.
+ * Graphs consistent with the weak model are explored as in GraphExplorer and every new one is checked for
+ * an SC cycle. The search stops at the first violation; before it every explored graph is sequentially
+ * consistent, so checking a robust program costs about as much as exploring it under SC.
+ *
+ * A violation is a non-SC execution graph, it does not necessarily produce an outcome that SC can't.
+ */
+struct RobustnessChecker : GraphExplorer {
+    RobustnessChecker(const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, MemoryModel model, bool tracing_on);
+
+    const std::optional<RobustnessViolation>& GetViolation() const;
+    void PrintVerdict() const override;
+
+protected:
+    bool VisitGraph(const ExecutionGraph& graph) override;
+    void CompleteExecution(const ExecutionGraph& graph, const ThreadSubsystem& threads) override;
+
+private:
+    std::optional<RobustnessViolation> violation_;
+};
+
+#endif //ROBUSTNESS_H
@@ -0,0 +1,288 @@
+#include "batch_runner.h"
+#include "../api/exploration.h"
+#include "../cache/outcome_cache.h"
+#include "../common/binary_program.h"
+#include "../parser/litmus.h"
+
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+// calls task(i) for every i < count on `jobs` threads
+template <typename Task>
+void RunParallel(size_t count, size_t jobs, const Task& task) {
+    std::atomic<size_t> next{0};
+    auto worker = [&] () {
+        for (size_t i = next++; i < count; i = next++) {
+            task(i);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < std::min(jobs, count); ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+BatchResult RunTest(const ProgramPtr& program, const BatchTest& test, const BatchOptions& options) {
+    ExplorationConfig config;
+    config.model = GetMemoryModelName(test.model);
+    config.instruction_pointers = test.instruction_pointers;
+    config.time_limit = test.time_limit ? test.time_limit : options.time_limit;
+    config.memory_limit_bytes = options.memory_limit_bytes;
+    Exploration exploration{program, std::move(config)};
+    std::optional<OutcomeCache> cache;
+    std::string key;
+    std::optional<ExplorationRecord> record;
+    if (options.cache_directory) {
+        cache.emplace(*options.cache_directory);
+        key = GetExplorationKey(GetProgramHash(program->descriptor), exploration.GetConfig());
+        record = cache->Find(key);
+    }
+    BatchResult result;
+    result.cached = record.has_value();
+    if (!record) {
+        record = RecordExploration(exploration, program->descriptor);
+        if (cache && IsReproducible(record->result.status)) {
+            cache->Store(key, *record);
+        }
+    }
+    const ExplorationResult& exploration_result = record->result;
+
+    result.instruction_pointers = exploration.GetConfig().instruction_pointers;
+    result.time = exploration_result.time;
+    result.consistent_graphs = exploration_result.states;
+    result.executions = exploration_result.executions;
+    result.outcomes = record->outcomes;
+    if (exploration_result.status == ExplorationStatus::TIMEOUT) {
+        result.status = BatchStatus::TIMEOUT;
+        result.message = "Time limit exceeded";
+        return result;
+    }
+    if (exploration_result.status == ExplorationStatus::MEMORY_LIMIT) {
+        result.status = BatchStatus::MEMORY_LIMIT;
+        result.message = "Memory limit exceeded";
+        return result;
+    }
+    result.found = exploration_result.found;
+    if (test.expect_found) {
+        if (!result.found) {
+            result.status = BatchStatus::FAILED;
+            result.message = "Expected a verdict of the final condition, but the program has none";
+        } else if (*result.found != *test.expect_found) {
+            result.status = BatchStatus::FAILED;
+            result.message = *test.expect_found ? "Expected the final condition target to be found" : "Unexpected final condition target found";
+        }
+    }
+    if (test.expect_outcomes && result.outcomes.size() != *test.expect_outcomes) {
+        result.status = BatchStatus::FAILED;
+        result.message = "Expected " + std::to_string(*test.expect_outcomes) + " distinct outcomes, found " + std::to_string(result.outcomes.size());
+    }
+    return result;
+}
+
+// the rest of a manifest line after the program file
+void ParseTestParameters(std::istream& words, BatchTest& test) {
+    std::string word;
+    if (!(words >> word)) {
+        throw std::runtime_error{"expected a memory model"};
+    }
+    test.model = ParseMemoryModel(word);
+    while (words >> word) {
+        try {
+            if (word.rfind("expect=", 0) == 0) {
+                std::string expected = word.substr(7);
+                if (expected != "found" && expected != "not-found") {
+                    throw std::runtime_error{"expected verdict should be found or not-found"};
+                }
+                test.expect_found = expected == "found";
+            } else if (word.rfind("outcomes=", 0) == 0) {
+                test.expect_outcomes = std::stoull(word.substr(9));
+            } else if (word.rfind("time-limit-ms=", 0) == 0) {
+                test.time_limit = std::chrono::milliseconds{std::stoull(word.substr(14))};
+            } else {
+                test.instruction_pointers.push_back(std::stoull(word));
+            }
+        } catch (const std::logic_error&) {
+            throw std::runtime_error{"unexpected " + word};
+        }
+    }
+    if (test.instruction_pointers.empty() && !IsLitmusPath(test.path)) {
+        throw std::runtime_error{"expected positive number of instruction pointers"};
+    }
+}
+
+void PrintJsonString(std::ostream& os, const std::string& value) {
+    os << '"';
+    for (char c : value) {
+        switch (c) {
+            case '"':
+                os << "\\\"";
+                break;
+            case '\\':
+                os << "\\\\";
+                break;
+            case '\n':
+                os << "\\n";
+                break;
+            case '\t':
+                os << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    static constexpr char kHex[] = "0123456789abcdef";
+                    os << "\\u00" << kHex[c >> 4] << kHex[c & 0xf];
+                } else {
+                    os << c;
+                }
+        }
+    }
+    os << '"';
+}
+
+template <typename T>
+void PrintJsonOptional(std::ostream& os, const std::optional<T>& value) {
+    if (value) {
+        os << std::boolalpha << *value << std::noboolalpha;
+    } else {
+        os << "null";
+    }
+}
+
+}  // namespace
+
+std::vector<BatchTest> ReadManifest(const std::string& path) {
+    std::filesystem::path manifest_path{path};
+    if (std::filesystem::is_directory(manifest_path)) {
+        manifest_path /= "manifest";
+    }
+    std::ifstream input{manifest_path};
+    if (!input) {
+        throw std::runtime_error{"Can't open manifest " + manifest_path.string()};
+    }
+    std::vector<BatchTest> tests;
+    std::string line;
+    for (size_t line_number = 1; std::getline(input, line); ++line_number) {
+        std::istringstream words{line};
+        std::string file;
+        if (!(words >> file) || file[0] == '#') {
+            continue;
+        }
+        BatchTest test;
+        test.path = (manifest_path.parent_path() / file).string();
+        try {
+            ParseTestParameters(words, test);
+        } catch (const std::runtime_error& e) {
+            test.error = "Manifest " + manifest_path.string() + ":" + std::to_string(line_number) + ": " + e.what();
+        }
+        tests.push_back(std::move(test));
+    }
+    return tests;
+}
+
+std::vector<BatchResult> RunBatch(const std::vector<BatchTest>& tests, const BatchOptions& options) {
+    // every program is loaded once, however many tests use it
+    std::map<std::string, size_t> program_index;
+    for (auto& test : tests) {
+        if (test.error.empty()) {
+            program_index.emplace(test.path, program_index.size());
+        }
+    }
+    std::vector<std::string> paths(program_index.size());
+    for (auto& [path, index] : program_index) {
+        paths[index] = path;
+    }
+    std::vector<ProgramPtr> programs(paths.size());
+    std::vector<std::string> load_errors(paths.size());
+    RunParallel(paths.size(), options.jobs, [&] (size_t i) {
+        try {
+            programs[i] = OpenProgram(paths[i]);
+        } catch (const std::exception& e) {
+            load_errors[i] = e.what();
+        }
+    });
+
+    std::vector<BatchResult> results(tests.size());
+    RunParallel(tests.size(), options.jobs, [&] (size_t i) {
+        try {
+            if (!tests[i].error.empty()) {
+                throw std::runtime_error{tests[i].error};
+            }
+            size_t program = program_index.at(tests[i].path);
+            if (!programs[program]) {
+                throw std::runtime_error{load_errors[program]};
+            }
+            results[i] = RunTest(programs[program], tests[i], options);
+        } catch (const std::exception& e) {
+            results[i].status = BatchStatus::ERROR;
+            results[i].message = e.what();
+        }
+    });
+    return results;
+}
+
+void WriteBatchReport(std::ostream& os, const std::vector<BatchTest>& tests, const std::vector<BatchResult>& results) {
+    std::map<BatchStatus, size_t> statuses;
+    os << "{\n  \"tests\": [";
+    for (size_t i = 0; i < tests.size(); ++i) {
+        const BatchTest& test = tests[i];
+        const BatchResult& result = results[i];
+        ++statuses[result.status];
+        os << (i == 0 ? "\n" : ",\n") << "    {\"path\": ";
+        PrintJsonString(os, test.path);
+        os << ", \"model\": \"" << GetMemoryModelName(test.model) << "\", \"instruction_pointers\": [";
+        auto& instruction_pointers = result.instruction_pointers.empty() ? test.instruction_pointers : result.instruction_pointers;
+        for (size_t j = 0; j < instruction_pointers.size(); ++j) {
+            os << (j == 0 ? "" : ", ") << instruction_pointers[j];
+        }
+        os << "], \"status\": \"" << GetBatchStatusName(result.status) << "\", \"message\": ";
+        PrintJsonString(os, result.message);
+        os << ", \"time_ms\": " << result.time.count();
+        os << ", \"cached\": " << std::boolalpha << result.cached << std::noboolalpha;
+        os << ", \"consistent_graphs\": " << result.consistent_graphs;
+        os << ", \"executions\": " << result.executions;
+        os << ", \"found\": ";
+        PrintJsonOptional(os, result.found);
+        os << ", \"expect_found\": ";
+        PrintJsonOptional(os, test.expect_found);
+        os << ", \"expect_outcomes\": ";
+        PrintJsonOptional(os, test.expect_outcomes);
+        os << ", \"outcomes\": [";
+        for (size_t j = 0; j < result.outcomes.size(); ++j) {
+            os << (j == 0 ? "" : ", ");
+            PrintJsonString(os, result.outcomes[j]);
+        }
+        os << "]}";
+    }
+    os << "\n  ],\n  \"summary\": {";
+    for (auto status : {BatchStatus::PASSED, BatchStatus::FAILED, BatchStatus::TIMEOUT, BatchStatus::MEMORY_LIMIT, BatchStatus::ERROR}) {
+        os << (status == BatchStatus::PASSED ? "" : ", ") << '"' << GetBatchStatusName(status) << "\": " << statuses[status];
+    }
+    os << "}\n}\n";
+}
+
+std::string GetBatchStatusName(BatchStatus status) {
+    switch (status) {
+        case BatchStatus::PASSED:
+            return "passed";
+        case BatchStatus::FAILED:
+            return "failed";
+        case BatchStatus::TIMEOUT:
+            return "timeout";
+        case BatchStatus::MEMORY_LIMIT:
+            return "memory-limit";
+        case BatchStatus::ERROR:
+            return "error";
+    }
+    return "unknown";
+}
@@ -0,0 +1,72 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+#include "../axiomatic/consistency.h"
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// one line of a manifest: "<program-file> <model> <instruction_pointers...> [expect=found|not-found] [outcomes=<N>] [time-limit-ms=<N>]"
+struct BatchTest {
+    std::string path;
+    MemoryModel model = MemoryModel::SC;
+    // may be empty for `.litmus` tests, their threads are started then
+    std::vector<size_t> instruction_pointers;
+    // whether a witness (for "exists") or a counterexample (for "forall") of the final condition is expected
+    std::optional<bool> expect_found;
+    std::optional<size_t> expect_outcomes;
+    // overrides the time budget of the batch
+    std::optional<std::chrono::milliseconds> time_limit;
+    // why the line is malformed, such a test isn't run and is reported as an error
+    std::string error;
+};
+
+struct BatchOptions {
+    size_t jobs = 1;
+    std::optional<std::chrono::milliseconds> time_limit;
+    std::optional<size_t> memory_limit_bytes;
+    // directory of the outcome cache consulted before running a test
+    std::optional<std::string> cache_directory;
+};
+
+enum class BatchStatus {
+    PASSED, FAILED, TIMEOUT, MEMORY_LIMIT, ERROR
+};
+
+struct BatchResult {
+    BatchStatus status = BatchStatus::PASSED;
+    // explanation of a failure or an error
+    std::string message;
+    // time of the exploration, also when the result was taken from the outcome cache
+    std::chrono::milliseconds time{0};
+    bool cached = false;
+    std::vector<size_t> instruction_pointers;
+    size_t consistent_graphs = 0;
+    size_t executions = 0;
+    std::optional<bool> found;
+    // "0:r=1 1:r=0 x=1", in the order they were found
+    std::vector<std::string> outcomes;
+};
+
+/**
+ * Reads the tests of a manifest, or of the file named "manifest" if the path is a directory. Empty lines and
+ * the ones starting with '#' are skipped, program paths are relative to the directory of the manifest.
+ * Malformed lines are kept as tests with an error, so that they don't hide the rest of the suite.
+ */
+std::vector<BatchTest> ReadManifest(const std::string& path);
+
+/**
+ * Runs the tests on a pool of `jobs` threads, each test is an execution graph exploration as in the `graph` mode
+ * (so only sc, tso and pso are supported). A test stops once it runs out of its time budget or the visited graphs
+ * it keeps exceed the memory budget (estimated from the sizes of the graphs).
+ */
+std::vector<BatchResult> RunBatch(const std::vector<BatchTest>& tests, const BatchOptions& options);
+
+void WriteBatchReport(std::ostream& os, const std::vector<BatchTest>& tests, const std::vector<BatchResult>& results);
+
+std::string GetBatchStatusName(BatchStatus status);
+
+#endif //BATCH_RUNNER_H
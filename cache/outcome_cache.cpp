@@ -0,0 +1,149 @@
+#include "outcome_cache.h"
+#include "../common/binary_program.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <unistd.h>
+
+namespace {
+
+// first line of every entry, entries of other versions are ignored
+constexpr std::string_view kEntryHeader = "wmm-outcome-cache 1";
+
+ExplorationStatus ParseExplorationStatus(const std::string& name) {
+    for (auto status : {ExplorationStatus::COMPLETED, ExplorationStatus::TARGET_FOUND, ExplorationStatus::STOPPED, ExplorationStatus::CANCELLED,
+                        ExplorationStatus::STATE_LIMIT, ExplorationStatus::TIMEOUT, ExplorationStatus::MEMORY_LIMIT}) {
+        if (GetExplorationStatusName(status) == name) {
+            return status;
+        }
+    }
+    throw std::runtime_error{"Unknown exploration status " + name};
+}
+
+// reads "<name> <value>" and returns the value
+std::string ReadField(std::istream& is, const std::string& name) {
+    std::string line;
+    if (!std::getline(is, line) || line.rfind(name + ' ', 0) != 0) {
+        throw std::runtime_error{"Expected field " + name};
+    }
+    return line.substr(name.size() + 1);
+}
+
+}  // namespace
+
+ExplorationRecord RecordExploration(Exploration& exploration, const ProgramDescriptor& descriptor,
+                                    const std::function<bool(const std::string&)>& on_outcome) {
+    ExplorationRecord record;
+    ExplorationCallbacks callbacks;
+    callbacks.on_outcome = [&] (const Outcome& outcome) {
+        record.outcomes.push_back(FormatOutcome(descriptor, outcome));
+        return !on_outcome || on_outcome(record.outcomes.back());
+    };
+    callbacks.on_target = [&] (const Outcome& outcome) {
+        record.target = FormatOutcome(descriptor, outcome);
+    };
+    record.result = exploration.Run(callbacks);
+    return record;
+}
+
+std::string GetExplorationKey(uint64_t program_hash, const ExplorationConfig& config) {
+    std::ostringstream key;
+    key << FormatHash(program_hash) << ' ' << (config.mode == ExplorationMode::GRAPH ? "graph" : "mc") << ' ' << config.model << " ips=";
+    for (size_t i = 0; i < config.instruction_pointers.size(); ++i) {
+        key << (i == 0 ? "" : ",") << config.instruction_pointers[i];
+    }
+    key << " stop-at-target=" << config.stop_at_target;
+    if (config.mode == ExplorationMode::OPERATIONAL) {
+        key << " await-spin-loops=" << config.options.await_spin_loops << " eager-private-propagation=" << config.options.eager_private_propagation
+            << " verdict-only=" << config.options.verdict_only;
+    }
+    if (config.max_states) {
+        key << " max-states=" << *config.max_states;
+    }
+    if (config.memory_limit_bytes) {
+        key << " memory-limit=" << *config.memory_limit_bytes;
+    }
+    return key.str();
+}
+
+bool IsReproducible(ExplorationStatus status) {
+    return status != ExplorationStatus::TIMEOUT && status != ExplorationStatus::STOPPED && status != ExplorationStatus::CANCELLED;
+}
+
+OutcomeCache::OutcomeCache(std::string directory)
+    : directory_(std::move(directory)) {
+    std::filesystem::create_directories(directory_);
+}
+
+std::optional<ExplorationRecord> OutcomeCache::Find(const std::string& key) const {
+    std::ifstream input{GetEntryPath(key)};
+    if (!input) {
+        return std::nullopt;
+    }
+    try {
+        std::string line;
+        if (!std::getline(input, line) || line != kEntryHeader || ReadField(input, "key") != key) {
+            return std::nullopt;
+        }
+        ExplorationRecord record;
+        record.result.status = ParseExplorationStatus(ReadField(input, "status"));
+        record.result.states = std::stoull(ReadField(input, "states"));
+        record.result.executions = std::stoull(ReadField(input, "executions"));
+        std::string found = ReadField(input, "found");
+        if (found != "unknown") {
+            record.result.found = found == "true";
+        }
+        record.result.time = std::chrono::milliseconds{std::stoll(ReadField(input, "time_ms"))};
+        std::string target = ReadField(input, "target");
+        if (target != "-") {
+            record.target = target;
+        }
+        record.result.outcomes = std::stoull(ReadField(input, "outcomes"));
+        for (size_t i = 0; i < record.result.outcomes; ++i) {
+            record.outcomes.push_back(ReadField(input, "outcome"));
+        }
+        // the last line tells a complete entry from a cut one
+        if (!std::getline(input, line) || line != "end") {
+            return std::nullopt;
+        }
+        return record;
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+void OutcomeCache::Store(const std::string& key, const ExplorationRecord& record) const {
+    std::string path = GetEntryPath(key);
+    std::ostringstream thread_id;
+    thread_id << std::this_thread::get_id();
+    std::string temporary_path = path + ".tmp." + std::to_string(getpid()) + "." + thread_id.str();
+    {
+        std::ofstream output{temporary_path};
+        if (!output) {
+            throw std::runtime_error{"Can't write cache entry " + temporary_path};
+        }
+        auto& result = record.result;
+        output << kEntryHeader << '\n';
+        output << "key " << key << '\n';
+        output << "status " << GetExplorationStatusName(result.status) << '\n';
+        output << "states " << result.states << '\n';
+        output << "executions " << result.executions << '\n';
+        output << "found " << (result.found ? (*result.found ? "true" : "false") : "unknown") << '\n';
+        output << "time_ms " << result.time.count() << '\n';
+        output << "target " << record.target.value_or("-") << '\n';
+        output << "outcomes " << record.outcomes.size() << '\n';
+        for (auto& outcome : record.outcomes) {
+            output << "outcome " << outcome << '\n';
+        }
+        output << "end\n";
+    }
+    std::filesystem::rename(temporary_path, path);
+}
+
+std::string OutcomeCache::GetEntryPath(const std::string& key) const {
+    return (std::filesystem::path{directory_} / (FormatHash(HashBytes(key)) + ".outcomes")).string();
+}
@@ -0,0 +1,50 @@
+#ifndef OUTCOME_CACHE_H
+#define OUTCOME_CACHE_H
+#include "../api/exploration.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// what an exploration reported, enough to answer the same query again without exploring
+struct ExplorationRecord {
+    ExplorationResult result;
+    // formatted as by FormatOutcome, in the order they were found
+    std::vector<std::string> outcomes;
+    // witness or counterexample of the final condition
+    std::optional<std::string> target;
+};
+
+// runs the exploration and records its outcomes, `on_outcome` (if set) gets every formatted outcome as it is found
+ExplorationRecord RecordExploration(Exploration& exploration, const ProgramDescriptor& descriptor,
+                                    const std::function<bool(const std::string&)>& on_outcome = {});
+
+/**
+ * Identifies the result of an exploration: the hash of the compiled program (GetProgramHash), the mode, the
+ * model, the entry points and every option that may change the result. The time limit is not a part of it,
+ * since only results that don't depend on time are cached.
+ */
+std::string GetExplorationKey(uint64_t program_hash, const ExplorationConfig& config);
+
+// whether exploring again would give the same result, so it may be cached
+bool IsReproducible(ExplorationStatus status);
+
+/**
+ * Content-addressed directory of exploration results: a result is stored in a text file named by the hash of
+ * its key, the key itself is stored in the file, so entries of colliding keys are never mixed up.
+ * Files are written to a temporary name and renamed, so processes sharing the directory never read a partial
+ * entry; unreadable entries are treated as missing.
+ */
+struct OutcomeCache {
+    explicit OutcomeCache(std::string directory);
+
+    std::optional<ExplorationRecord> Find(const std::string& key) const;
+    void Store(const std::string& key, const ExplorationRecord& record) const;
+    std::string GetEntryPath(const std::string& key) const;
+
+private:
+    std::string directory_;
+};
+
+#endif //OUTCOME_CACHE_H
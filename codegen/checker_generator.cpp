@@ -0,0 +1,538 @@
+#include "checker_generator.h"
+#include "../instruction/bytecode.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <variant>
+
+namespace {
+
+// capacity of store buffers for programs with loops, exceeding it stops the checker with an error
+constexpr size_t kDefaultBufferCapacity = 64;
+
+std::string Quote(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+        }
+        quoted += c;
+    }
+    return quoted + '"';
+}
+
+std::string TrimInstruction(const std::string& instruction) {
+    size_t end = instruction.find_last_not_of(' ');
+    return end == std::string::npos ? std::string{} : instruction.substr(0, end + 1);
+}
+
+std::string GetBinOpCode(BinOp op, const std::string& lhs, const std::string& rhs) {
+    switch (op) {
+        case ADD:
+            return lhs + " + " + rhs;
+        case SUBTRACT:
+            return lhs + " - " + rhs;
+        case DIVIDE:
+            return "Divide(" + lhs + ", " + rhs + ")";
+        case MULTIPLY:
+            return lhs + " * " + rhs;
+        case LESS:
+            return "uint64_t{" + lhs + " < " + rhs + "}";
+        case GREATER:
+            return "uint64_t{" + lhs + " > " + rhs + "}";
+        case LESS_EQUAL:
+            return "uint64_t{" + lhs + " <= " + rhs + "}";
+        case GREATER_EQUAL:
+            return "uint64_t{" + lhs + " >= " + rhs + "}";
+        default:
+            throw std::runtime_error{"Unknown binary operation"};
+    }
+}
+
+// parts of the generated program that do not depend on it
+constexpr const char* kCommonCode = R"(
+struct StateHash {
+    size_t operator()(const State& state) const {
+        // every field is uint64_t, so the state has no padding
+        const uint64_t* words = reinterpret_cast<const uint64_t*>(&state);
+        uint64_t hash = 0;
+        for (size_t i = 0; i < sizeof(State) / sizeof(uint64_t); ++i) {
+            hash = (hash ^ words[i]) * 0x9e3779b97f4a7c15ull;
+            hash ^= hash >> 32;
+        }
+        return hash;
+    }
+};
+
+[[noreturn]] void Fail(const char* message) {
+    std::fprintf(stderr, "%s\n", message);
+    std::exit(2);
+}
+
+[[maybe_unused]] uint64_t Cell(uint64_t address) {
+    if (address >= kMemory) {
+        Fail("Memory access out of the shared state");
+    }
+    return address;
+}
+
+[[maybe_unused]] uint64_t Divide(uint64_t lhs, uint64_t rhs) {
+    if (rhs == 0) {
+        Fail("Division by zero is not allowed");
+    }
+    return lhs / rhs;
+}
+)";
+
+constexpr const char* kScCode = R"(
+[[maybe_unused]] uint64_t Read(const State& state, size_t, uint64_t cell) {
+    return state.mem[cell];
+}
+
+[[maybe_unused]] void Write(State& state, size_t, uint64_t cell, uint64_t value) {
+    state.mem[cell] = value;
+}
+
+void Propagate(const State&, std::vector<State>&) {
+}
+)";
+
+constexpr const char* kTsoCode = R"(
+[[maybe_unused]] uint64_t Read(const State& state, size_t tid, uint64_t cell) {
+    for (size_t i = state.buffer_size[tid]; i > 0; --i) {
+        if (state.buffer_cell[tid][i - 1] == cell) {
+            return state.buffer_value[tid][i - 1];
+        }
+    }
+    return state.mem[cell];
+}
+
+[[maybe_unused]] void Write(State& state, size_t tid, uint64_t cell, uint64_t value) {
+    uint64_t& size = state.buffer_size[tid];
+    if (size == kBufferCapacity) {
+        Fail("Store buffer capacity is exceeded");
+    }
+    state.buffer_cell[tid][size] = cell;
+    state.buffer_value[tid][size] = value;
+    ++size;
+}
+
+void PopFront(State& state, size_t tid) {
+    uint64_t& size = state.buffer_size[tid];
+    state.mem[state.buffer_cell[tid][0]] = state.buffer_value[tid][0];
+    for (size_t i = 1; i < size; ++i) {
+        state.buffer_cell[tid][i - 1] = state.buffer_cell[tid][i];
+        state.buffer_value[tid][i - 1] = state.buffer_value[tid][i];
+    }
+    --size;
+    state.buffer_cell[tid][size] = 0;
+    state.buffer_value[tid][size] = 0;
+}
+
+[[maybe_unused]] void Drain(State& state, size_t tid) {
+    while (state.buffer_size[tid] > 0) {
+        PopFront(state, tid);
+    }
+}
+
+void Propagate(const State& state, std::vector<State>& next) {
+    for (size_t tid = 0; tid < kThreads; ++tid) {
+        if (state.buffer_size[tid] > 0) {
+            next.push_back(state);
+            PopFront(next.back(), tid);
+        }
+    }
+}
+)";
+
+constexpr const char* kPsoCode = R"(
+[[maybe_unused]] uint64_t Read(const State& state, size_t tid, uint64_t cell) {
+    uint64_t size = state.buffer_size[tid][cell];
+    return size > 0 ? state.buffer_value[tid][cell][size - 1] : state.mem[cell];
+}
+
+[[maybe_unused]] void Write(State& state, size_t tid, uint64_t cell, uint64_t value) {
+    uint64_t& size = state.buffer_size[tid][cell];
+    if (size == kBufferCapacity) {
+        Fail("Store buffer capacity is exceeded");
+    }
+    state.buffer_value[tid][cell][size] = value;
+    ++size;
+}
+
+void PopFront(State& state, size_t tid, size_t cell) {
+    uint64_t& size = state.buffer_size[tid][cell];
+    uint64_t* buffer = state.buffer_value[tid][cell];
+    state.mem[cell] = buffer[0];
+    for (size_t i = 1; i < size; ++i) {
+        buffer[i - 1] = buffer[i];
+    }
+    --size;
+    buffer[size] = 0;
+}
+
+[[maybe_unused]] void Drain(State& state, size_t tid) {
+    for (size_t cell = 0; cell < kMemory; ++cell) {
+        uint64_t& size = state.buffer_size[tid][cell];
+        if (size > 0) {
+            state.mem[cell] = state.buffer_value[tid][cell][size - 1];
+            for (size_t i = 0; i < size; ++i) {
+                state.buffer_value[tid][cell][i] = 0;
+            }
+            size = 0;
+        }
+    }
+}
+
+void Propagate(const State& state, std::vector<State>& next) {
+    for (size_t tid = 0; tid < kThreads; ++tid) {
+        for (size_t cell = 0; cell < kMemory; ++cell) {
+            if (state.buffer_size[tid][cell] > 0) {
+                next.push_back(state);
+                PopFront(next.back(), tid, cell);
+            }
+        }
+    }
+}
+)";
+
+constexpr const char* kExploreCode = R"(
+void Expand(const State& state, std::vector<State>& next) {
+    for (size_t tid = 0; tid < kThreads; ++tid) {
+        if (state.ip[tid] != kEnd) {
+            next.push_back(state);
+            Step(next.back(), tid);
+        }
+    }
+    Propagate(state, next);
+}
+
+void PrintOutcome(const State& state) {
+    for (size_t tid = 0; tid < kThreads; ++tid) {
+        for (size_t reg = 0; reg < kRegisters; ++reg) {
+            std::printf("%zu:%s=%llu ", tid, kRegisterName[reg], static_cast<unsigned long long>(state.reg[tid][reg]));
+        }
+    }
+    for (size_t cell = 0; cell < kMemory; ++cell) {
+        std::printf("%s=%llu ", kCellName[cell], static_cast<unsigned long long>(state.mem[cell]));
+    }
+    std::printf("\n");
+}
+
+}  // namespace
+
+int main() {
+    State initial;
+    std::memset(&initial, 0, sizeof(State));
+    for (size_t tid = 0; tid < kThreads; ++tid) {
+        initial.ip[tid] = kEntry[tid];
+        RunLocal(initial, tid);
+    }
+    std::unordered_set<State, StateHash> visited{initial};
+    std::vector<State> stack{initial};
+    std::vector<State> next;
+    size_t final_states = 0;
+    while (!stack.empty()) {
+        State state = stack.back();
+        stack.pop_back();
+        next.clear();
+        Expand(state, next);
+        if (next.empty()) {
+            ++final_states;
+            if (kHasFinalCondition) {
+                if (Evaluate(state) == kExists) {
+                    std::printf("%s: %s\n", kFinalCondition, kExists ? "witness found" : "counterexample found");
+                    std::printf("Final state: ");
+                    PrintOutcome(state);
+                    std::printf("Visited states: %zu\n", visited.size());
+                    return 0;
+                }
+            } else {
+                std::printf("Final state: ");
+                PrintOutcome(state);
+            }
+            continue;
+        }
+        for (const State& successor : next) {
+            if (visited.insert(successor).second) {
+                stack.push_back(successor);
+            }
+        }
+    }
+    std::printf("Visited states: %zu\n", visited.size());
+    std::printf("Final states: %zu\n", final_states);
+    if (kHasFinalCondition) {
+        std::printf("%s: %s\n", kFinalCondition, kExists ? "no reachable witness, the condition never holds" : "no reachable counterexample, the condition always holds");
+    }
+    return 0;
+}
+)";
+
+struct CheckerGenerator {
+    std::ostream& os;
+    const ProgramDescriptor& descriptor;
+    const std::vector<size_t>& instruction_pointers;
+    MemoryModel model;
+    Bytecode bytecode;
+
+    void Generate() {
+        os << "// Checker generated by wmm_emulator for " << GetMemoryModelName(model) << ", threads start at instructions";
+        for (size_t ip : instruction_pointers) {
+            os << ' ' << ip;
+        }
+        os << "\n// compile with -O3, prints every final state or the verdict of the final condition\n";
+        os << "#include <cstddef>\n#include <cstdint>\n#include <cstdio>\n#include <cstdlib>\n#include <cstring>\n";
+        os << "#include <unordered_set>\n#include <vector>\n\nnamespace {\n\n";
+        GenerateConstants();
+        GenerateState();
+        os << kCommonCode;
+        if (model == MemoryModel::SC) {
+            os << kScCode;
+        } else if (model == MemoryModel::TSO) {
+            os << kTsoCode;
+        } else {
+            os << kPsoCode;
+        }
+        GenerateFinalCondition();
+        GenerateRunLocal();
+        GenerateStep();
+        os << kExploreCode;
+    }
+
+    void GenerateConstants() {
+        os << "constexpr size_t kThreads = " << instruction_pointers.size() << ";\n";
+        // zero-sized arrays are not allowed, programs without registers get an unused one
+        os << "constexpr size_t kRegisters = " << std::max<size_t>(bytecode.registers_cnt, 1) << ";\n";
+        os << "constexpr size_t kMemory = " << std::max<size_t>(descriptor.memory_size, 1) << ";\n";
+        os << "constexpr uint64_t kEnd = " << bytecode.ops.size() << ";\n";
+        if (model != MemoryModel::SC) {
+            os << "constexpr size_t kBufferCapacity = " << GetBufferCapacity() << ";\n";
+        }
+        os << "constexpr uint64_t kEntry[kThreads] = {";
+        for (size_t tid = 0; tid < instruction_pointers.size(); ++tid) {
+            os << (tid > 0 ? ", " : "") << instruction_pointers[tid];
+        }
+        os << "};\n";
+        os << "const char* const kRegisterName[kRegisters] = {";
+        for (size_t reg = 0; reg < std::max<size_t>(bytecode.registers_cnt, 1); ++reg) {
+            os << (reg > 0 ? ", " : "") << Quote(reg < descriptor.register_name.size() ? descriptor.register_name[reg] : "unused");
+        }
+        os << "};\n";
+        os << "const char* const kCellName[kMemory] = {";
+        for (size_t cell = 0; cell < std::max<size_t>(descriptor.memory_size, 1); ++cell) {
+            os << (cell > 0 ? ", " : "") << Quote(cell < descriptor.memory_name.size() ? descriptor.memory_name[cell] : std::to_string(cell));
+        }
+        os << "};\n\n";
+    }
+
+    // a thread of a loop-free program can't have more pending writes than there are stores
+    size_t GetBufferCapacity() const {
+        size_t stores = 0;
+        for (size_t ip = 0; ip < bytecode.ops.size(); ++ip) {
+            auto& op = bytecode.ops[ip];
+            if (op.opcode == Opcode::JUMP_IF && op.target <= ip) {
+                return kDefaultBufferCapacity;
+            }
+            stores += op.opcode == Opcode::STORE;
+        }
+        return std::max<size_t>(stores, 1);
+    }
+
+    void GenerateState() {
+        os << "struct State {\n";
+        os << "    uint64_t ip[kThreads];\n";
+        os << "    uint64_t reg[kThreads][kRegisters];\n";
+        os << "    uint64_t mem[kMemory];\n";
+        if (model == MemoryModel::TSO) {
+            os << "    // pending writes of every thread, the oldest one first\n";
+            os << "    uint64_t buffer_size[kThreads];\n";
+            os << "    uint64_t buffer_cell[kThreads][kBufferCapacity];\n";
+            os << "    uint64_t buffer_value[kThreads][kBufferCapacity];\n";
+        } else if (model == MemoryModel::PSO) {
+            os << "    // pending writes of every thread to every cell, the oldest one first\n";
+            os << "    uint64_t buffer_size[kThreads][kMemory];\n";
+            os << "    uint64_t buffer_value[kThreads][kMemory][kBufferCapacity];\n";
+        }
+        os << "\n    bool operator==(const State& other) const {\n";
+        os << "        return std::memcmp(this, &other, sizeof(State)) == 0;\n";
+        os << "    }\n";
+        os << "};\n";
+    }
+
+    void GenerateFinalCondition() {
+        auto& final_condition = descriptor.final_condition;
+        os << "\nconstexpr bool kHasFinalCondition = " << (final_condition ? "true" : "false") << ";\n";
+        if (!final_condition) {
+            os << "constexpr bool kExists = true;\n";
+            os << "const char* const kFinalCondition = \"\";\n\n";
+            os << "bool Evaluate(const State&) {\n    return false;\n}\n";
+            return;
+        }
+        std::ostringstream text;
+        final_condition->Print(text, descriptor.memory_name, descriptor.register_name);
+        os << "constexpr bool kExists = " << (final_condition->quantifier == ConditionQuantifier::EXISTS ? "true" : "false") << ";\n";
+        os << "const char* const kFinalCondition = " << Quote(text.str()) << ";\n\n";
+        os << "bool Evaluate(const State& state) {\n";
+        os << "    return " << GetConditionCode(*final_condition, final_condition->root) << ";\n";
+        os << "}\n";
+    }
+
+    std::string GetConditionCode(const FinalCondition& condition, size_t node) const {
+        auto& condition_node = condition.nodes[node];
+        if (auto* atom = std::get_if<RegisterEquals>(&condition_node)) {
+            return "state.reg[" + std::to_string(atom->thread_id) + "][" + std::to_string(atom->reg) + "] == " + std::to_string(atom->value) + "ull";
+        } else if (auto* atom = std::get_if<MemoryEquals>(&condition_node)) {
+            return "state.mem[" + std::to_string(atom->cell) + "] == " + std::to_string(atom->value) + "ull";
+        } else if (auto* negation = std::get_if<Negation>(&condition_node)) {
+            return "!(" + GetConditionCode(condition, negation->operand) + ")";
+        } else if (auto* conjunction = std::get_if<Conjunction>(&condition_node)) {
+            return "(" + GetConditionCode(condition, conjunction->lhs) + " && " + GetConditionCode(condition, conjunction->rhs) + ")";
+        }
+        auto& disjunction = std::get<Disjunction>(condition_node);
+        return "(" + GetConditionCode(condition, disjunction.lhs) + " || " + GetConditionCode(condition, disjunction.rhs) + ")";
+    }
+
+    static std::string Reg(uint32_t slot) {
+        return "r[" + std::to_string(slot) + "]";
+    }
+
+    void GenerateCaseLabel(size_t ip) const {
+        os << "            case " << ip << ": // " << TrimInstruction(descriptor.instructions_str[ip]) << '\n';
+    }
+
+    void GenerateRunLocal() {
+        os << "\n// thread-local instructions up to the next memory access, the end of the program or a jump back\n";
+        os << "void RunLocal(State& state, size_t tid) {\n";
+        os << "    uint64_t* r = state.reg[tid];\n";
+        os << "    while (true) {\n";
+        os << "        switch (state.ip[tid]) {\n";
+        for (size_t ip = 0; ip < bytecode.ops.size(); ++ip) {
+            auto& op = bytecode.ops[ip];
+            if (!IsThreadLocal(op)) {
+                continue;
+            }
+            GenerateCaseLabel(ip);
+            if (op.opcode == Opcode::SET_CONSTANT) {
+                os << "                " << Reg(op.dst) << " = " << bytecode.constants[op.lhs] << "ull;\n";
+            } else if (op.opcode == Opcode::BIN_OP) {
+                os << "                " << Reg(op.dst) << " = " << GetBinOpCode(op.bin_op, Reg(op.lhs), Reg(op.rhs)) << ";\n";
+            } else if (op.target > ip) {
+                os << "                state.ip[tid] = " << Reg(op.lhs) << " != 0 ? " << op.target << " : " << ip + 1 << ";\n";
+                os << "                continue;\n";
+                continue;
+            } else {
+                // a jump back is a separate step, so that loops are cut by the visited states
+                os << "                if (" << Reg(op.lhs) << " != 0) {\n";
+                os << "                    return;\n";
+                os << "                }\n";
+            }
+            os << "                state.ip[tid] = " << ip + 1 << ";\n";
+            os << "                continue;\n";
+        }
+        os << "            default:\n";
+        os << "                return;\n";
+        os << "        }\n";
+        os << "    }\n";
+        os << "}\n";
+    }
+
+    void GenerateDrain() const {
+        if (model != MemoryModel::SC) {
+            os << "            Drain(state, tid);\n";
+        }
+    }
+
+    void GenerateStep() {
+        os << "\n// executes the memory access (or the jump back) the thread is at and the thread-local instructions after it\n";
+        os << "void Step(State& state, size_t tid) {\n";
+        os << "    uint64_t* r = state.reg[tid];\n";
+        os << "    switch (state.ip[tid]) {\n";
+        for (size_t ip = 0; ip < bytecode.ops.size(); ++ip) {
+            auto& op = bytecode.ops[ip];
+            bool jump_back = op.opcode == Opcode::JUMP_IF && op.target <= ip;
+            if (IsThreadLocal(op) && !jump_back) {
+                continue;
+            }
+            os << "        case " << ip << ": { // " << TrimInstruction(descriptor.instructions_str[ip]) << '\n';
+            std::string cell = "Cell(" + Reg(op.addr) + ")";
+            switch (op.opcode) {
+                case Opcode::CAS:
+                case Opcode::FETCH_OP:
+                    GenerateDrain();
+                    os << "            uint64_t& cell = state.mem[" << cell << "];\n";
+                    os << "            uint64_t old_value = cell;\n";
+                    GenerateRmw(op);
+                    os << "            " << Reg(op.dst) << " = old_value;\n";
+                    break;
+                case Opcode::LOAD:
+                    os << "            " << Reg(op.dst) << " = Read(state, tid, " << cell << ");\n";
+                    break;
+                case Opcode::STORE:
+                    os << "            Write(state, tid, " << cell << ", " << Reg(op.lhs) << ");\n";
+                    // a SEQ_CST write is followed by a fence
+                    if (op.mode == AccessMode::SEQ_CST) {
+                        GenerateDrain();
+                    }
+                    break;
+                case Opcode::FENCE:
+                    // fences with relaxed accesses are no-ops
+                    if (op.mode != AccessMode::RLX) {
+                        GenerateDrain();
+                    }
+                    break;
+                default:
+                    os << "            state.ip[tid] = " << Reg(op.lhs) << " != 0 ? " << op.target << " : " << ip + 1 << ";\n";
+                    os << "            break;\n";
+                    os << "        }\n";
+                    continue;
+            }
+            os << "            state.ip[tid] = " << ip + 1 << ";\n";
+            os << "            break;\n";
+            os << "        }\n";
+        }
+        os << "        default:\n";
+        os << "            Fail(\"Step of a thread that is not at a memory access\");\n";
+        os << "    }\n";
+        os << "    RunLocal(state, tid);\n";
+        os << "}\n";
+    }
+
+    void GenerateRmw(const BytecodeOp& op) const {
+        if (op.opcode == Opcode::CAS) {
+            os << "            if (cell == " << Reg(op.lhs) << ") {\n";
+            os << "                cell = " << Reg(op.rhs) << ";\n";
+            os << "            }\n";
+            return;
+        }
+        switch (op.rmw_kind) {
+            case RmwKind::FETCH_ADD:
+                os << "            cell += " << Reg(op.lhs) << ";\n";
+                break;
+            case RmwKind::EXCHANGE:
+                os << "            cell = " << Reg(op.lhs) << ";\n";
+                break;
+            case RmwKind::FETCH_OR:
+                os << "            cell |= " << Reg(op.lhs) << ";\n";
+                break;
+            default:
+                throw std::runtime_error{"Unknown read-modify-write operation"};
+        }
+    }
+};
+
+}  // namespace
+
+void GenerateChecker(std::ostream& os, const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, MemoryModel model) {
+    for (size_t ip : instruction_pointers) {
+        if (ip > descriptor.instructions.size()) {
+            throw std::runtime_error{"Instruction pointer " + std::to_string(ip) + " is out of the program"};
+        }
+    }
+    auto& final_condition = descriptor.final_condition;
+    if (final_condition && final_condition->GetMaxThreadId() >= instruction_pointers.size()) {
+        throw std::runtime_error{"Final condition refers to a thread that is not started"};
+    }
+    CheckerGenerator{os, descriptor, instruction_pointers, model, CompileBytecode(descriptor)}.Generate();
+}
@@ -0,0 +1,23 @@
+#ifndef CHECKER_GENERATOR_H
+#define CHECKER_GENERATOR_H
+#include "../axiomatic/consistency.h"
+#include "../common/program_descriptor.h"
+
+#include <ostream>
+#include <vector>
+
+/**
+ * Writes a standalone C++ program exploring the state space of the given program under SC, TSO or PSO, the
+ * same one as the `mc` mode does. Everything known before the exploration is baked into the source: the number
+ * of threads, registers and memory cells are constants, the state is a fixed-size struct of arrays (store buffers
+ * have a fixed capacity: the number of stores in the program when it has no loops), every instruction is a case
+ * of a switch over the instruction pointer with its registers, constants and model-specific memory accesses
+ * written out. Compiled with -O3 it becomes a dedicated checker printing every final state (or the verdict of
+ * the final condition) and the number of visited states.
+ *
+ * As in the `graph` mode, thread-local instructions are executed right after the memory access before them,
+ * only jumps back are separate steps, so the number of visited states is smaller than the one of `mc`.
+ */
+void GenerateChecker(std::ostream& os, const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, MemoryModel model);
+
+#endif //CHECKER_GENERATOR_H
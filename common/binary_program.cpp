@@ -0,0 +1,490 @@
+#include "binary_program.h"
+#include "../parser/parser.h"
+#include "../utility/mapped_file.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace {
+
+constexpr std::string_view kMagic = "WMMP";
+// magic, version, payload size, payload hash
+constexpr size_t kHeaderSize = kMagic.size() + 4 + 8 + 8;
+
+void AppendInt(std::string& data, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        data.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+uint64_t LoadInt(std::string_view data, size_t pos, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+    }
+    return value;
+}
+
+struct PayloadWriter {
+    std::string data;
+
+    void WriteByte(uint8_t value) {
+        data.push_back(static_cast<char>(value));
+    }
+
+    // LEB128: 7 bits per byte, the high bit is set in all bytes but the last one
+    void WriteInt(uint64_t value) {
+        while (value >= 0x80) {
+            data.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<char>(value));
+    }
+
+    void WriteString(std::string_view value) {
+        WriteInt(value.size());
+        data.append(value);
+    }
+
+    void WriteStrings(const std::vector<std::string>& values) {
+        WriteInt(values.size());
+        for (auto& value : values) {
+            WriteString(value);
+        }
+    }
+
+    void operator()(const CasInstruction& instruction) {
+        WriteByte(static_cast<uint8_t>(instruction.mode));
+        WriteInt(instruction.dst);
+        WriteInt(instruction.addr);
+        WriteInt(instruction.expected);
+        WriteInt(instruction.desired);
+    }
+    void operator()(const LoadInstruction& instruction) {
+        WriteByte(static_cast<uint8_t>(instruction.mode));
+        WriteInt(instruction.dst);
+        WriteInt(instruction.addr);
+    }
+    void operator()(const StoreInstruction& instruction) {
+        WriteByte(static_cast<uint8_t>(instruction.mode));
+        WriteInt(instruction.addr);
+        WriteInt(instruction.src);
+    }
+    void operator()(const FaiInstruction& instruction) {
+        WriteByte(static_cast<uint8_t>(instruction.mode));
+        WriteInt(instruction.dst);
+        WriteInt(instruction.addr);
+        WriteInt(instruction.increment);
+    }
+    void operator()(const FetchOpInstruction& instruction) {
+        WriteByte(static_cast<uint8_t>(instruction.mode));
+        WriteByte(static_cast<uint8_t>(instruction.kind));
+        WriteInt(instruction.dst);
+        WriteInt(instruction.addr);
+        WriteInt(instruction.operand);
+    }
+    void operator()(const FenceInstruction& instruction) {
+        WriteByte(static_cast<uint8_t>(instruction.mode));
+    }
+    void operator()(const RegisterConstantAssignment& instruction) {
+        WriteInt(instruction.dst);
+        WriteInt(instruction.value);
+    }
+    void operator()(const RegisterBinOpAssignment& instruction) {
+        WriteInt(instruction.dst);
+        WriteInt(instruction.lhs);
+        WriteInt(instruction.rhs);
+        WriteByte(static_cast<uint8_t>(instruction.op));
+    }
+    void operator()(const IfInstruction& instruction) {
+        WriteInt(instruction.cond);
+        WriteInt(instruction.instr_on_success);
+    }
+
+    void operator()(const RegisterEquals& node) {
+        WriteInt(node.thread_id);
+        WriteInt(node.reg);
+        WriteInt(node.value);
+    }
+    void operator()(const MemoryEquals& node) {
+        WriteInt(node.cell);
+        WriteInt(node.value);
+    }
+    void operator()(const Negation& node) {
+        WriteInt(node.operand);
+    }
+    void operator()(const Conjunction& node) {
+        WriteInt(node.lhs);
+        WriteInt(node.rhs);
+    }
+    void operator()(const Disjunction& node) {
+        WriteInt(node.lhs);
+        WriteInt(node.rhs);
+    }
+
+    void WriteInstructionText(const InstructionText& text) {
+        WriteStrings(text.GetSymbols());
+        WriteInt(text.GetTokens().size());
+        for (const SourceToken& token : text.GetTokens()) {
+            WriteByte(static_cast<uint8_t>(token.kind));
+            WriteInt(token.value);
+        }
+        WriteInt(text.GetInstructionBegin().size());
+        for (size_t begin : text.GetInstructionBegin()) {
+            WriteInt(begin);
+        }
+    }
+
+    void WriteDescriptor(const ProgramDescriptor& descriptor) {
+        WriteInt(descriptor.memory_size);
+        WriteStrings(descriptor.memory_name);
+        WriteStrings(descriptor.register_name);
+        WriteInt(descriptor.instructions.size());
+        for (auto& instruction : descriptor.instructions) {
+            WriteByte(static_cast<uint8_t>(instruction.index()));
+            std::visit(*this, instruction);
+        }
+        WriteInstructionText(descriptor.instructions_str);
+        WriteByte(descriptor.final_condition.has_value());
+        if (descriptor.final_condition) {
+            WriteByte(static_cast<uint8_t>(descriptor.final_condition->quantifier));
+            WriteInt(descriptor.final_condition->root);
+            WriteInt(descriptor.final_condition->nodes.size());
+            for (auto& node : descriptor.final_condition->nodes) {
+                WriteByte(static_cast<uint8_t>(node.index()));
+                std::visit(*this, node);
+            }
+        }
+    }
+};
+
+// everything read is checked against the rest of the program, the hash only detects accidental corruption
+struct PayloadReader {
+    std::string_view data;
+    size_t pos = 0;
+    // known once read, indices of registers, cells and instructions are checked against them
+    size_t memory_size = 0;
+    size_t registers_cnt = 0;
+    size_t instructions_cnt = 0;
+
+    void Require(size_t bytes) const {
+        if (data.size() - pos < bytes) {
+            throw std::runtime_error{"Compiled program is truncated"};
+        }
+    }
+
+    uint8_t ReadByte() {
+        Require(1);
+        return static_cast<uint8_t>(data[pos++]);
+    }
+
+    uint64_t ReadInt() {
+        uint64_t value = 0;
+        for (size_t shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = ReadByte();
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        throw std::runtime_error{"Compiled program has an invalid integer"};
+    }
+
+    // number of items that take at least `item_size` bytes each, checked before anything is allocated for them
+    size_t ReadCount(size_t item_size) {
+        uint64_t count = ReadInt();
+        if (count > (data.size() - pos) / item_size) {
+            throw std::runtime_error{"Compiled program is truncated"};
+        }
+        return count;
+    }
+
+    std::string ReadString() {
+        size_t size = ReadCount(1);
+        std::string value{data.substr(pos, size)};
+        pos += size;
+        return value;
+    }
+
+    std::vector<std::string> ReadStrings() {
+        std::vector<std::string> values(ReadCount(1));
+        for (auto& value : values) {
+            value = ReadString();
+        }
+        return values;
+    }
+
+    template <typename Enum>
+    Enum ReadEnum(Enum last) {
+        uint8_t value = ReadByte();
+        if (value > static_cast<uint8_t>(last)) {
+            throw std::runtime_error{"Compiled program has an invalid enum value"};
+        }
+        return static_cast<Enum>(value);
+    }
+
+    AccessMode ReadMode() {
+        return ReadEnum(AccessMode::SEQ_CST);
+    }
+
+    Register ReadRegister() {
+        uint64_t reg = ReadInt();
+        if (reg >= registers_cnt) {
+            throw std::runtime_error{"Compiled program has an invalid register"};
+        }
+        return reg;
+    }
+
+    Instruction ReadInstruction() {
+        switch (ReadByte()) {
+            case 0: {
+                AccessMode mode = ReadMode();
+                Register dst = ReadRegister();
+                Register addr = ReadRegister();
+                Register expected = ReadRegister();
+                return CasInstruction{mode, dst, addr, expected, ReadRegister()};
+            }
+            case 1: {
+                AccessMode mode = ReadMode();
+                Register dst = ReadRegister();
+                return LoadInstruction{mode, dst, ReadRegister()};
+            }
+            case 2: {
+                AccessMode mode = ReadMode();
+                Register addr = ReadRegister();
+                return StoreInstruction{mode, addr, ReadRegister()};
+            }
+            case 3: {
+                AccessMode mode = ReadMode();
+                Register dst = ReadRegister();
+                Register addr = ReadRegister();
+                return FaiInstruction{mode, dst, addr, ReadRegister()};
+            }
+            case 4: {
+                AccessMode mode = ReadMode();
+                RmwKind kind = ReadEnum(RmwKind::FETCH_OR);
+                Register dst = ReadRegister();
+                Register addr = ReadRegister();
+                return FetchOpInstruction{mode, kind, dst, addr, ReadRegister()};
+            }
+            case 5:
+                return FenceInstruction{ReadMode()};
+            case 6: {
+                Register dst = ReadRegister();
+                return RegisterConstantAssignment{dst, ReadInt()};
+            }
+            case 7: {
+                Register dst = ReadRegister();
+                Register lhs = ReadRegister();
+                Register rhs = ReadRegister();
+                return RegisterBinOpAssignment{dst, lhs, rhs, ReadEnum(BinOp::GREATER_EQUAL)};
+            }
+            case 8: {
+                Register cond = ReadRegister();
+                size_t target = ReadInt();
+                if (target > instructions_cnt) {
+                    throw std::runtime_error{"Compiled program has an invalid jump target"};
+                }
+                return IfInstruction{cond, target};
+            }
+            default:
+                throw std::runtime_error{"Compiled program has an unknown instruction"};
+        }
+    }
+
+    ConditionNode ReadConditionNode() {
+        switch (ReadByte()) {
+            case 0: {
+                // the thread is checked against the started ones when the program is explored
+                size_t thread_id = ReadInt();
+                Register reg = ReadInt();
+                if (reg >= registers_cnt) {
+                    throw std::runtime_error{"Compiled program has an invalid final condition"};
+                }
+                return RegisterEquals{thread_id, reg, ReadInt()};
+            }
+            case 1: {
+                MemoryCell cell = ReadInt();
+                if (cell >= memory_size) {
+                    throw std::runtime_error{"Compiled program has an invalid final condition"};
+                }
+                return MemoryEquals{cell, ReadInt()};
+            }
+            case 2:
+                return Negation{ReadInt()};
+            case 3: {
+                size_t lhs = ReadInt();
+                return Conjunction{lhs, ReadInt()};
+            }
+            case 4: {
+                size_t lhs = ReadInt();
+                return Disjunction{lhs, ReadInt()};
+            }
+            default:
+                throw std::runtime_error{"Compiled program has an unknown final condition node"};
+        }
+    }
+
+    InstructionText ReadInstructionText() {
+        std::vector<std::string> symbols = ReadStrings();
+        std::vector<SourceToken> tokens(ReadCount(2));
+        for (auto& token : tokens) {
+            token.kind = ReadEnum(SourceToken::Kind::COLON);
+            token.value = ReadInt();
+        }
+        for (auto& token : tokens) {
+            bool is_symbol = token.kind == SourceToken::Kind::SYMBOL || token.kind == SourceToken::Kind::TAGGED_SYMBOL;
+            if (is_symbol && token.value >= symbols.size()) {
+                throw std::runtime_error{"Compiled program has an invalid instruction text"};
+            }
+        }
+        // one more than the instructions: every instruction ends where the next one begins
+        std::vector<size_t> instruction_begin(ReadCount(1));
+        if (instruction_begin.size() != instructions_cnt + 1) {
+            throw std::runtime_error{"Compiled program has an invalid instruction text"};
+        }
+        size_t previous = 0;
+        for (auto& begin : instruction_begin) {
+            begin = ReadInt();
+            if (begin < previous || begin > tokens.size()) {
+                throw std::runtime_error{"Compiled program has an invalid instruction text"};
+            }
+            previous = begin;
+        }
+        if (instruction_begin.front() != 0 || instruction_begin.back() != tokens.size()) {
+            throw std::runtime_error{"Compiled program has an invalid instruction text"};
+        }
+        return {std::move(symbols), std::move(tokens), std::move(instruction_begin)};
+    }
+
+    std::optional<FinalCondition> ReadFinalCondition() {
+        if (ReadByte() == 0) {
+            return std::nullopt;
+        }
+        FinalCondition condition;
+        condition.quantifier = ReadEnum(ConditionQuantifier::FORALL);
+        condition.root = ReadInt();
+        condition.nodes.resize(ReadCount(2));
+        for (size_t node = 0; node < condition.nodes.size(); ++node) {
+            condition.nodes[node] = ReadConditionNode();
+            // operands precede their operations, so the condition can't have cycles
+            bool valid = std::visit([node] (const auto& cur) {
+                using Node = std::decay_t<decltype(cur)>;
+                if constexpr (std::is_same_v<Node, Negation>) {
+                    return cur.operand < node;
+                } else if constexpr (std::is_same_v<Node, Conjunction> || std::is_same_v<Node, Disjunction>) {
+                    return cur.lhs < node && cur.rhs < node;
+                } else {
+                    return true;
+                }
+            }, condition.nodes[node]);
+            if (!valid) {
+                throw std::runtime_error{"Compiled program has an invalid final condition"};
+            }
+        }
+        if (condition.root >= condition.nodes.size()) {
+            throw std::runtime_error{"Compiled program has an invalid final condition"};
+        }
+        return condition;
+    }
+
+    ProgramDescriptor ReadDescriptor() {
+        ProgramDescriptor descriptor;
+        descriptor.memory_size = memory_size = ReadInt();
+        descriptor.memory_name = ReadStrings();
+        if (descriptor.memory_name.size() > memory_size) {
+            throw std::runtime_error{"Compiled program has an invalid memory size"};
+        }
+        descriptor.register_name = ReadStrings();
+        registers_cnt = descriptor.register_name.size();
+        descriptor.instructions.resize(instructions_cnt = ReadCount(1));
+        for (auto& instruction : descriptor.instructions) {
+            instruction = ReadInstruction();
+        }
+        descriptor.instructions_str = ReadInstructionText();
+        descriptor.final_condition = ReadFinalCondition();
+        if (pos != data.size()) {
+            throw std::runtime_error{"Compiled program has trailing data"};
+        }
+        return descriptor;
+    }
+};
+
+std::string GetPayload(const ProgramDescriptor& descriptor) {
+    PayloadWriter writer;
+    writer.WriteDescriptor(descriptor);
+    return std::move(writer.data);
+}
+
+}  // namespace
+
+// FNV-1a over little-endian 64-bit words (the last one padded with zeros) instead of bytes
+uint64_t HashBytes(std::string_view bytes) {
+    uint64_t hash = 14695981039346656037ULL ^ bytes.size();
+    for (size_t pos = 0; pos < bytes.size(); pos += 8) {
+        hash ^= LoadInt(bytes, pos, std::min<size_t>(8, bytes.size() - pos));
+        hash *= 1099511628211ULL;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+void WriteBinaryProgram(std::ostream& os, const ProgramDescriptor& descriptor) {
+    std::string payload = GetPayload(descriptor);
+    std::string header{kMagic};
+    AppendInt(header, kBinaryProgramVersion, 4);
+    AppendInt(header, payload.size(), 8);
+    AppendInt(header, HashBytes(payload), 8);
+    os << header << payload;
+}
+
+ProgramDescriptor ReadBinaryProgram(std::string_view contents) {
+    if (!IsBinaryProgram(contents)) {
+        throw std::runtime_error{"Not a compiled program"};
+    }
+    if (contents.size() < kHeaderSize) {
+        throw std::runtime_error{"Compiled program is truncated"};
+    }
+    uint64_t version = LoadInt(contents, kMagic.size(), 4);
+    if (version != kBinaryProgramVersion) {
+        throw std::runtime_error{"Unsupported version of compiled program: " + std::to_string(version) + ", expected " + std::to_string(kBinaryProgramVersion)};
+    }
+    uint64_t payload_size = LoadInt(contents, kMagic.size() + 4, 8);
+    uint64_t hash = LoadInt(contents, kMagic.size() + 12, 8);
+    std::string_view payload = contents.substr(kHeaderSize);
+    if (payload.size() != payload_size) {
+        throw std::runtime_error{"Compiled program is truncated"};
+    }
+    if (HashBytes(payload) != hash) {
+        throw std::runtime_error{"Compiled program is corrupted, hash of its contents doesn't match"};
+    }
+    return PayloadReader{payload}.ReadDescriptor();
+}
+
+bool IsBinaryProgram(std::string_view contents) {
+    return contents.substr(0, kMagic.size()) == kMagic;
+}
+
+uint64_t GetProgramHash(const ProgramDescriptor& descriptor) {
+    return HashBytes(GetPayload(descriptor));
+}
+
+std::string FormatHash(uint64_t hash) {
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+    return buffer;
+}
+
+ProgramDescriptor LoadProgram(const std::string& path) {
+    MappedFile file{path};
+    if (IsBinaryProgram(file.GetContents())) {
+        return ReadBinaryProgram(file.GetContents());
+    }
+    return Parse(file.GetContents());
+}
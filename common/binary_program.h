@@ -0,0 +1,37 @@
+#ifndef BINARY_PROGRAM_H
+#define BINARY_PROGRAM_H
+#include "program_descriptor.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+/**
+ * Compiled form of a program: a header with the magic "WMMP", the version of the format, the size and the hash
+ * of the payload, then the payload holding everything the descriptor has (memory size, instructions, names,
+ * instruction text and the final condition) as LEB128 integers and length-prefixed strings. Reading it
+ * back only copies the fields, no tokenizing or symbol lookups are involved.
+ */
+inline constexpr uint32_t kBinaryProgramVersion = 1;
+
+void WriteBinaryProgram(std::ostream& os, const ProgramDescriptor& descriptor);
+
+// throws if the contents are not a compiled program of the current version or the payload doesn't match its hash
+ProgramDescriptor ReadBinaryProgram(std::string_view contents);
+
+bool IsBinaryProgram(std::string_view contents);
+
+// hash of the payload of the compiled program, equal programs have equal hashes
+uint64_t GetProgramHash(const ProgramDescriptor& descriptor);
+
+// hash of the payloads of compiled programs, also used to name cache entries
+uint64_t HashBytes(std::string_view bytes);
+
+// 16 hex digits, the form of hashes in cache entries and server responses
+std::string FormatHash(uint64_t hash);
+
+// maps the file and reads the program from it, compiled or in the text form
+ProgramDescriptor LoadProgram(const std::string& path);
+
+#endif //BINARY_PROGRAM_H
@@ -0,0 +1,109 @@
+#include "instruction_text.h"
+
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+
+InstructionText::InstructionText(std::vector<std::string> symbols, std::vector<SourceToken> tokens, std::vector<size_t> instruction_begin)
+    : symbols_(std::move(symbols))
+    , tokens_(std::move(tokens))
+    , instruction_begin_(std::move(instruction_begin)) {
+    if (instruction_begin_.empty() || instruction_begin_.front() != 0 || instruction_begin_.back() != tokens_.size()) {
+        throw std::runtime_error{"Inconsistent instruction text"};
+    }
+    for (size_t ip = 0; ip + 1 < instruction_begin_.size(); ++ip) {
+        if (instruction_begin_[ip] > instruction_begin_[ip + 1]) {
+            throw std::runtime_error{"Inconsistent instruction text"};
+        }
+    }
+    for (const SourceToken& token : tokens_) {
+        bool valid = token.kind <= SourceToken::Kind::COLON;
+        if (token.kind == SourceToken::Kind::KEYWORD) {
+            valid = token.value <= KeywordToken::FETCH_OR;
+        } else if (token.kind == SourceToken::Kind::BIN_OP) {
+            valid = token.value <= BinOp::GREATER_EQUAL;
+        } else if (token.kind == SourceToken::Kind::SYMBOL || token.kind == SourceToken::Kind::TAGGED_SYMBOL) {
+            valid = token.value < symbols_.size();
+        }
+        if (!valid) {
+            throw std::runtime_error{"Inconsistent instruction text"};
+        }
+    }
+}
+
+size_t InstructionText::size() const {
+    return instruction_begin_.size() - 1;
+}
+
+std::string InstructionText::operator[](size_t ip) const {
+    assert(ip < size());
+    std::string text;
+    for (size_t i = instruction_begin_[ip]; i < instruction_begin_[ip + 1]; ++i) {
+        const SourceToken& token = tokens_[i];
+        switch (token.kind) {
+            case SourceToken::Kind::KEYWORD:
+                text += KeywordToString(static_cast<KeywordToken>(token.value));
+                break;
+            case SourceToken::Kind::BIN_OP:
+                text += BinOpToString(static_cast<BinOp>(token.value));
+                break;
+            case SourceToken::Kind::SYMBOL:
+                text += symbols_[token.value];
+                break;
+            case SourceToken::Kind::TAGGED_SYMBOL:
+                text += '#';
+                text += symbols_[token.value];
+                break;
+            case SourceToken::Kind::CONSTANT:
+                text += std::to_string(token.value);
+                break;
+            case SourceToken::Kind::ASSIGNMENT:
+                text += ":=";
+                break;
+            case SourceToken::Kind::THREAD_LOCAL_ASSIGNMENT:
+                text += '=';
+                break;
+            case SourceToken::Kind::COLON:
+                text += ':';
+                break;
+        }
+        text += ' ';
+    }
+    return text;
+}
+
+uint32_t InstructionText::AddSymbol(std::string_view name) {
+    symbols_.emplace_back(name);
+    return static_cast<uint32_t>(symbols_.size() - 1);
+}
+
+void InstructionText::AddToken(SourceToken token) {
+    tokens_.push_back(token);
+}
+
+void InstructionText::EndInstruction() {
+    instruction_begin_.push_back(tokens_.size());
+}
+
+void InstructionText::AppendInstruction(const InstructionText& other, size_t ip) {
+    assert(ip < other.size());
+    tokens_.insert(tokens_.end(), other.tokens_.begin() + other.instruction_begin_[ip], other.tokens_.begin() + other.instruction_begin_[ip + 1]);
+    EndInstruction();
+}
+
+void InstructionText::ClearInstructions() {
+    tokens_.clear();
+    instruction_begin_.assign(1, 0);
+}
+
+const std::vector<std::string>& InstructionText::GetSymbols() const {
+    return symbols_;
+}
+
+const std::vector<SourceToken>& InstructionText::GetTokens() const {
+    return tokens_;
+}
+
+const std::vector<size_t>& InstructionText::GetInstructionBegin() const {
+    return instruction_begin_;
+}
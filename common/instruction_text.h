@@ -0,0 +1,62 @@
+#ifndef INSTRUCTION_TEXT_H
+#define INSTRUCTION_TEXT_H
+#include "../parser/tokenizer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// token of an instruction as it is written in the program, symbols are ids in the symbol table of InstructionText
+struct SourceToken {
+    enum class Kind : uint8_t {
+        KEYWORD, BIN_OP, SYMBOL, TAGGED_SYMBOL, CONSTANT, ASSIGNMENT, THREAD_LOCAL_ASSIGNMENT, COLON
+    };
+
+    Kind kind;
+    // KeywordToken, BinOp, symbol id or constant
+    uint64_t value = 0;
+};
+
+/**
+ * Source form of the program's instructions, only needed for printing. Tokens of all instructions are stored
+ * one after another in a single array and every symbol once, an instruction is rendered to a string when it is
+ * printed: tokens (labels included) separated by spaces, e.g. "end : r = 1 ".
+ */
+class InstructionText {
+public:
+    InstructionText() = default;
+    // e.g. a text read back from a compiled program, the parts are the ones returned by the getters below
+    InstructionText(std::vector<std::string> symbols, std::vector<SourceToken> tokens, std::vector<size_t> instruction_begin);
+
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] std::string operator[](size_t ip) const;
+
+    // symbols get consecutive ids in the order they are added
+    uint32_t AddSymbol(std::string_view name);
+
+    void AddToken(SourceToken token);
+
+    // tokens added after the previous instruction form a new one
+    void EndInstruction();
+
+    // copies an instruction of a text with the same symbols, e.g. of a copy of this one
+    void AppendInstruction(const InstructionText& other, size_t ip);
+
+    // drops the instructions, symbols are kept
+    void ClearInstructions();
+
+    [[nodiscard]] const std::vector<std::string>& GetSymbols() const;
+    [[nodiscard]] const std::vector<SourceToken>& GetTokens() const;
+    [[nodiscard]] const std::vector<size_t>& GetInstructionBegin() const;
+
+private:
+    std::vector<std::string> symbols_;
+    std::vector<SourceToken> tokens_;
+    // tokens of instruction `ip` are [instruction_begin_[ip], instruction_begin_[ip + 1])
+    std::vector<size_t> instruction_begin_{0};
+};
+
+#endif //INSTRUCTION_TEXT_H
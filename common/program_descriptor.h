@@ -1,16 +1,20 @@
 #ifndef PROGRAM_DESCRIPTOR_H
 #define PROGRAM_DESCRIPTOR_H
 #include "../instruction/instruction.h"
+#include "../condition/final_condition.h"
+#include "instruction_text.h"
 #include <cstddef>
+#include <optional>
 #include <vector>
 #include <unordered_map>
 
 struct ProgramDescriptor {
     size_t memory_size;
     std::vector<Instruction> instructions;
-    std::vector<std::string> instructions_str;
+    InstructionText instructions_str;
     std::vector<std::string> memory_name;
     std::vector<std::string> register_name;
+    std::optional<FinalCondition> final_condition;
 };
 
 #endif //PROGRAM_DESCRIPTOR_H
\ No newline at end of file
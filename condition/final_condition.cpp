@@ -0,0 +1,98 @@
+#include "final_condition.h"
+
+#include <algorithm>
+
+namespace {
+
+struct NodeEvaluator {
+    const FinalCondition& condition;
+    const Outcome& outcome;
+
+    bool Evaluate(size_t node) const {
+        return std::visit(*this, condition.nodes[node]);
+    }
+
+    bool operator()(const RegisterEquals& atom) const {
+        return outcome.registers[atom.thread_id][atom.reg] == atom.value;
+    }
+    bool operator()(const MemoryEquals& atom) const {
+        return outcome.memory[atom.cell] == atom.value;
+    }
+    bool operator()(const Negation& negation) const {
+        return !Evaluate(negation.operand);
+    }
+    bool operator()(const Conjunction& conjunction) const {
+        return Evaluate(conjunction.lhs) && Evaluate(conjunction.rhs);
+    }
+    bool operator()(const Disjunction& disjunction) const {
+        return Evaluate(disjunction.lhs) || Evaluate(disjunction.rhs);
+    }
+};
+
+struct NodePrinter {
+    const FinalCondition& condition;
+    std::ostream& os;
+    const std::vector<std::string>& memory_name;
+    const std::vector<std::string>& register_name;
+
+    void Print(size_t node) const {
+        std::visit(*this, condition.nodes[node]);
+    }
+
+    void operator()(const RegisterEquals& atom) const {
+        os << atom.thread_id << ':' << register_name[atom.reg] << '=' << atom.value;
+    }
+    void operator()(const MemoryEquals& atom) const {
+        os << memory_name[atom.cell] << '=' << atom.value;
+    }
+    void operator()(const Negation& negation) const {
+        os << '~';
+        Print(negation.operand);
+    }
+    void operator()(const Conjunction& conjunction) const {
+        os << '(';
+        Print(conjunction.lhs);
+        os << " /\\ ";
+        Print(conjunction.rhs);
+        os << ')';
+    }
+    void operator()(const Disjunction& disjunction) const {
+        os << '(';
+        Print(disjunction.lhs);
+        os << " \\/ ";
+        Print(disjunction.rhs);
+        os << ')';
+    }
+};
+
+}  // namespace
+
+bool FinalCondition::Evaluate(const Outcome& outcome) const {
+    return NodeEvaluator{*this, outcome}.Evaluate(root);
+}
+
+bool FinalCondition::IsTarget(const Outcome& outcome) const {
+    return Evaluate(outcome) == (quantifier == ConditionQuantifier::EXISTS);
+}
+
+size_t FinalCondition::GetMaxThreadId() const {
+    size_t max_thread_id = 0;
+    for (auto& node : nodes) {
+        if (auto atom = std::get_if<RegisterEquals>(&node)) {
+            max_thread_id = std::max(max_thread_id, atom->thread_id);
+        }
+    }
+    return max_thread_id;
+}
+
+void FinalCondition::Print(std::ostream& os, const std::vector<std::string>& memory_name, const std::vector<std::string>& register_name) const {
+    os << (quantifier == ConditionQuantifier::EXISTS ? "exists " : "forall ");
+    bool is_atom = std::holds_alternative<RegisterEquals>(nodes[root]) || std::holds_alternative<MemoryEquals>(nodes[root]);
+    if (is_atom) {
+        os << '(';
+    }
+    NodePrinter{*this, os, memory_name, register_name}.Print(root);
+    if (is_atom) {
+        os << ')';
+    }
+}
@@ -0,0 +1,67 @@
+#ifndef FINAL_CONDITION_H
+#define FINAL_CONDITION_H
+#include "outcome.h"
+#include "../common/memory_primitives.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <variant>
+#include <vector>
+
+enum class ConditionQuantifier {
+    EXISTS, FORALL
+};
+
+// "tid:reg = value"
+struct RegisterEquals {
+    size_t thread_id;
+    Register reg;
+    uint64_t value;
+};
+
+// "cell = value"
+struct MemoryEquals {
+    MemoryCell cell;
+    uint64_t value;
+};
+
+// operands are indices of other nodes in FinalCondition::nodes
+struct Negation {
+    size_t operand;
+};
+
+struct Conjunction {
+    size_t lhs;
+    size_t rhs;
+};
+
+struct Disjunction {
+    size_t lhs;
+    size_t rhs;
+};
+
+using ConditionNode = std::variant<RegisterEquals, MemoryEquals, Negation, Conjunction, Disjunction>;
+
+/**
+ * Litmus-style predicate over the final state of the program, e.g. "exists (0:a = 0 /\ 1:b = 0)".
+ * Exploration looks for a target state: the one satisfying the predicate for "exists" (witness)
+ * or violating it for "forall" (counterexample).
+ */
+struct FinalCondition {
+    ConditionQuantifier quantifier;
+    std::vector<ConditionNode> nodes;
+    size_t root;
+
+    [[nodiscard]] bool Evaluate(const Outcome& outcome) const;
+
+    // true if the outcome is a witness (for "exists") or a counterexample (for "forall")
+    [[nodiscard]] bool IsTarget(const Outcome& outcome) const;
+
+    [[nodiscard]] size_t GetMaxThreadId() const;
+
+    void Print(std::ostream& os, const std::vector<std::string>& memory_name, const std::vector<std::string>& register_name) const;
+};
+
+#endif //FINAL_CONDITION_H
@@ -0,0 +1,25 @@
+#ifndef OUTCOME_H
+#define OUTCOME_H
+#include "../common/memory_primitives.h"
+
+#include <cstdint>
+#include <vector>
+
+// observable result of a terminated execution: final values of every thread's registers and of the main memory
+struct Outcome {
+    std::vector<std::vector<uint64_t>> registers;
+    std::vector<uint64_t> memory;
+
+    bool operator==(const Outcome& other) const {
+        return registers == other.registers && memory == other.memory;
+    }
+
+    bool operator<(const Outcome& other) const {
+        if (registers != other.registers) {
+            return registers < other.registers;
+        }
+        return memory < other.memory;
+    }
+};
+
+#endif //OUTCOME_H
@@ -0,0 +1,154 @@
+#include "best_first_executor.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+// distance of an atom that can't change anymore in the current state
+constexpr size_t kUnreachable = 1 << 16;
+
+/**
+ * Estimates how many steps are needed to make a node of the final condition evaluate to `wanted`:
+ * 0 for already matching atoms, 1 for memory atoms that a buffered write can still produce and
+ * registers of running threads, conjunctions sum up their operands, disjunctions take the minimum
+ */
+struct DistanceEstimator {
+    const FinalCondition& condition;
+    const ControllableExecutor& state;
+    const std::vector<uint64_t>& memory;
+
+    // NOLINTNEXTLINE
+    size_t Estimate(size_t node, bool wanted) const {
+        return std::visit([this, wanted](const auto& n) { return Estimate(n, wanted); }, condition.nodes[node]);
+    }
+
+    size_t Estimate(const RegisterEquals& atom, bool wanted) const {
+        if ((state.GetRegisterValue(atom.thread_id, atom.reg) == atom.value) == wanted) {
+            return 0;
+        }
+        return state.IsThreadCompleted(atom.thread_id) ? kUnreachable : 1;
+    }
+    size_t Estimate(const MemoryEquals& atom, bool wanted) const {
+        if ((memory[atom.cell] == atom.value) == wanted) {
+            return 0;
+        }
+        if (wanted) {
+            return state.HasPendingWrite(atom.cell, atom.value) ? 1 : 2;
+        }
+        return 1;
+    }
+    size_t Estimate(const Negation& negation, bool wanted) const {
+        return Estimate(negation.operand, !wanted);
+    }
+    size_t Estimate(const Conjunction& conjunction, bool wanted) const {
+        if (wanted) {
+            return Estimate(conjunction.lhs, true) + Estimate(conjunction.rhs, true);
+        }
+        return std::min(Estimate(conjunction.lhs, false), Estimate(conjunction.rhs, false));
+    }
+    size_t Estimate(const Disjunction& disjunction, bool wanted) const {
+        if (wanted) {
+            return std::min(Estimate(disjunction.lhs, true), Estimate(disjunction.rhs, true));
+        }
+        return Estimate(disjunction.lhs, false) + Estimate(disjunction.rhs, false);
+    }
+};
+
+constexpr size_t kNoParent = std::numeric_limits<size_t>::max();
+
+}  // namespace
+
+bool BestFirstExecutor::FrontierEntry::operator<(const FrontierEntry& other) const {
+    // std::priority_queue pops the greatest element: prefer smaller distance, then deeper states
+    if (distance != other.distance) {
+        return distance > other.distance;
+    }
+    return depth < other.depth;
+}
+
+BestFirstExecutor::BestFirstExecutor(ControllableExecutor controllable_executor, const ProgramDescriptor& descriptor, bool tracing_on)
+    : UserExecutor(std::move(controllable_executor), descriptor, tracing_on) {
+    if (!descriptor.final_condition) {
+        throw std::runtime_error{"Best-first search requires a final condition to direct the search"};
+    }
+    Push(this->controllable_executor.Clone(), kNoParent, 0, 0);
+}
+
+size_t BestFirstExecutor::EstimateDistance(const ControllableExecutor& state) const {
+    auto& final_condition = *GetFinalCondition();
+    auto memory = state.GetOutcome().memory;
+    DistanceEstimator estimator{final_condition, state, memory};
+    return estimator.Estimate(final_condition.root, final_condition.quantifier == ConditionQuantifier::EXISTS);
+}
+
+void BestFirstExecutor::Push(ControllableExecutor state, size_t parent, size_t selection, size_t depth) {
+    if (!visited_.insert(state.GetStateKey()).second) {
+        return;
+    }
+    nodes_.push_back(SearchNode{parent, selection});
+    size_t distance = EstimateDistance(state);
+    frontier_.push(FrontierEntry{distance, depth, nodes_.size() - 1, std::make_shared<ControllableExecutor>(std::move(state))});
+}
+
+std::vector<size_t> BestFirstExecutor::RestoreTrace(size_t node) const {
+    std::vector<size_t> trace;
+    for (; nodes_[node].parent != kNoParent; node = nodes_[node].parent) {
+        trace.push_back(nodes_[node].selection);
+    }
+    std::reverse(trace.begin(), trace.end());
+    return trace;
+}
+
+bool BestFirstExecutor::IsDone() const {
+    return context->target_found || frontier_.empty();
+}
+
+// states are chosen by the frontier order in ExecuteNext
+size_t BestFirstExecutor::Select() const {
+    return 0;
+}
+
+void BestFirstExecutor::ExecuteNext() {
+    FrontierEntry entry = frontier_.top();
+    frontier_.pop();
+    ControllableExecutor& state = *entry.state;
+    if (tracing_on) {
+        state.PrintSystemSnapshot(std::cout);
+    }
+    if (state.IsTerminal()) {
+        if (GetFinalCondition()->IsTarget(state.GetOutcome())) {
+            context->trace = RestoreTrace(entry.node);
+            controllable_executor = std::move(state);
+            CheckFinalCondition();
+        }
+        return;
+    }
+    // with no transitions left the state is not final: every running thread waits in a spin loop forever
+    auto running_threads = state.GetThreadsNextPossibleSteps();
+    auto eps_transitions = state.GetPropagateTransitions();
+    for (size_t selection = 0; selection < running_threads.size() + eps_transitions.size(); ++selection) {
+        auto copy = state.Clone();
+        copy.SelectTransition(selection, running_threads, eps_transitions);
+        Push(std::move(copy), entry.node, selection, entry.depth + 1);
+    }
+}
+
+void BestFirstExecutor::PrintVerdict() const {
+    UserExecutor::PrintVerdict();
+    std::cout << "Visited states: " << visited_.size() << '\n';
+}
+
+std::unique_ptr<UserExecutor> CreateBestFirstExecutor(
+        MemorySubsystemPtr memory_subsystem,
+        const ProgramDescriptor& descriptor,
+        const std::vector<size_t>& instruction_pointers,
+        bool tracing_on,
+        const ExplorationOptions& options
+) {
+    ExplorationOptions verdict_options = options;
+    verdict_options.verdict_only = true;
+    ControllableExecutor controllable_executor = CreateControllableExecutor(std::move(memory_subsystem), descriptor, instruction_pointers, verdict_options);
+    return std::make_unique<BestFirstExecutor>(std::move(controllable_executor), descriptor, tracing_on);
+}
@@ -0,0 +1,53 @@
+#ifndef BEST_FIRST_EXECUTOR_H
+#define BEST_FIRST_EXECUTOR_H
+#include "user_executor.h"
+
+#include <queue>
+#include <unordered_set>
+
+/**
+ * Directed search for a witness/counterexample of the final condition.
+ * States are kept in a priority queue ordered by an estimated distance to the target outcome,
+ * already visited states are skipped.
+ */
+struct BestFirstExecutor : UserExecutor {
+    BestFirstExecutor(ControllableExecutor controllable_executor, const ProgramDescriptor& descriptor, bool tracing_on);
+
+    bool IsDone() const override;
+    size_t Select() const override;
+    void ExecuteNext() override;
+    void PrintVerdict() const override;
+
+private:
+    struct SearchNode {
+        size_t parent;
+        size_t selection;
+    };
+
+    struct FrontierEntry {
+        size_t distance;
+        size_t depth;
+        size_t node;
+        std::shared_ptr<ControllableExecutor> state;
+
+        bool operator<(const FrontierEntry& other) const;
+    };
+
+    size_t EstimateDistance(const ControllableExecutor& state) const;
+    void Push(ControllableExecutor state, size_t parent, size_t selection, size_t depth);
+    std::vector<size_t> RestoreTrace(size_t node) const;
+
+    std::vector<SearchNode> nodes_;
+    std::priority_queue<FrontierEntry> frontier_;
+    std::unordered_set<StateKey, StateKeyHash> visited_;
+};
+
+std::unique_ptr<UserExecutor> CreateBestFirstExecutor(
+        MemorySubsystemPtr memory_subsystem,
+        const ProgramDescriptor& descriptor,
+        const std::vector<size_t>& instruction_pointers,
+        bool tracing_on,
+        const ExplorationOptions& options = {}
+);
+
+#endif //BEST_FIRST_EXECUTOR_H
@@ -1,102 +1,29 @@
 #include "controllable_executor.h"
 #include "../memory_subsystem/memory_subsystem.h"
 
+#include <algorithm>
 #include <iostream>
 
-struct InstructionExecutor {
-    size_t thread_id;
-    ControllableExecutor* executor;
+void ControllableExecutor::MakePropagateStep(const std::unique_ptr<PropagateDescription>& propagate_description) {
+    memory_subsystem_->MakePropagation(propagate_description);
+    PropagatePrivateWrites();
+}
 
-    void operator()(const CasInstruction& instruction) {
-        Thread& cur_thread = executor->thread_subsystem_[thread_id];
-        MemoryTransitionLabel mtl = GetTransitionLabelByInstruction(instruction, cur_thread.GetRegisters());
-        auto value = executor->memory_subsystem_->MakeRmwTransition(thread_id, std::get<RmwLabel>(mtl));
-        cur_thread.SetLocalValue(instruction.dst, value);
-        cur_thread.AdvanceInstructionPointer();
-    }
-    void operator()(const FaiInstruction& instruction) {
-        Thread& cur_thread = executor->thread_subsystem_[thread_id];
-        MemoryTransitionLabel mtl = GetTransitionLabelByInstruction(instruction, cur_thread.GetRegisters());
-        auto value = executor->memory_subsystem_->MakeRmwTransition(thread_id, std::get<RmwLabel>(mtl));
-        cur_thread.SetLocalValue(instruction.dst, value);
-        cur_thread.AdvanceInstructionPointer();
-    }
-    void operator()(const LoadInstruction& instruction) {
-        Thread& cur_thread = executor->thread_subsystem_[thread_id];
-        MemoryTransitionLabel mtl = GetTransitionLabelByInstruction(instruction, cur_thread.GetRegisters());
-        auto value = executor->memory_subsystem_->MakeReadTransition(thread_id, std::get<ReadLabel>(mtl));
-        cur_thread.SetLocalValue(instruction.dst, value);
-        cur_thread.AdvanceInstructionPointer();
-    }
-    void operator()(const StoreInstruction& instruction) {
-        Thread& cur_thread = executor->thread_subsystem_[thread_id];
-        MemoryTransitionLabel mtl = GetTransitionLabelByInstruction(instruction, cur_thread.GetRegisters());
-        executor->memory_subsystem_->MakeWriteTransition(thread_id, std::get<WriteLabel>(mtl));
-        cur_thread.AdvanceInstructionPointer();
-    }
-    void operator()(const FenceInstruction& instruction) {
-        Thread& cur_thread = executor->thread_subsystem_[thread_id];
-        MemoryTransitionLabel mtl = GetTransitionLabelByInstruction(instruction, cur_thread.GetRegisters());
-        executor->memory_subsystem_->MakeFenceTransition(thread_id, std::get<FenceLabel>(mtl));
-        cur_thread.AdvanceInstructionPointer();
-    }
-    void operator()(const RegisterConstantAssignment& instruction) {
-        Thread& cur_thread = executor->thread_subsystem_[thread_id];
-        cur_thread.SetLocalValue(instruction.dst, instruction.value);
-        cur_thread.AdvanceInstructionPointer();
+void ControllableExecutor::PropagatePrivateWrites() {
+    if (!analysis_->shared_access) {
+        return;
     }
-    void operator()(const RegisterBinOpAssignment& instruction) {
-        Thread &cur_thread = executor->thread_subsystem_[thread_id];
-        uint64_t lhs_value = cur_thread.GetLocalValue(instruction.lhs);
-        uint64_t rhs_value = cur_thread.GetLocalValue(instruction.rhs);
-        uint64_t res_value;
-        switch (instruction.op) {
-            case ADD:
-                res_value = lhs_value + rhs_value;
-                break;
-            case SUBTRACT:
-                res_value = lhs_value - rhs_value;
-                break;
-            case DIVIDE:
-                if (rhs_value == 0) {
-                    throw std::runtime_error{"Division by zero is not allowed"};
-                }
-                res_value = lhs_value / rhs_value;
-                break;
-            case MULTIPLY:
-                res_value = lhs_value * rhs_value;
-                break;
-            case LESS:
-                res_value = lhs_value < rhs_value;
-                break;
-            case GREATER:
-                res_value = lhs_value > rhs_value;
-                break;
-            case LESS_EQUAL:
-                res_value = lhs_value <= rhs_value;
+    bool propagated = true;
+    while (propagated) {
+        propagated = false;
+        for (auto& propagation : memory_subsystem_->GetAvailablePropagations()) {
+            if (analysis_->shared_access->IsPrivate(propagation->GetMemoryCell())) {
+                memory_subsystem_->MakePropagation(propagation);
+                propagated = true;
                 break;
-            case GREATER_EQUAL:
-                res_value = lhs_value >= rhs_value;
-                break;
-            default:
-                assert(false);
-        }
-        cur_thread.SetLocalValue(instruction.dst, res_value);
-        cur_thread.AdvanceInstructionPointer();
-    }
-    void operator()(const IfInstruction& instruction) {
-        Thread& cur_thread = executor->thread_subsystem_[thread_id];
-        uint64_t cond_value = cur_thread.GetLocalValue(instruction.cond);
-        if (cond_value == 0) {
-            cur_thread.AdvanceInstructionPointer();
-        } else {
-            cur_thread.MoveInstructionPointer(instruction.instr_on_success);
+            }
         }
     }
-};
-
-void ControllableExecutor::MakePropagateStep(const std::unique_ptr<PropagateDescription>& propagate_description) {
-    memory_subsystem_->MakePropagation(propagate_description);
 }
 
 std::vector<std::unique_ptr<PropagateDescription>> ControllableExecutor::GetPropagateTransitions() const {
@@ -104,11 +31,58 @@ std::vector<std::unique_ptr<PropagateDescription>> ControllableExecutor::GetProp
 }
 
 void ControllableExecutor::MakeThreadStep(size_t tid) {
-    std::visit(InstructionExecutor{tid, this}, thread_subsystem_[tid].GetNextInstruction());
+    ExecuteThreadStep(*bytecode_, thread_subsystem_[tid], *memory_subsystem_, tid);
+    if (thread_subsystem_[tid].IsCompleted()) {
+        memory_subsystem_->MarkThreadCompleted(tid);
+    }
+    PropagatePrivateWrites();
 }
 
 std::vector<size_t> ControllableExecutor::GetThreadsNextPossibleSteps() const {
-    return thread_subsystem_.GetRunningThreads();
+    auto running_threads = thread_subsystem_.GetRunningThreads();
+    if (analysis_->spin_loops) {
+        running_threads.erase(std::remove_if(running_threads.begin(), running_threads.end(), [this] (size_t tid) {
+            return IsThreadBlocked(tid);
+        }), running_threads.end());
+    }
+    return running_threads;
+}
+
+bool ControllableExecutor::IsThreadBlocked(size_t thread_id) const {
+    const Thread& thread = thread_subsystem_[thread_id];
+    if (!analysis_->spin_loops || thread.IsCompleted()) {
+        return false;
+    }
+    auto& spin_loop = analysis_->spin_loops->loop_by_head[thread.GetInstructionPointer()];
+    if (!spin_loop || !spin_loop->single_load) {
+        return false;
+    }
+    // dry run of a single iteration, the body only loads and computes registers
+    std::vector<uint64_t> registers = thread.GetRegisters().GetValues();
+    size_t ip = spin_loop->head;
+    while (ip >= spin_loop->head && ip <= spin_loop->back_edge) {
+        const Instruction& instruction = thread.GetInstruction(ip);
+        if (auto load = std::get_if<LoadInstruction>(&instruction)) {
+            registers[load->dst] = memory_subsystem_->GetVisibleValue(thread_id, registers[load->addr]);
+        } else if (auto assignment = std::get_if<RegisterConstantAssignment>(&instruction)) {
+            registers[assignment->dst] = assignment->value;
+        } else if (auto bin_op = std::get_if<RegisterBinOpAssignment>(&instruction)) {
+            if (bin_op->op == DIVIDE && registers[bin_op->rhs] == 0) {
+                return false; // let the actual step report the error
+            }
+            registers[bin_op->dst] = EvaluateBinOp(bin_op->op, registers[bin_op->lhs], registers[bin_op->rhs]);
+        } else if (auto if_instruction = std::get_if<IfInstruction>(&instruction)) {
+            if (registers[if_instruction->cond] != 0) {
+                if (ip == spin_loop->back_edge) {
+                    return true;
+                }
+                ip = if_instruction->instr_on_success;
+                continue;
+            }
+        }
+        ++ip;
+    }
+    return false;
 }
 
 void ControllableExecutor::SelectTransition(
@@ -134,23 +108,107 @@ void ControllableExecutor::PrintSystemSnapshot(std::ostream& os, size_t indent)
     os << '\n';
 }
 
-ControllableExecutor ControllableExecutor::Clone() const {
-    return ControllableExecutor{thread_subsystem_, memory_subsystem_->Clone()};
+void ControllableExecutor::PrintTrace(std::ostream& os, const std::vector<size_t>& trace, size_t indent) const {
+    ControllableExecutor replay = Clone();
+    for (size_t selection : trace) {
+        auto running_threads = replay.GetThreadsNextPossibleSteps();
+        auto eps_transitions = replay.GetPropagateTransitions();
+        if (selection < running_threads.size()) {
+            size_t tid = running_threads[selection];
+            auto label = GetTransitionLabelByInstruction(replay.thread_subsystem_[tid].GetNextInstruction(), replay.thread_subsystem_[tid].GetRegisters());
+            if (!std::holds_alternative<EpsilonLabel>(label)) {
+                os << Indent{indent} << "thread#" << tid << ": ";
+                replay.PrintInstruction(os, tid, 0);
+            }
+        } else {
+            eps_transitions[selection - running_threads.size()]->Print(os, indent);
+        }
+        replay.SelectTransition(selection, running_threads, eps_transitions);
+    }
 }
 
-ControllableExecutor::ControllableExecutor(ThreadSubsystem thread_subsystem, const MemorySubsystemPtr& memory_ptr)
-    : thread_subsystem_(std::move(thread_subsystem))
-    , memory_subsystem_(memory_ptr->Clone()) {
+bool ControllableExecutor::IsTerminal() const {
+    return thread_subsystem_.IsCompleted() && memory_subsystem_->GetAvailablePropagations().empty();
+}
+
+size_t ControllableExecutor::GetThreadsCount() const {
+    return thread_subsystem_.threads.size();
+}
+
+Outcome ControllableExecutor::GetOutcome() const {
+    Outcome outcome;
+    for (auto& thread : thread_subsystem_.threads) {
+        outcome.registers.push_back(thread.GetRegisters().GetValues());
+    }
+    outcome.memory = memory_subsystem_->GetMainMemory();
+    return outcome;
+}
+
+uint64_t ControllableExecutor::GetRegisterValue(size_t thread_id, Register reg) const {
+    return thread_subsystem_[thread_id].GetLocalValue(reg);
+}
+
+bool ControllableExecutor::IsThreadCompleted(size_t thread_id) const {
+    return thread_subsystem_[thread_id].IsCompleted();
+}
+
+bool ControllableExecutor::HasPendingWrite(MemoryCell cell, uint64_t value) const {
+    return memory_subsystem_->HasPendingWrite(cell, value);
+}
+
+StateKey ControllableExecutor::GetStateKey() const {
+    StateKey key;
+    for (size_t tid = 0; tid < thread_subsystem_.threads.size(); ++tid) {
+        const Thread& thread = thread_subsystem_[tid];
+        key.push_back(thread.GetInstructionPointer());
+        // dead registers are skipped, states that differ only in them behave the same
+        for (Register reg : analysis_->liveness.live_registers[tid][thread.GetInstructionPointer()]) {
+            key.push_back(thread.GetLocalValue(reg));
+        }
+    }
+    memory_subsystem_->AppendStateKey(key);
+    return key;
+}
 
+size_t StateKeyHash::operator()(const StateKey& key) const {
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint64_t value : key) {
+        hash = (hash ^ value) * 1099511628211ULL;
+    }
+    return hash;
 }
 
-ControllableExecutor::ControllableExecutor(ThreadSubsystem thread_subsystem, MemorySubsystemPtr&& memory_ptr)
+ControllableExecutor ControllableExecutor::Clone() const {
+    return ControllableExecutor{thread_subsystem_, memory_subsystem_->Clone(), analysis_, bytecode_};
+}
+
+ControllableExecutor::ControllableExecutor(ThreadSubsystem thread_subsystem, MemorySubsystemPtr&& memory_ptr, std::shared_ptr<const ProgramAnalysis> analysis,
+                                           std::shared_ptr<const Bytecode> bytecode)
     : thread_subsystem_(std::move(thread_subsystem))
-    , memory_subsystem_(std::move(memory_ptr)) {
+    , memory_subsystem_(std::move(memory_ptr))
+    , analysis_(std::move(analysis))
+    , bytecode_(std::move(bytecode)) {
 
 }
 
-ControllableExecutor CreateControllableExecutor(MemorySubsystemPtr memory_subsystem, const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers) {
+ControllableExecutor CreateControllableExecutor(
+        MemorySubsystemPtr memory_subsystem,
+        const ProgramDescriptor& descriptor,
+        const std::vector<size_t>& instruction_pointers,
+        const ExplorationOptions& options
+) {
+    auto analysis = AnalyzeProgram(descriptor, instruction_pointers, options);
+    auto bytecode = std::make_shared<const Bytecode>(CompileBytecode(descriptor));
+    return CreateControllableExecutor(std::move(memory_subsystem), descriptor, instruction_pointers, std::move(analysis), std::move(bytecode));
+}
+
+ControllableExecutor CreateControllableExecutor(
+        MemorySubsystemPtr memory_subsystem,
+        const ProgramDescriptor& descriptor,
+        const std::vector<size_t>& instruction_pointers,
+        std::shared_ptr<const ProgramAnalysis> analysis,
+        std::shared_ptr<const Bytecode> bytecode
+) {
     ThreadSubsystem thread_subsystem(descriptor, instruction_pointers);
-    return ControllableExecutor(std::move(thread_subsystem), std::move(memory_subsystem));
+    return ControllableExecutor(std::move(thread_subsystem), std::move(memory_subsystem), std::move(analysis), std::move(bytecode));
 }
@@ -5,10 +5,20 @@
 #include "../thread_subsystem/thread_subsystem.h"
 #include "../utility/print_util.h"
 #include "../common/program_descriptor.h"
+#include "../condition/outcome.h"
+#include "../analysis/program_analysis.h"
+#include "thread_step.h"
 #include <memory>
 
 using MemorySubsystemPtr = std::unique_ptr<MemorySubsystem>;
 
+// encoding of a whole system state (with dead registers masked), used to detect already visited states
+using StateKey = std::vector<uint64_t>;
+
+struct StateKeyHash {
+    size_t operator()(const StateKey& key) const;
+};
+
 struct ControllableExecutor {
     std::vector<size_t> GetThreadsNextPossibleSteps() const;
 
@@ -24,21 +34,64 @@ struct ControllableExecutor {
 
     void PrintSystemSnapshot(std::ostream& os, size_t indent = 0) const;
 
-    ControllableExecutor Clone() const;
+    // replays transitions chosen by `trace` (as in SelectTransition) from this state and prints every memory step in a single line
+    void PrintTrace(std::ostream& os, const std::vector<size_t>& trace, size_t indent = 0) const;
+
+    // no thread can make a step and there is nothing left to propagate
+    bool IsTerminal() const;
+
+    size_t GetThreadsCount() const;
+
+    Outcome GetOutcome() const;
 
-    friend struct InstructionExecutor;
+    uint64_t GetRegisterValue(size_t thread_id, Register reg) const;
+
+    bool IsThreadCompleted(size_t thread_id) const;
+
+    bool HasPendingWrite(MemoryCell cell, uint64_t value) const;
+
+    StateKey GetStateKey() const;
+
+    // thread spins in a busy-wait loop and can't leave it until some other transition happens (await semantics)
+    bool IsThreadBlocked(size_t thread_id) const;
+
+    ControllableExecutor Clone() const;
 
-    friend ControllableExecutor CreateControllableExecutor(MemorySubsystemPtr memory_subsystem, const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers);
+    friend ControllableExecutor CreateControllableExecutor(
+            MemorySubsystemPtr memory_subsystem,
+            const ProgramDescriptor& descriptor,
+            const std::vector<size_t>& instruction_pointers,
+            std::shared_ptr<const ProgramAnalysis> analysis,
+            std::shared_ptr<const Bytecode> bytecode
+    );
 
 private:
-    ControllableExecutor(ThreadSubsystem thread_subsystems, const MemorySubsystemPtr& memory_ptr);
+    // with eager private propagation on, pending writes to thread-private cells never stay in buffers
+    void PropagatePrivateWrites();
 
-    ControllableExecutor(ThreadSubsystem thread_subsystems, MemorySubsystemPtr&& memory_ptr);
+    ControllableExecutor(ThreadSubsystem thread_subsystems, MemorySubsystemPtr&& memory_ptr, std::shared_ptr<const ProgramAnalysis> analysis,
+                         std::shared_ptr<const Bytecode> bytecode);
 
     ThreadSubsystem thread_subsystem_;
     MemorySubsystemPtr memory_subsystem_;
+    std::shared_ptr<const ProgramAnalysis> analysis_;
+    std::shared_ptr<const Bytecode> bytecode_;
 };
 
-ControllableExecutor CreateControllableExecutor(MemorySubsystemPtr memory_subsystem, const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers);
+ControllableExecutor CreateControllableExecutor(
+        MemorySubsystemPtr memory_subsystem,
+        const ProgramDescriptor& descriptor,
+        const std::vector<size_t>& instruction_pointers,
+        const ExplorationOptions& options = {}
+);
+
+// with the analysis and the bytecode of the program computed beforehand, e.g. shared by explorations of a loaded program
+ControllableExecutor CreateControllableExecutor(
+        MemorySubsystemPtr memory_subsystem,
+        const ProgramDescriptor& descriptor,
+        const std::vector<size_t>& instruction_pointers,
+        std::shared_ptr<const ProgramAnalysis> analysis,
+        std::shared_ptr<const Bytecode> bytecode
+);
 
 #endif //CONTROLLABLE_EXECUTOR_H
\ No newline at end of file
@@ -3,8 +3,8 @@
 #include <random>
 #include <iostream>
 
-InteractiveExecutor::InteractiveExecutor(ControllableExecutor controllable_executor, bool tracing_on)
-        : UserExecutor(std::move(controllable_executor), tracing_on) {
+InteractiveExecutor::InteractiveExecutor(ControllableExecutor controllable_executor, const ProgramDescriptor& descriptor, bool tracing_on)
+        : UserExecutor(std::move(controllable_executor), descriptor, tracing_on) {
 
 }
 
@@ -33,7 +33,7 @@ size_t InteractiveExecutor::Select() const {
     return selection;
 }
 
-std::unique_ptr<UserExecutor> CreateInteractiveExecutor(MemorySubsystemPtr memory_subsystem, const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, bool tracing_on) {
-    ControllableExecutor controllable_executor = CreateControllableExecutor(std::move(memory_subsystem), descriptor, instruction_pointers);
-    return std::make_unique<InteractiveExecutor>(std::move(controllable_executor), tracing_on);
+std::unique_ptr<UserExecutor> CreateInteractiveExecutor(MemorySubsystemPtr memory_subsystem, const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, bool tracing_on, const ExplorationOptions& options) {
+    ControllableExecutor controllable_executor = CreateControllableExecutor(std::move(memory_subsystem), descriptor, instruction_pointers, options);
+    return std::make_unique<InteractiveExecutor>(std::move(controllable_executor), descriptor, tracing_on);
 }
\ No newline at end of file
@@ -1,7 +1,14 @@
 #include "mc_executor.h"
 
-McExecutor::McExecutor(ControllableExecutor controllable_executor, bool tracing_on)
-    : UserExecutor(std::move(controllable_executor), tracing_on) {
+#include <iostream>
+
+McExecutor::McExecutor(ControllableExecutor controllable_executor, const ProgramDescriptor& descriptor, bool tracing_on)
+    : UserExecutor(std::move(controllable_executor), descriptor, tracing_on) {
+    context->visited.insert(this->controllable_executor.GetStateKey());
+}
+
+McExecutor::McExecutor(ControllableExecutor controllable_executor, bool tracing_on, std::shared_ptr<ExplorationContext> context)
+    : UserExecutor(std::move(controllable_executor), tracing_on, std::move(context)) {
 
 }
 
@@ -9,13 +16,21 @@ std::unique_ptr<UserExecutor> CreateModelCheckingExecutor(
         MemorySubsystemPtr memory_subsystem,
         const ProgramDescriptor& descriptor,
         const std::vector<size_t>& instruction_pointers,
-        bool tracing_on
+        bool tracing_on,
+        const ExplorationOptions& options
 ) {
-    ControllableExecutor controllable_executor = CreateControllableExecutor(std::move(memory_subsystem), descriptor, instruction_pointers);
-    return std::make_unique<McExecutor>(std::move(controllable_executor), tracing_on);
+    // final states are printed only without a final condition
+    ExplorationOptions verdict_options = options;
+    verdict_options.verdict_only = true;
+    ControllableExecutor controllable_executor = CreateControllableExecutor(std::move(memory_subsystem), descriptor, instruction_pointers, verdict_options);
+    return std::make_unique<McExecutor>(std::move(controllable_executor), descriptor, tracing_on);
 }
 
 bool McExecutor::IsDone() const {
+    // once a witness/counterexample is found the whole exploration stops
+    if (context->target_found) {
+        return true;
+    }
     return cur_transition == controllable_executor.GetThreadsNextPossibleSteps().size() + controllable_executor.GetPropagateTransitions().size();
 }
 
@@ -35,15 +50,36 @@ void McExecutor::ExecuteNext() {
             controllable_executor.GetThreadsNextPossibleSteps(),
             controllable_executor.GetPropagateTransitions()
     );
-    McExecutor executor{std::move(copy), tracing_on};
-
-    if (executor.IsDone()) {
-        std::cout << "MC Executor final state:\n";
-        PrintSnapshot();
+    if (!context->visited.insert(copy.GetStateKey()).second) {
         return;
     }
+    context->trace.push_back(selection);
+    McExecutor executor{std::move(copy), tracing_on, context};
 
-    while (!executor.IsDone()) {
-        executor.ExecuteNext();
+    if (executor.controllable_executor.IsTerminal()) {
+        if (GetFinalCondition()) {
+            executor.CheckFinalCondition();
+        } else {
+            std::cout << "MC Executor final state:\n";
+            executor.PrintSnapshot();
+        }
+    } else {
+        while (!executor.IsDone()) {
+            executor.ExecuteNext();
+        }
     }
-}
\ No newline at end of file
+    context->trace.pop_back();
+}
+
+void McExecutor::PrintVerdict() const {
+    std::cout << "Visited states: " << context->visited.size() << '\n';
+    if (!GetFinalCondition() || context->target_found) {
+        return;
+    }
+    PrintFinalCondition(std::cout);
+    if (GetFinalCondition()->quantifier == ConditionQuantifier::EXISTS) {
+        std::cout << ": no reachable witness, the condition never holds\n";
+    } else {
+        std::cout << ": no reachable counterexample, the condition always holds\n";
+    }
+}
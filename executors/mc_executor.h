@@ -5,18 +5,21 @@
 struct McExecutor : UserExecutor {
     size_t cur_transition = 0;
 
-    McExecutor(ControllableExecutor controllable_executor, bool tracing_on);
+    McExecutor(ControllableExecutor controllable_executor, const ProgramDescriptor& descriptor, bool tracing_on);
+    McExecutor(ControllableExecutor controllable_executor, bool tracing_on, std::shared_ptr<ExplorationContext> context);
 
     bool IsDone() const override;
     size_t Select() const override;
     void ExecuteNext() override;
+    void PrintVerdict() const override;
 };
 
 std::unique_ptr<UserExecutor> CreateModelCheckingExecutor(
         MemorySubsystemPtr memory_subsystem,
         const ProgramDescriptor& descriptor,
         const std::vector<size_t>& instruction_pointers,
-        bool tracing_on
+        bool tracing_on,
+        const ExplorationOptions& options = {}
 );
 
-#endif //MC_EXECUTOR_H
\ No newline at end of file
+#endif //MC_EXECUTOR_H
@@ -1,9 +1,10 @@
 #include "random_executor.h"
 
 #include <random>
+#include <chrono>
 
-RandomExecutor::RandomExecutor(ControllableExecutor controllable_executor, bool tracing_on)
-    : UserExecutor(std::move(controllable_executor), tracing_on) {
+RandomExecutor::RandomExecutor(ControllableExecutor controllable_executor, const ProgramDescriptor& descriptor, bool tracing_on)
+    : UserExecutor(std::move(controllable_executor), descriptor, tracing_on) {
 
 }
 
@@ -17,8 +18,9 @@ std::unique_ptr<UserExecutor> CreateRandomExecutor(
         MemorySubsystemPtr memory_subsystem,
         const ProgramDescriptor& descriptor,
         const std::vector<size_t>& instruction_pointers,
-        bool tracing_on
+        bool tracing_on,
+        const ExplorationOptions& options
 ) {
-    ControllableExecutor controllable_executor = CreateControllableExecutor(std::move(memory_subsystem), descriptor, instruction_pointers);
-    return std::make_unique<RandomExecutor>(std::move(controllable_executor), tracing_on);
+    ControllableExecutor controllable_executor = CreateControllableExecutor(std::move(memory_subsystem), descriptor, instruction_pointers, options);
+    return std::make_unique<RandomExecutor>(std::move(controllable_executor), descriptor, tracing_on);
 }
\ No newline at end of file
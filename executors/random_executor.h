@@ -7,10 +7,10 @@
 #include <memory>
 
 struct RandomExecutor : UserExecutor {
-    explicit RandomExecutor(ControllableExecutor controllable_executor, bool tracing_on);
+    RandomExecutor(ControllableExecutor controllable_executor, const ProgramDescriptor& descriptor, bool tracing_on);
     size_t Select() const override;
 };
 
-std::unique_ptr<UserExecutor> CreateRandomExecutor(MemorySubsystemPtr memory_subsystem, const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, bool tracing_on = false);
+std::unique_ptr<UserExecutor> CreateRandomExecutor(MemorySubsystemPtr memory_subsystem, const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, bool tracing_on = false, const ExplorationOptions& options = {});
 
 #endif //RANDOM_EXECUTOR_H
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef THREAD_STEP_H
+#define THREAD_STEP_H
+#include "../instruction/bytecode.h"
+#include "../memory_subsystem/memory_subsystem.h"
+#include "../memory_subsystem/memory_transition_labels.h"
+#include "../thread_subsystem/thread_subsystem.h"
+
+#include <iterator>
+
+/**
+ * Interpreter of the compiled program: every opcode has a handler in a dispatch table, registers are accessed
+ * without checks (the bytecode is validated when compiled).
+ */
+struct BytecodeInterpreter {
+    // executes the op at `ip` and returns the next instruction pointer
+    using Handler = size_t (*)(const BytecodeOp& op, const Bytecode& bytecode, uint64_t* registers, size_t ip, MemorySubsystem& memory, size_t thread_id);
+
+    static size_t Cas(const BytecodeOp& op, const Bytecode&, uint64_t* registers, size_t ip, MemorySubsystem& memory, size_t thread_id) {
+        RmwAtomicOperation operation{RmwKind::COMPARE_EXCHANGE, registers[op.lhs], registers[op.rhs]};
+        registers[op.dst] = memory.MakeRmwTransition(thread_id, RmwLabel{op.mode, registers[op.addr], operation});
+        return ip + 1;
+    }
+    static size_t FetchOp(const BytecodeOp& op, const Bytecode&, uint64_t* registers, size_t ip, MemorySubsystem& memory, size_t thread_id) {
+        RmwAtomicOperation operation{op.rmw_kind, registers[op.lhs]};
+        registers[op.dst] = memory.MakeRmwTransition(thread_id, RmwLabel{op.mode, registers[op.addr], operation});
+        return ip + 1;
+    }
+    static size_t Load(const BytecodeOp& op, const Bytecode&, uint64_t* registers, size_t ip, MemorySubsystem& memory, size_t thread_id) {
+        registers[op.dst] = memory.MakeReadTransition(thread_id, ReadLabel{op.mode, registers[op.addr]});
+        return ip + 1;
+    }
+    static size_t Store(const BytecodeOp& op, const Bytecode&, uint64_t* registers, size_t ip, MemorySubsystem& memory, size_t thread_id) {
+        memory.MakeWriteTransition(thread_id, WriteLabel{op.mode, registers[op.lhs], registers[op.addr]});
+        return ip + 1;
+    }
+    static size_t Fence(const BytecodeOp& op, const Bytecode&, uint64_t*, size_t ip, MemorySubsystem& memory, size_t thread_id) {
+        memory.MakeFenceTransition(thread_id, FenceLabel{op.mode});
+        return ip + 1;
+    }
+    static size_t SetConstant(const BytecodeOp& op, const Bytecode& bytecode, uint64_t* registers, size_t ip, MemorySubsystem&, size_t) {
+        registers[op.dst] = bytecode.constants[op.lhs];
+        return ip + 1;
+    }
+    static size_t BinOp(const BytecodeOp& op, const Bytecode&, uint64_t* registers, size_t ip, MemorySubsystem&, size_t) {
+        registers[op.dst] = EvaluateBinOp(op.bin_op, registers[op.lhs], registers[op.rhs]);
+        return ip + 1;
+    }
+    static size_t JumpIf(const BytecodeOp& op, const Bytecode&, uint64_t* registers, size_t ip, MemorySubsystem&, size_t) {
+        return registers[op.lhs] != 0 ? op.target : ip + 1;
+    }
+
+    // indexed by Opcode
+    static constexpr Handler kDispatchTable[] = {Cas, FetchOp, Load, Store, Fence, SetConstant, BinOp, JumpIf};
+    static_assert(std::size(kDispatchTable) == static_cast<size_t>(Opcode::OPCODES));
+};
+
+inline void ExecuteThreadStep(const Bytecode& bytecode, Thread& thread, MemorySubsystem& memory, size_t thread_id) {
+    size_t ip = thread.GetInstructionPointer();
+    const BytecodeOp& op = bytecode.ops[ip];
+    auto handler = BytecodeInterpreter::kDispatchTable[static_cast<size_t>(op.opcode)];
+    thread.MoveInstructionPointer(handler(op, bytecode, thread.GetRegisterFile(), ip, memory, thread_id));
+}
+
+#endif //THREAD_STEP_H
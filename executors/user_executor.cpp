@@ -2,9 +2,20 @@
 
 #include <iostream>
 
-UserExecutor::UserExecutor(ControllableExecutor controllable_executor, bool tracing_on)
+UserExecutor::UserExecutor(ControllableExecutor controllable_executor, const ProgramDescriptor& descriptor, bool tracing_on)
     : controllable_executor(std::move(controllable_executor))
-    , tracing_on(tracing_on) {
+    , tracing_on(tracing_on)
+    , context(std::make_shared<ExplorationContext>(ExplorationContext{this->controllable_executor.Clone(), descriptor, {}, false, {}})) {
+    auto& final_condition = descriptor.final_condition;
+    if (final_condition && final_condition->GetMaxThreadId() >= this->controllable_executor.GetThreadsCount()) {
+        throw std::runtime_error{"Final condition refers to a thread that is not started"};
+    }
+}
+
+UserExecutor::UserExecutor(ControllableExecutor controllable_executor, bool tracing_on, std::shared_ptr<ExplorationContext> context)
+    : controllable_executor(std::move(controllable_executor))
+    , tracing_on(tracing_on)
+    , context(std::move(context)) {
 
 }
 
@@ -24,8 +35,51 @@ void UserExecutor::ExecuteNext() {
             controllable_executor.GetThreadsNextPossibleSteps(),
             controllable_executor.GetPropagateTransitions()
     );
+    context->trace.push_back(next_index);
+    if (controllable_executor.IsTerminal()) {
+        CheckFinalCondition();
+    }
 }
 
 void UserExecutor::PrintSnapshot() {
     controllable_executor.PrintSystemSnapshot(std::cout);
-}
\ No newline at end of file
+}
+
+void UserExecutor::PrintVerdict() const {
+    if (!GetFinalCondition() || context->target_found) {
+        return;
+    }
+    PrintFinalCondition(std::cout);
+    if (GetFinalCondition()->quantifier == ConditionQuantifier::EXISTS) {
+        std::cout << ": no witness found\n";
+    } else {
+        std::cout << ": no counterexample found\n";
+    }
+}
+
+bool UserExecutor::CheckFinalCondition() {
+    auto& final_condition = GetFinalCondition();
+    if (!final_condition || !final_condition->IsTarget(controllable_executor.GetOutcome())) {
+        return false;
+    }
+    context->target_found = true;
+    PrintFinalCondition(std::cout);
+    if (final_condition->quantifier == ConditionQuantifier::EXISTS) {
+        std::cout << ": witness found\n";
+    } else {
+        std::cout << ": counterexample found\n";
+    }
+    std::cout << "Trace:\n";
+    context->initial_state.PrintTrace(std::cout, context->trace, 1);
+    std::cout << "Final state:\n";
+    PrintSnapshot();
+    return true;
+}
+
+const std::optional<FinalCondition>& UserExecutor::GetFinalCondition() const {
+    return context->descriptor.final_condition;
+}
+
+void UserExecutor::PrintFinalCondition(std::ostream& os) const {
+    GetFinalCondition()->Print(os, context->descriptor.memory_name, context->descriptor.register_name);
+}
@@ -2,17 +2,42 @@
 #define USER_EXECUTOR_H
 
 #include "controllable_executor.h"
+#include "../condition/final_condition.h"
+
+#include <memory>
+#include <optional>
+#include <unordered_set>
+
+// state shared by an executor and all the executors it spawns while exploring
+struct ExplorationContext {
+    ControllableExecutor initial_state;
+    const ProgramDescriptor& descriptor;
+    // transitions selected on the way from initial_state to the state being currently executed
+    std::vector<size_t> trace;
+    bool target_found = false;
+    std::unordered_set<StateKey, StateKeyHash> visited;
+};
 
 struct UserExecutor {
     ControllableExecutor controllable_executor;
     bool tracing_on;
+    std::shared_ptr<ExplorationContext> context;
 
-    UserExecutor(ControllableExecutor controllable_executor, bool tracing_on);
+    UserExecutor(ControllableExecutor controllable_executor, const ProgramDescriptor& descriptor, bool tracing_on);
+    UserExecutor(ControllableExecutor controllable_executor, bool tracing_on, std::shared_ptr<ExplorationContext> context);
     virtual bool IsDone() const;
     virtual size_t Select() const = 0;
     virtual void ExecuteNext();
     virtual void PrintSnapshot();
+    // reports the final condition if it was neither satisfied by a witness nor violated by a counterexample
+    virtual void PrintVerdict() const;
     virtual ~UserExecutor() = default;
+
+protected:
+    // evaluates final condition on the current (terminal) state, prints the trace and stops exploration if the target is found
+    bool CheckFinalCondition();
+    const std::optional<FinalCondition>& GetFinalCondition() const;
+    void PrintFinalCondition(std::ostream& os) const;
 };
 
-#endif //USER_EXECUTOR_H
\ No newline at end of file
+#endif //USER_EXECUTOR_H
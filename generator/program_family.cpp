@@ -0,0 +1,333 @@
+#include "program_family.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <stdexcept>
+
+namespace {
+
+using Code = std::vector<std::string>;
+
+std::string Indexed(const std::string& name, size_t index) {
+    return name + "_" + std::to_string(index);
+}
+
+// shared locations and the code of every thread, laid out as the litmus translation does
+struct ProgramBuilder {
+    explicit ProgramBuilder(const FamilyParameters& parameters)
+        : parameters_(parameters) {
+    }
+
+    void AddLocation(const std::string& name) {
+        locations_.push_back(name);
+    }
+
+    // the code of a new thread, starting with the write of its reserved cell
+    Code& AddThread() {
+        Code& code = threads_.emplace_back();
+        if (parameters_.cells > 0) {
+            size_t address = locations_.size() + (threads_.size() - 1) % parameters_.cells;
+            code.push_back("scratch = " + std::to_string(address));
+            code.push_back("mark = 1");
+            code.push_back("store RLX #scratch mark");
+        }
+        return code;
+    }
+
+    // locations must be added before the threads, the reserved cells follow them
+    GeneratedProgram Assemble(const std::string& condition) const {
+        GeneratedProgram generated;
+        std::string& program = generated.program;
+        if (!locations_.empty()) {
+            program += "shared_state:";
+            for (auto& location : locations_) {
+                program += " " + location;
+            }
+            program += ";\n";
+        }
+        if (parameters_.cells > 0) {
+            program += "reserve_space: " + std::to_string(parameters_.cells) + ";\n";
+        }
+        size_t ip = 0;
+        for (size_t tid = 0; tid < threads_.size(); ++tid) {
+            program += "\n";
+            generated.instruction_pointers.push_back(ip);
+            for (auto& instruction : threads_[tid]) {
+                program += instruction + ";\n";
+            }
+            ip += threads_[tid].size();
+            if (tid + 1 < threads_.size()) {
+                program += "done = 1;\nif done goto end;\n";
+                ip += 2;
+            }
+        }
+        program += "\nend: done = 1;\n\n" + condition + ";\n";
+        return generated;
+    }
+
+private:
+    const FamilyParameters& parameters_;
+    Code locations_;
+    // references to the code of a thread stay valid while more threads are added
+    std::deque<Code> threads_;
+};
+
+void CheckThreads(const std::string& family, size_t threads, size_t min, size_t max) {
+    if (threads < min || threads > max) {
+        std::string expected = min == max ? std::to_string(min) : "at least " + std::to_string(min);
+        throw std::runtime_error{"Family " + family + " takes " + expected + " threads, got " + std::to_string(threads)};
+    }
+}
+
+// branches back to `label` until the loop ran `k` times
+void AddLoopTail(Code& code, const std::string& label) {
+    code.push_back("iter = iter + one");
+    code.push_back("more = k > iter");
+    code.push_back("if more goto " + label);
+}
+
+GeneratedProgram GenerateStoreBuffering(const FamilyParameters& parameters) {
+    ProgramBuilder builder{parameters};
+    size_t threads = parameters.threads;
+    for (size_t tid = 0; tid < threads; ++tid) {
+        builder.AddLocation(Indexed("x", tid));
+    }
+    std::string condition;
+    for (size_t tid = 0; tid < threads; ++tid) {
+        Code& code = builder.AddThread();
+        code.push_back("one = 1");
+        code.push_back("mine = " + Indexed("x", tid));
+        code.push_back("next = " + Indexed("x", (tid + 1) % threads));
+        for (size_t round = 0; round < parameters.depth; ++round) {
+            code.push_back("store RLX #mine one");
+            code.push_back("load RLX #next " + Indexed("a", round));
+        }
+        condition += (tid == 0 ? "" : " /\\ ") + std::to_string(tid) + ":" + Indexed("a", parameters.depth - 1) + " = 0";
+    }
+    return builder.Assemble("exists (" + condition + ")");
+}
+
+GeneratedProgram GenerateMessagePassing(const FamilyParameters& parameters) {
+    ProgramBuilder builder{parameters};
+    size_t last = parameters.threads - 1;
+    for (size_t cell = 0; cell < parameters.depth; ++cell) {
+        builder.AddLocation(Indexed("data", cell));
+    }
+    for (size_t tid = 1; tid <= last; ++tid) {
+        builder.AddLocation(Indexed("flag", tid));
+    }
+    Code& writer = builder.AddThread();
+    writer.push_back("one = 1");
+    for (size_t cell = 0; cell < parameters.depth; ++cell) {
+        writer.push_back("loc = " + Indexed("data", cell));
+        writer.push_back("store RLX #loc one");
+    }
+    writer.push_back("loc = " + Indexed("flag", 1));
+    writer.push_back("store RLX #loc one");
+    for (size_t tid = 1; tid < last; ++tid) {
+        Code& relay = builder.AddThread();
+        relay.push_back("loc = " + Indexed("flag", tid));
+        relay.push_back("load RLX #loc flag");
+        relay.push_back("loc = " + Indexed("flag", tid + 1));
+        relay.push_back("store RLX #loc flag");
+    }
+    Code& reader = builder.AddThread();
+    reader.push_back("loc = " + Indexed("flag", last));
+    reader.push_back("load RLX #loc flag");
+    std::string stale;
+    for (size_t cell = 0; cell < parameters.depth; ++cell) {
+        reader.push_back("loc = " + Indexed("data", cell));
+        reader.push_back("load RLX #loc " + Indexed("d", cell));
+        stale += (cell == 0 ? "" : " \\/ ") + std::to_string(last) + ":" + Indexed("d", cell) + " = 0";
+    }
+    return builder.Assemble("exists (" + std::to_string(last) + ":flag = 1 /\\ (" + stale + "))");
+}
+
+GeneratedProgram GenerateIriw(const FamilyParameters& parameters) {
+    ProgramBuilder builder{parameters};
+    size_t writers = parameters.threads - 2;
+    for (size_t tid = 0; tid < writers; ++tid) {
+        builder.AddLocation(Indexed("x", tid));
+    }
+    for (size_t tid = 0; tid < writers; ++tid) {
+        Code& code = builder.AddThread();
+        code.push_back("one = 1");
+        code.push_back("loc = " + Indexed("x", tid));
+        code.push_back("store RLX #loc one");
+    }
+    for (bool forward : {true, false}) {
+        Code& code = builder.AddThread();
+        for (size_t i = 0; i < writers; ++i) {
+            size_t cell = forward ? i : writers - 1 - i;
+            code.push_back("loc = " + Indexed("x", cell));
+            code.push_back("load RLX #loc " + Indexed("r", cell));
+        }
+    }
+    std::string first = Indexed("r", 0);
+    std::string last = Indexed("r", writers - 1);
+    std::string forward_reader = std::to_string(writers) + ":";
+    std::string backward_reader = std::to_string(writers + 1) + ":";
+    return builder.Assemble("exists (" + forward_reader + first + " = 1 /\\ " + forward_reader + last + " = 0 /\\ " +
+                            backward_reader + last + " = 1 /\\ " + backward_reader + first + " = 0)");
+}
+
+// common prologue of the two threads of a mutual exclusion algorithm
+Code& AddMutexThread(ProgramBuilder& builder, const FamilyParameters& parameters, size_t tid) {
+    Code& code = builder.AddThread();
+    code.push_back("one = 1");
+    code.push_back("zero = 0");
+    code.push_back("me = " + std::to_string(tid));
+    code.push_back("other = " + std::to_string(1 - tid));
+    code.push_back("k = " + std::to_string(parameters.depth));
+    code.push_back("iter = 0");
+    code.push_back("my_flag = " + Indexed("flag", tid));
+    code.push_back("other_flag = " + Indexed("flag", 1 - tid));
+    code.push_back("turn_loc = turn");
+    code.push_back("counter_loc = counter");
+    return code;
+}
+
+void AddCriticalSection(Code& code, const std::string& label) {
+    code.push_back(label + ": load RLX #counter_loc value");
+    code.push_back("value = value + one");
+    code.push_back("store RLX #counter_loc value");
+}
+
+std::string GetCounterCondition(const FamilyParameters& parameters) {
+    return "forall (counter = " + std::to_string(parameters.threads * parameters.depth) + ")";
+}
+
+GeneratedProgram GeneratePeterson(const FamilyParameters& parameters) {
+    ProgramBuilder builder{parameters};
+    for (auto location : {"flag_0", "flag_1", "turn", "counter"}) {
+        builder.AddLocation(location);
+    }
+    for (size_t tid = 0; tid < 2; ++tid) {
+        Code& code = AddMutexThread(builder, parameters, tid);
+        std::string lock = Indexed("lock", tid);
+        std::string wait = Indexed("wait", tid);
+        std::string check_turn = Indexed("check_turn", tid);
+        std::string enter = Indexed("enter", tid);
+        code.push_back(lock + ": store SEQ_CST #my_flag one");
+        code.push_back("store SEQ_CST #turn_loc other");
+        // wait while the other thread wants to enter and it's its turn
+        code.push_back(wait + ": load SEQ_CST #other_flag wants");
+        code.push_back("if wants goto " + check_turn);
+        code.push_back("if one goto " + enter);
+        code.push_back(check_turn + ": load SEQ_CST #turn_loc current");
+        code.push_back("mine = current - other");
+        code.push_back("if mine goto " + enter);
+        code.push_back("if one goto " + wait);
+        AddCriticalSection(code, enter);
+        code.push_back("store SEQ_CST #my_flag zero");
+        AddLoopTail(code, lock);
+    }
+    return builder.Assemble(GetCounterCondition(parameters));
+}
+
+GeneratedProgram GenerateDekker(const FamilyParameters& parameters) {
+    ProgramBuilder builder{parameters};
+    for (auto location : {"flag_0", "flag_1", "turn", "counter"}) {
+        builder.AddLocation(location);
+    }
+    for (size_t tid = 0; tid < 2; ++tid) {
+        Code& code = AddMutexThread(builder, parameters, tid);
+        std::string lock = Indexed("lock", tid);
+        std::string wait = Indexed("wait", tid);
+        std::string contended = Indexed("contended", tid);
+        std::string yield = Indexed("yield", tid);
+        std::string enter = Indexed("enter", tid);
+        code.push_back(lock + ": store SEQ_CST #my_flag one");
+        code.push_back(wait + ": load SEQ_CST #other_flag wants");
+        code.push_back("if wants goto " + contended);
+        code.push_back("if one goto " + enter);
+        // keep the flag raised on our turn, otherwise lower it until the other thread passes the turn
+        code.push_back(contended + ": load SEQ_CST #turn_loc current");
+        code.push_back("theirs = current - me");
+        code.push_back("if theirs goto " + Indexed("back_off", tid));
+        code.push_back("if one goto " + wait);
+        code.push_back(Indexed("back_off", tid) + ": store SEQ_CST #my_flag zero");
+        code.push_back(yield + ": load SEQ_CST #turn_loc current");
+        code.push_back("theirs = current - me");
+        code.push_back("if theirs goto " + yield);
+        code.push_back("if one goto " + lock);
+        AddCriticalSection(code, enter);
+        code.push_back("store SEQ_CST #turn_loc other");
+        code.push_back("store SEQ_CST #my_flag zero");
+        AddLoopTail(code, lock);
+    }
+    return builder.Assemble(GetCounterCondition(parameters));
+}
+
+GeneratedProgram GenerateCounter(const FamilyParameters& parameters, bool use_cas) {
+    ProgramBuilder builder{parameters};
+    builder.AddLocation("counter");
+    for (size_t tid = 0; tid < parameters.threads; ++tid) {
+        Code& code = builder.AddThread();
+        std::string increment = Indexed("increment", tid);
+        code.push_back("one = 1");
+        code.push_back("k = " + std::to_string(parameters.depth));
+        code.push_back("iter = 0");
+        code.push_back("counter_loc = counter");
+        if (use_cas) {
+            // retried while another thread changed the counter since the load
+            code.push_back(increment + ": load RLX #counter_loc value");
+            code.push_back("next = value + one");
+            code.push_back("old := cas SEQ_CST #counter_loc value next");
+            code.push_back("failed = old - value");
+            code.push_back("if failed goto " + increment);
+        } else {
+            code.push_back(increment + ": old := fai SEQ_CST #counter_loc one");
+        }
+        AddLoopTail(code, increment);
+    }
+    return builder.Assemble(GetCounterCondition(parameters));
+}
+
+struct Family {
+    size_t min_threads;
+    size_t max_threads;
+    std::function<GeneratedProgram(const FamilyParameters&)> generate;
+};
+
+const std::map<std::string, Family>& GetFamilies() {
+    static const std::map<std::string, Family> families = {
+            {"sb", {2, SIZE_MAX, GenerateStoreBuffering}},
+            {"mp", {2, SIZE_MAX, GenerateMessagePassing}},
+            {"iriw", {4, SIZE_MAX, GenerateIriw}},
+            {"peterson", {2, 2, GeneratePeterson}},
+            {"dekker", {2, 2, GenerateDekker}},
+            {"counter-fai", {1, SIZE_MAX, [] (const FamilyParameters& parameters) { return GenerateCounter(parameters, false); }}},
+            {"counter-cas", {1, SIZE_MAX, [] (const FamilyParameters& parameters) { return GenerateCounter(parameters, true); }}},
+    };
+    return families;
+}
+
+}  // namespace
+
+GeneratedProgram GenerateFamily(const std::string& family, const FamilyParameters& parameters) {
+    auto& families = GetFamilies();
+    auto it = families.find(family);
+    if (it == families.end()) {
+        std::string names;
+        for (auto& name : GetFamilyNames()) {
+            names += " " + name;
+        }
+        throw std::runtime_error{"Unknown program family " + family + ", expected one of:" + names};
+    }
+    CheckThreads(family, parameters.threads, it->second.min_threads, it->second.max_threads);
+    if (parameters.depth == 0) {
+        throw std::runtime_error{"Program families take a depth of at least 1"};
+    }
+    return it->second.generate(parameters);
+}
+
+std::vector<std::string> GetFamilyNames() {
+    std::vector<std::string> names;
+    for (auto& [name, family] : GetFamilies()) {
+        names.push_back(name);
+    }
+    return names;
+}
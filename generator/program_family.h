@@ -0,0 +1,48 @@
+#ifndef PROGRAM_FAMILY_H
+#define PROGRAM_FAMILY_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// size of a generated program, families ignore the parameters they don't have
+struct FamilyParameters {
+    size_t threads = 2;
+    // chain length, iterations or increments, see GenerateFamily
+    size_t depth = 1;
+    // cells reserved with `reserve_space`, each thread writes one of them before its test code
+    size_t cells = 0;
+};
+
+// program text in the syntax of this project and the entry points of its threads
+struct GeneratedProgram {
+    std::string program;
+    std::vector<size_t> instruction_pointers;
+};
+
+/**
+ * Generates a member of a family of programs whose size grows with the parameters, for stress and scaling
+ * tests of the exploration engines:
+ *
+ * - sb: store buffering over a ring of `threads` threads, each one stores to its cell and loads the cell of
+ *   the next thread `depth` times. The final condition asks whether every last load missed the store before it,
+ *   impossible under sc, possible under tso.
+ * - mp: message passing along a chain of `threads` threads, the first one writes `depth` data cells and raises
+ *   a flag, every other one passes the flag it reads to the next one and the last one reads the data. The
+ *   condition asks whether the flag arrived before some data, impossible under sc and tso.
+ * - iriw: `threads - 2` writers of independent cells and two readers loading them in opposite orders. The
+ *   condition asks whether the readers saw the first and the last write in different orders.
+ * - peterson, dekker: two threads entering a critical section with the mutual exclusion algorithm `depth`
+ *   times each, on SEQ_CST accesses. The condition asserts that no increment of the counter in the critical
+ *   section got lost. Their wait loops read two cells, so the graph mode can't cut them short: explore them in the
+ *   mc mode.
+ * - counter-fai, counter-cas: `threads` threads incrementing a shared counter `depth` times with fai or with a
+ *   load and a cas retried until it succeeds. The condition asserts the final value of the counter.
+ *
+ * Throws std::runtime_error on an unknown family or parameters out of its range.
+ */
+GeneratedProgram GenerateFamily(const std::string& family, const FamilyParameters& parameters);
+
+std::vector<std::string> GetFamilyNames();
+
+#endif //PROGRAM_FAMILY_H
@@ -0,0 +1,138 @@
+#include "bytecode.h"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+struct BytecodeCompiler {
+    const ProgramDescriptor& descriptor;
+    Bytecode& bytecode;
+    size_t ip;
+
+    uint32_t Slot(Register reg) const {
+        if (reg >= descriptor.register_name.size()) {
+            throw std::runtime_error{"Instruction #" + std::to_string(ip) + " accesses an invalid register"};
+        }
+        return static_cast<uint32_t>(reg);
+    }
+
+    BytecodeOp MakeOp(Opcode opcode) const {
+        return BytecodeOp{opcode, AccessMode::RLX, RmwKind::COMPARE_EXCHANGE, ADD, 0, 0, 0, 0, 0};
+    }
+
+    BytecodeOp operator()(const CasInstruction& instruction) const {
+        BytecodeOp op = MakeOp(Opcode::CAS);
+        op.mode = instruction.mode;
+        op.dst = Slot(instruction.dst);
+        op.addr = Slot(instruction.addr);
+        op.lhs = Slot(instruction.expected);
+        op.rhs = Slot(instruction.desired);
+        return op;
+    }
+    BytecodeOp operator()(const FaiInstruction& instruction) const {
+        BytecodeOp op = MakeOp(Opcode::FETCH_OP);
+        op.mode = instruction.mode;
+        op.rmw_kind = RmwKind::FETCH_ADD;
+        op.dst = Slot(instruction.dst);
+        op.addr = Slot(instruction.addr);
+        op.lhs = Slot(instruction.increment);
+        return op;
+    }
+    BytecodeOp operator()(const FetchOpInstruction& instruction) const {
+        BytecodeOp op = MakeOp(Opcode::FETCH_OP);
+        op.mode = instruction.mode;
+        op.rmw_kind = instruction.kind;
+        op.dst = Slot(instruction.dst);
+        op.addr = Slot(instruction.addr);
+        op.lhs = Slot(instruction.operand);
+        return op;
+    }
+    BytecodeOp operator()(const LoadInstruction& instruction) const {
+        BytecodeOp op = MakeOp(Opcode::LOAD);
+        op.mode = instruction.mode;
+        op.dst = Slot(instruction.dst);
+        op.addr = Slot(instruction.addr);
+        return op;
+    }
+    BytecodeOp operator()(const StoreInstruction& instruction) const {
+        BytecodeOp op = MakeOp(Opcode::STORE);
+        op.mode = instruction.mode;
+        op.addr = Slot(instruction.addr);
+        op.lhs = Slot(instruction.src);
+        return op;
+    }
+    BytecodeOp operator()(const FenceInstruction& instruction) const {
+        BytecodeOp op = MakeOp(Opcode::FENCE);
+        op.mode = instruction.mode;
+        return op;
+    }
+    BytecodeOp operator()(const RegisterConstantAssignment& instruction) const {
+        BytecodeOp op = MakeOp(Opcode::SET_CONSTANT);
+        op.dst = Slot(instruction.dst);
+        op.lhs = static_cast<uint32_t>(bytecode.constants.size());
+        bytecode.constants.push_back(instruction.value);
+        return op;
+    }
+    BytecodeOp operator()(const RegisterBinOpAssignment& instruction) const {
+        BytecodeOp op = MakeOp(Opcode::BIN_OP);
+        op.bin_op = instruction.op;
+        op.dst = Slot(instruction.dst);
+        op.lhs = Slot(instruction.lhs);
+        op.rhs = Slot(instruction.rhs);
+        return op;
+    }
+    BytecodeOp operator()(const IfInstruction& instruction) const {
+        if (instruction.instr_on_success > descriptor.instructions.size()) {
+            throw std::runtime_error{"Instruction #" + std::to_string(ip) + " jumps out of the program"};
+        }
+        BytecodeOp op = MakeOp(Opcode::JUMP_IF);
+        op.lhs = Slot(instruction.cond);
+        op.target = static_cast<uint32_t>(instruction.instr_on_success);
+        return op;
+    }
+};
+
+}  // namespace
+
+Bytecode CompileBytecode(const ProgramDescriptor& descriptor) {
+    if (descriptor.instructions.size() >= std::numeric_limits<uint32_t>::max() || descriptor.register_name.size() >= std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error{"Program is too large to be compiled"};
+    }
+    Bytecode bytecode{{}, {}, descriptor.register_name.size()};
+    bytecode.ops.reserve(descriptor.instructions.size());
+    for (size_t ip = 0; ip < descriptor.instructions.size(); ++ip) {
+        bytecode.ops.push_back(std::visit(BytecodeCompiler{descriptor, bytecode, ip}, descriptor.instructions[ip]));
+    }
+    return bytecode;
+}
+
+size_t RunThreadLocalOps(const Bytecode& bytecode, uint64_t* registers, size_t ip) {
+    size_t end = bytecode.ops.size();
+    while (ip < end) {
+        const BytecodeOp& op = bytecode.ops[ip];
+        switch (op.opcode) {
+            case Opcode::SET_CONSTANT:
+                registers[op.dst] = bytecode.constants[op.lhs];
+                ++ip;
+                break;
+            case Opcode::BIN_OP:
+                registers[op.dst] = EvaluateBinOp(op.bin_op, registers[op.lhs], registers[op.rhs]);
+                ++ip;
+                break;
+            case Opcode::JUMP_IF:
+                if (registers[op.lhs] == 0) {
+                    ++ip;
+                } else if (op.target <= ip) {
+                    return ip;
+                } else {
+                    ip = op.target;
+                }
+                break;
+            default:
+                return ip;
+        }
+    }
+    return ip;
+}
@@ -0,0 +1,53 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+#include "instruction.h"
+#include "../common/program_descriptor.h"
+
+#include <cstdint>
+#include <vector>
+
+enum class Opcode : uint8_t {
+    CAS, FETCH_OP, LOAD, STORE, FENCE, SET_CONSTANT, BIN_OP, JUMP_IF, OPCODES
+};
+
+/**
+ * Fixed-width instruction of the compiled program. Operands are register slots checked against the number of
+ * registers when the program is compiled, so interpreters access registers without bounds checks:
+ *  - CAS: dst := cas [addr] lhs (expected) rhs (desired);
+ *  - FETCH_OP: dst := `rmw_kind` [addr] lhs, for fai, xchg and fetch_or;
+ *  - LOAD: dst := [addr]; STORE: [addr] := lhs; FENCE;
+ *  - SET_CONSTANT: dst := constants[lhs];
+ *  - BIN_OP: dst := lhs `bin_op` rhs;
+ *  - JUMP_IF: if lhs != 0 jump to target.
+ */
+struct BytecodeOp {
+    Opcode opcode;
+    AccessMode mode;
+    RmwKind rmw_kind;
+    BinOp bin_op;
+    uint32_t dst;
+    uint32_t addr;
+    uint32_t lhs;
+    uint32_t rhs;
+    uint32_t target;
+};
+
+// instruction pointers are the same as in the source program, the end of the program is ops.size()
+struct Bytecode {
+    std::vector<BytecodeOp> ops;
+    std::vector<uint64_t> constants;
+    size_t registers_cnt;
+};
+
+// validates registers and jump targets of the program, throws on invalid ones
+Bytecode CompileBytecode(const ProgramDescriptor& descriptor);
+
+inline bool IsThreadLocal(const BytecodeOp& op) {
+    return op.opcode == Opcode::SET_CONSTANT || op.opcode == Opcode::BIN_OP || op.opcode == Opcode::JUMP_IF;
+}
+
+// executes thread-local ops starting from `ip` and returns the first one that is not executed: a memory access,
+// the end of the program or a jump back that is taken (so that callers can watch for loops)
+size_t RunThreadLocalOps(const Bytecode& bytecode, uint64_t* registers, size_t ip);
+
+#endif //BYTECODE_H
@@ -6,6 +6,7 @@
 #include "../parser/tokenizer.h"
 
 #include <variant>
+#include <stdexcept>
 
 struct CasInstruction {
     AccessMode mode;
@@ -22,6 +23,19 @@ struct FaiInstruction {
     Register increment;
 };
 
+enum class RmwKind {
+    COMPARE_EXCHANGE, FETCH_ADD, EXCHANGE, FETCH_OR
+};
+
+// r1 := xchg m #r2 r3 (EXCHANGE), r1 := fetch_or m #r2 r3 (FETCH_OR)
+struct FetchOpInstruction {
+    AccessMode mode;
+    RmwKind kind;
+    Register dst;
+    Register addr;
+    Register operand;
+};
+
 struct LoadInstruction {
     AccessMode mode;
     Register dst;
@@ -55,6 +69,32 @@ struct IfInstruction {
     size_t instr_on_success;
 };
 
-using Instruction = std::variant<CasInstruction, LoadInstruction, StoreInstruction, FaiInstruction, FenceInstruction, RegisterConstantAssignment, RegisterBinOpAssignment, IfInstruction>;
+using Instruction = std::variant<CasInstruction, LoadInstruction, StoreInstruction, FaiInstruction, FetchOpInstruction, FenceInstruction, RegisterConstantAssignment, RegisterBinOpAssignment, IfInstruction>;
+
+inline uint64_t EvaluateBinOp(BinOp op, uint64_t lhs_value, uint64_t rhs_value) {
+    switch (op) {
+        case ADD:
+            return lhs_value + rhs_value;
+        case SUBTRACT:
+            return lhs_value - rhs_value;
+        case DIVIDE:
+            if (rhs_value == 0) {
+                throw std::runtime_error{"Division by zero is not allowed"};
+            }
+            return lhs_value / rhs_value;
+        case MULTIPLY:
+            return lhs_value * rhs_value;
+        case LESS:
+            return lhs_value < rhs_value;
+        case GREATER:
+            return lhs_value > rhs_value;
+        case LESS_EQUAL:
+            return lhs_value <= rhs_value;
+        case GREATER_EQUAL:
+            return lhs_value >= rhs_value;
+        default:
+            throw std::runtime_error{"Unknown binary operation"};
+    }
+}
 
 #endif //INSTRUCTION_H
\ No newline at end of file
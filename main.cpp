@@ -1,53 +1,286 @@
-#include "parser/parser.h"
+#include "common/binary_program.h"
 #include "executors/user_executor.h"
 #include "executors/random_executor.h"
 #include "executors/interactive_executor.h"
 #include "executors/mc_executor.h"
-#include "memory_subsystem/sc/sc_memory_subsystem.h"
-#include "memory_subsystem/tso/tso_memory_subsystem.h"
-#include "memory_subsystem/pso/pso_memory_subsystem.h"
+#include "executors/best_first_executor.h"
+#include "axiomatic/graph_explorer.h"
+#include "axiomatic/robustness.h"
+#include "axiomatic/fence_synthesis.h"
+#include "axiomatic/model_diff.h"
+#include "codegen/checker_generator.h"
+#include "batch/batch_runner.h"
+#include "cache/outcome_cache.h"
+#include "server/program_server.h"
+#include "generator/program_family.h"
+#include "parser/litmus.h"
+#include "utility/mapped_file.h"
+#include "memory_subsystem/memory_subsystem_factory.h"
 
-#include <iostream>
+#include <chrono>
 #include <fstream>
+#include <iostream>
+#include <optional>
 #include <string>
+#include <thread>
 
-MemorySubsystemPtr CreateMemorySubsystem(const ProgramDescriptor& descriptor, size_t threads_cnt, std::string operational_model) {
-    if (operational_model == "sc") {
-        return std::make_unique<ScMemorySubsystem>(descriptor, threads_cnt);
-    } else if (operational_model == "tso") {
-        return std::make_unique<TsoMemorySubsystem>(descriptor, threads_cnt);
-    } else if (operational_model == "pso") {
-        return std::make_unique<PsoMemorySubsystem>(descriptor, threads_cnt);
+// result of the `graph` or `mc` mode taken from the outcome cache or recorded for it
+void PrintExplorationRecord(const ProgramDescriptor& descriptor, const ExplorationRecord& record, bool graph_mode) {
+    auto& final_condition = descriptor.final_condition;
+    if (!final_condition) {
+        for (auto& outcome : record.outcomes) {
+            std::cout << "Outcome: " << outcome << '\n';
+        }
+    }
+    std::cout << (graph_mode ? "Consistent graphs: " : "Visited states: ") << record.result.states << '\n';
+    std::cout << "Complete executions: " << record.result.executions << '\n';
+    if (!final_condition) {
+        std::cout << "Distinct outcomes: " << record.outcomes.size() << '\n';
+        return;
+    }
+    if (!record.result.found) {
+        std::cout << "Exploration stopped: " << GetExplorationStatusName(record.result.status) << '\n';
+        return;
+    }
+    final_condition->Print(std::cout, descriptor.memory_name, descriptor.register_name);
+    bool exists = final_condition->quantifier == ConditionQuantifier::EXISTS;
+    if (record.target) {
+        std::cout << (exists ? ": witness found\n" : ": counterexample found\n");
+        std::cout << "Outcome: " << *record.target << '\n';
+    } else if (exists) {
+        std::cout << (graph_mode ? ": no consistent witness" : ": no reachable witness") << ", the condition never holds\n";
     } else {
-        throw std::runtime_error{"Unknown operational model, there is no implementation for it as of now"};
+        std::cout << (graph_mode ? ": no consistent counterexample" : ": no reachable counterexample") << ", the condition always holds\n";
     }
 }
 
-
 int main(int argc, char *argv[]) {
-    if (argc < 5) {
+    std::vector<std::string> args;
+    ExplorationOptions options;
+    BatchOptions batch_options;
+    std::optional<std::string> cache_directory;
+    batch_options.jobs = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; ++i) {
+        std::string arg(argv[i]);
+        if (arg == "--await-spin-loops") {
+            options.await_spin_loops = true;
+        } else if (arg == "--eager-private-propagation") {
+            options.eager_private_propagation = true;
+        } else if (arg.rfind("--jobs=", 0) == 0) {
+            batch_options.jobs = std::max<size_t>(1, std::stoull(arg.substr(7)));
+        } else if (arg.rfind("--time-limit-ms=", 0) == 0) {
+            batch_options.time_limit = std::chrono::milliseconds{std::stoull(arg.substr(16))};
+        } else if (arg.rfind("--memory-limit-mb=", 0) == 0) {
+            batch_options.memory_limit_bytes = std::stoull(arg.substr(18)) << 20;
+        } else if (arg.rfind("--cache-dir=", 0) == 0) {
+            cache_directory = arg.substr(12);
+            batch_options.cache_directory = cache_directory;
+        } else if (arg.rfind("--", 0) == 0) {
+            throw std::runtime_error{"Unknown option " + arg};
+        } else {
+            args.push_back(std::move(arg));
+        }
+    }
+    if (!args.empty() && args[0] == "compile") {
+        if (args.size() != 3) {
+            std::cout << "Correct usage: " << argv[0] << " compile <input-file-path> <output-file-path>\n";
+            exit(1);
+        }
+        ProgramDescriptor descriptor = LoadProgram(args[1]);
+        std::ofstream output{args[2], std::ios::binary};
+        if (!output) {
+            throw std::runtime_error{"Can't open file " + args[2]};
+        }
+        WriteBinaryProgram(output, descriptor);
+        return 0;
+    }
+    if (!args.empty() && args[0] == "convert") {
+        if (args.size() != 3) {
+            std::cout << "Correct usage: " << argv[0] << " convert <litmus-file-path> <output-file-path>\n";
+            exit(1);
+        }
+        MappedFile litmus_file{args[1]};
+        LitmusTranslation translation = TranslateLitmus(litmus_file.GetContents());
+        std::ofstream output{args[2]};
+        if (!output) {
+            throw std::runtime_error{"Can't open file " + args[2]};
+        }
+        output << translation.program;
+        std::cout << "Instruction pointers:";
+        for (size_t ip : translation.instruction_pointers) {
+            std::cout << ' ' << ip;
+        }
+        std::cout << '\n';
+        return 0;
+    }
+    if (!args.empty() && args[0] == "generate") {
+        if (args.size() < 3) {
+            std::cout << "Correct usage: " << argv[0] << " generate <family> <output-file-path> [threads=N] [depth=N] [cells=N]\n";
+            exit(1);
+        }
+        FamilyParameters parameters;
+        for (size_t i = 3; i < args.size(); ++i) {
+            const std::string& arg = args[i];
+            if (arg.rfind("threads=", 0) == 0) {
+                parameters.threads = std::stoull(arg.substr(8));
+            } else if (arg.rfind("depth=", 0) == 0) {
+                parameters.depth = std::stoull(arg.substr(6));
+            } else if (arg.rfind("cells=", 0) == 0) {
+                parameters.cells = std::stoull(arg.substr(6));
+            } else {
+                throw std::runtime_error{"Unknown family parameter " + arg};
+            }
+        }
+        GeneratedProgram generated = GenerateFamily(args[1], parameters);
+        std::ofstream output{args[2]};
+        if (!output) {
+            throw std::runtime_error{"Can't open file " + args[2]};
+        }
+        output << generated.program;
+        std::cout << "Instruction pointers:";
+        for (size_t ip : generated.instruction_pointers) {
+            std::cout << ' ' << ip;
+        }
+        std::cout << '\n';
+        return 0;
+    }
+    if (!args.empty() && args[0] == "batch") {
+        if (args.size() != 3) {
+            std::cout << "Correct usage: " << argv[0] << " [options] batch <manifest-or-directory> <report-file-path>\n";
+            exit(1);
+        }
+        auto tests = ReadManifest(args[1]);
+        auto results = RunBatch(tests, batch_options);
+        std::ofstream report{args[2]};
+        if (!report) {
+            throw std::runtime_error{"Can't open file " + args[2]};
+        }
+        WriteBatchReport(report, tests, results);
+        size_t passed = 0;
+        for (size_t i = 0; i < tests.size(); ++i) {
+            if (results[i].status == BatchStatus::PASSED) {
+                ++passed;
+                continue;
+            }
+            std::cout << tests[i].path << ' ' << GetMemoryModelName(tests[i].model) << ": " << GetBatchStatusName(results[i].status) << ", " << results[i].message << '\n';
+        }
+        std::cout << "Passed " << passed << " of " << tests.size() << " tests\n";
+        return passed == tests.size() ? 0 : 1;
+    }
+    if (!args.empty() && args[0] == "serve") {
+        if (args.size() != 2) {
+            std::cout << "Correct usage: " << argv[0] << " [--jobs=N] serve <socket-path>\n";
+            exit(1);
+        }
+        ProgramServer server;
+        server.Serve(args[1], batch_options.jobs);
+        return 0;
+    }
+    if (args.size() < 4) {
         std::cout << "Incorrect usage of wmm-emulator\n";
-        std::cout << "Correct usage: " << argv[0] << "<input-file-path> <operational_model> <execution_mode> <tracing_mode> <instruction_pointers...>\n";
+        std::cout << "Correct usage: " << argv[0] << " [options] <input-file-path> <operational_model> <execution_mode> <tracing_mode> <instruction_pointers...>\n";
+        std::cout << "Or, to compile a program to the binary form accepted as the input file: " << argv[0] << " compile <input-file-path> <output-file-path>\n";
+        std::cout << "Or, to translate a herd litmus test to a program: " << argv[0] << " convert <litmus-file-path> <output-file-path>\n";
+        std::cout << "Instruction pointers may be omitted for `.litmus` input files, every thread of the test is started then\n";
+        std::cout << "Options:\n";
+        std::cout << Indent{1} << "--await-spin-loops: block threads in busy-wait loops until a value they read changes\n";
+        std::cout << Indent{1} << "--eager-private-propagation: propagate writes to cells accessed by a single thread right away\n";
+        std::cout << Indent{1} << "--cache-dir=DIR: take results of the graph and mc modes (without tracing) and of batch tests from the outcome cache in DIR, store new ones there\n";
+        std::cout << "Or, to generate a program of a scalable family (sb, mp, iriw, peterson, dekker, counter-fai, counter-cas): " << argv[0]
+                  << " generate <family> <output-file-path> [threads=N] [depth=N] [cells=N]\n";
+        std::cout << "Or, to run the tests of a manifest: " << argv[0] << " [options] batch <manifest-or-directory> <report-file-path>\n";
+        std::cout << "Batch options:\n";
+        std::cout << Indent{1} << "--jobs=N: number of tests run in parallel, the number of cores by default\n";
+        std::cout << Indent{1} << "--time-limit-ms=N: time budget of each test\n";
+        std::cout << Indent{1} << "--memory-limit-mb=N: budget of the memory each test keeps for visited execution graphs\n";
+        std::cout << "Or, to answer requests on a Unix domain socket with --jobs worker threads: " << argv[0] << " [--jobs=N] serve <socket-path>\n";
         exit(1);
     }
-    std::ifstream input_file(argv[1]);
-    std::string operational_model(argv[2]);
-    std::string execution_mode(argv[3]);
-    std::string tracing_mode(argv[4]);
+    std::string operational_model(args[1]);
+    std::string execution_mode(args[2]);
+    std::string tracing_mode(args[3]);
 
     bool tracing_on = tracing_mode == "on";
 
     std::vector<size_t> instruction_pointers;
-    for (int i = 5; i < argc; ++i) {
-        size_t ip = std::stoull(argv[i]);
+    for (size_t i = 4; i < args.size(); ++i) {
+        size_t ip = std::stoull(args[i]);
         instruction_pointers.push_back(ip);
     }
 
+    ProgramDescriptor descriptor;
+    if (IsLitmusPath(args[0])) {
+        LitmusProgram litmus = ParseLitmusFile(args[0]);
+        descriptor = std::move(litmus.descriptor);
+        if (instruction_pointers.empty()) {
+            instruction_pointers = std::move(litmus.instruction_pointers);
+        }
+    } else {
+        descriptor = LoadProgram(args[0]);
+    }
+
     if (instruction_pointers.empty()) {
         throw std::runtime_error{"Expected positive number of instruction pointers"};
     }
+    auto start_time = std::chrono::steady_clock::now();
+    auto print_exploration_time = [&start_time] () {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+        std::cout << "Exploration time: " << elapsed.count() << " ms\n";
+    };
+
+    if (cache_directory && !tracing_on && (execution_mode == "graph" || execution_mode == "mc")) {
+        bool graph_mode = execution_mode == "graph";
+        ExplorationConfig config;
+        config.mode = graph_mode ? ExplorationMode::GRAPH : ExplorationMode::OPERATIONAL;
+        config.model = operational_model;
+        config.instruction_pointers = instruction_pointers;
+        config.options = options;
+        ProgramPtr program = CreateProgram(std::move(descriptor));
+        Exploration exploration{program, std::move(config)};
+        OutcomeCache cache{*cache_directory};
+        std::string key = GetExplorationKey(GetProgramHash(program->descriptor), exploration.GetConfig());
+        std::optional<ExplorationRecord> record = cache.Find(key);
+        bool hit = record.has_value();
+        if (!hit) {
+            record = RecordExploration(exploration, program->descriptor);
+            if (IsReproducible(record->result.status)) {
+                cache.Store(key, *record);
+            }
+        }
+        PrintExplorationRecord(program->descriptor, *record, graph_mode);
+        std::cout << "Outcome cache: " << (hit ? "hit " : "stored ") << cache.GetEntryPath(key) << '\n';
+        print_exploration_time();
+        return 0;
+    }
+
+    if (execution_mode == "codegen") {
+        GenerateChecker(std::cout, descriptor, instruction_pointers, ParseMemoryModel(operational_model));
+        return 0;
+    }
+
+    if (execution_mode == "fences") {
+        FenceSynthesizer synthesizer(descriptor, instruction_pointers, ParseMemoryModel(operational_model), tracing_on);
+        synthesizer.Synthesize();
+        synthesizer.PrintResult();
+        print_exploration_time();
+        return 0;
+    }
+
+    if (execution_mode == "graph" || execution_mode == "robustness" || execution_mode == "diff") {
+        std::unique_ptr<GraphExplorer> explorer;
+        if (execution_mode == "diff") {
+            explorer = std::make_unique<ModelDiffExplorer>(descriptor, instruction_pointers, ParseMemoryModels(operational_model), tracing_on);
+        } else if (execution_mode == "graph") {
+            explorer = std::make_unique<GraphExplorer>(descriptor, instruction_pointers, ParseMemoryModel(operational_model), tracing_on);
+        } else {
+            explorer = std::make_unique<RobustnessChecker>(descriptor, instruction_pointers, ParseMemoryModel(operational_model), tracing_on);
+        }
+        explorer->Explore();
+        explorer->PrintVerdict();
+        print_exploration_time();
+        return 0;
+    }
 
-    ProgramDescriptor descriptor = Parse(&input_file);
     MemorySubsystemPtr memory_subsystem = CreateMemorySubsystem(descriptor, instruction_pointers.size(), operational_model);
 
     if (execution_mode == "model-checking") {
@@ -55,11 +288,13 @@ int main(int argc, char *argv[]) {
     } else {
         std::unique_ptr<UserExecutor> executor;
         if (execution_mode == "random") {
-            executor = CreateRandomExecutor(std::move(memory_subsystem), descriptor, instruction_pointers, tracing_on);
+            executor = CreateRandomExecutor(std::move(memory_subsystem), descriptor, instruction_pointers, tracing_on, options);
         } else if (execution_mode == "interactive") {
-            executor = CreateInteractiveExecutor(std::move(memory_subsystem), descriptor, instruction_pointers, tracing_on);
+            executor = CreateInteractiveExecutor(std::move(memory_subsystem), descriptor, instruction_pointers, tracing_on, options);
         } else if (execution_mode == "mc") {
-            executor = CreateModelCheckingExecutor(std::move(memory_subsystem), descriptor, instruction_pointers, tracing_on);
+            executor = CreateModelCheckingExecutor(std::move(memory_subsystem), descriptor, instruction_pointers, tracing_on, options);
+        } else if (execution_mode == "best-first") {
+            executor = CreateBestFirstExecutor(std::move(memory_subsystem), descriptor, instruction_pointers, tracing_on, options);
         } else {
             throw std::runtime_error{"Unsupported execution mode"};
         }
@@ -70,6 +305,10 @@ int main(int argc, char *argv[]) {
         if (tracing_on && execution_mode != "mc") {
             executor->PrintSnapshot();
         }
+        executor->PrintVerdict();
+        if (execution_mode == "mc") {
+            print_exploration_time();
+        }
     }
 
     return 0;
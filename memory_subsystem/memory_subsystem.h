@@ -9,6 +9,9 @@
 
 struct PropagateDescription {
     virtual void Print(std::ostream& os, size_t indent = 0) const = 0;
+    // thread whose pending write gets propagated
+    virtual size_t GetThreadId() const = 0;
+    virtual MemoryCell GetMemoryCell() const = 0;
 
     virtual ~PropagateDescription() = default;
 };
@@ -17,9 +20,19 @@ struct MemorySubsystem {
     virtual std::vector<std::unique_ptr<PropagateDescription>> GetAvailablePropagations() const = 0;
     virtual void MakePropagation(const std::unique_ptr<PropagateDescription>& propagate_description) = 0;
     virtual uint64_t MakeReadTransition(size_t thread_id, ReadLabel read_label) = 0;
+    // value a read of the cell by the thread would return in the current state, the state is not changed
+    virtual uint64_t GetVisibleValue(size_t thread_id, MemoryCell cell) const = 0;
     virtual void MakeWriteTransition(size_t thread_id, WriteLabel write_label) = 0;
     virtual void MakeFenceTransition(size_t thread_id, FenceLabel fence_label) = 0;
-    virtual uint64_t MakeRmwTransition(size_t thread_id, RmwLabel rmw_label) = 0;
+    virtual uint64_t MakeRmwTransition(size_t thread_id, const RmwLabel& rmw_label) = 0;
+    // called once the thread has executed its last instruction
+    virtual void MarkThreadCompleted(size_t) {}
+    // values of the main memory, pending (not yet propagated) writes are not taken into account
+    virtual std::vector<uint64_t> GetMainMemory() const = 0;
+    // true if some thread has a write of the value to the cell that is not propagated yet
+    virtual bool HasPendingWrite(MemoryCell cell, uint64_t value) const = 0;
+    // appends an encoding of the whole memory state, equal encodings mean equal states
+    virtual void AppendStateKey(std::vector<uint64_t>& key) const = 0;
     virtual void Print(std::ostream& os, size_t indent = 0) const = 0;
     virtual std::unique_ptr<MemorySubsystem> Clone() const = 0;
     virtual ~MemorySubsystem() = default;
@@ -0,0 +1,21 @@
+#include "memory_subsystem_factory.h"
+#include "sc/sc_memory_subsystem.h"
+#include "tso/tso_memory_subsystem.h"
+#include "pso/pso_memory_subsystem.h"
+#include "ra/ra_memory_subsystem.h"
+
+#include <stdexcept>
+
+std::unique_ptr<MemorySubsystem> CreateMemorySubsystem(const ProgramDescriptor& descriptor, size_t threads_cnt, std::string operational_model) {
+    if (operational_model == "sc") {
+        return std::make_unique<ScMemorySubsystem>(descriptor, threads_cnt);
+    } else if (operational_model == "tso") {
+        return std::make_unique<TsoMemorySubsystem>(descriptor, threads_cnt);
+    } else if (operational_model == "pso") {
+        return std::make_unique<PsoMemorySubsystem>(descriptor, threads_cnt);
+    } else if (operational_model == "ra") {
+        return std::make_unique<RaMemorySubsystem>(descriptor, threads_cnt);
+    } else {
+        throw std::runtime_error{"Unknown operational model, there is no implementation for it as of now"};
+    }
+}
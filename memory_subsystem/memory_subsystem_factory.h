@@ -0,0 +1,12 @@
+#ifndef MEMORY_SUBSYSTEM_FACTORY_H
+#define MEMORY_SUBSYSTEM_FACTORY_H
+#include "memory_subsystem.h"
+#include "../common/program_descriptor.h"
+
+#include <memory>
+#include <string>
+
+// subsystem of an operational model: sc, tso, pso or ra
+std::unique_ptr<MemorySubsystem> CreateMemorySubsystem(const ProgramDescriptor& descriptor, size_t threads_cnt, std::string operational_model);
+
+#endif //MEMORY_SUBSYSTEM_FACTORY_H
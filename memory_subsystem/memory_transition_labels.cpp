@@ -6,47 +6,22 @@ struct InstructionToLabelConverter {
     const ThreadLocalStorage& registers;
     MemoryTransitionLabel result;
     void operator()(const CasInstruction& instruction) {
-        result = RmwLabel{
-                instruction.mode,
-                registers.GetRegisterValue(instruction.addr),
-                [
-                        expected = registers.GetRegisterValue(instruction.expected),
-                        desired = registers.GetRegisterValue(instruction.desired)
-                ] (uint64_t &cell) {
-                    auto ret = cell;
-                    if (ret == expected) {
-                        cell = desired;
-                    }
-                    return ret;
-                }
-        };
+        result = GetRmwLabel(instruction, registers);
     }
     void operator()(const FaiInstruction& instruction) {
-        result = RmwLabel{
-            instruction.mode,
-            registers.GetRegisterValue(instruction.addr),
-            [inc = registers.GetRegisterValue(instruction.increment)] (uint64_t &cell) {
-                auto ret = cell;
-                cell += inc;
-                return ret;
-            }
-        };
+        result = GetRmwLabel(instruction, registers);
+    }
+    void operator()(const FetchOpInstruction& instruction) {
+        result = GetRmwLabel(instruction, registers);
     }
     void operator()(const LoadInstruction& instruction) {
-        result = ReadLabel{
-            instruction.mode,
-            registers.GetRegisterValue(instruction.addr)
-        };
+        result = GetReadLabel(instruction, registers);
     }
     void operator()(const StoreInstruction& instruction) {
-        result = WriteLabel{
-            instruction.mode,
-            registers.GetRegisterValue(instruction.src),
-            registers.GetRegisterValue(instruction.addr)
-        };
+        result = GetWriteLabel(instruction, registers);
     }
     void operator()(const FenceInstruction& instruction) {
-        result = FenceLabel{instruction.mode};
+        result = GetFenceLabel(instruction);
     }
     void operator()(const RegisterConstantAssignment& instruction) {
         result = EpsilonLabel{};
@@ -63,4 +38,51 @@ MemoryTransitionLabel GetTransitionLabelByInstruction(const Instruction& instruc
     InstructionToLabelConverter converter{registers};
     std::visit(converter, instruction);
     return converter.result;
-}
\ No newline at end of file
+}
+
+RmwLabel GetRmwLabel(const CasInstruction& instruction, const ThreadLocalStorage& registers) {
+    return RmwLabel{
+        instruction.mode,
+        registers.GetRegisterValue(instruction.addr),
+        RmwAtomicOperation{
+            RmwKind::COMPARE_EXCHANGE,
+            registers.GetRegisterValue(instruction.expected),
+            registers.GetRegisterValue(instruction.desired)
+        }
+    };
+}
+
+RmwLabel GetRmwLabel(const FaiInstruction& instruction, const ThreadLocalStorage& registers) {
+    return RmwLabel{
+        instruction.mode,
+        registers.GetRegisterValue(instruction.addr),
+        RmwAtomicOperation{RmwKind::FETCH_ADD, registers.GetRegisterValue(instruction.increment)}
+    };
+}
+
+RmwLabel GetRmwLabel(const FetchOpInstruction& instruction, const ThreadLocalStorage& registers) {
+    return RmwLabel{
+        instruction.mode,
+        registers.GetRegisterValue(instruction.addr),
+        RmwAtomicOperation{instruction.kind, registers.GetRegisterValue(instruction.operand)}
+    };
+}
+
+ReadLabel GetReadLabel(const LoadInstruction& instruction, const ThreadLocalStorage& registers) {
+    return ReadLabel{
+        instruction.mode,
+        registers.GetRegisterValue(instruction.addr)
+    };
+}
+
+WriteLabel GetWriteLabel(const StoreInstruction& instruction, const ThreadLocalStorage& registers) {
+    return WriteLabel{
+        instruction.mode,
+        registers.GetRegisterValue(instruction.src),
+        registers.GetRegisterValue(instruction.addr)
+    };
+}
+
+FenceLabel GetFenceLabel(const FenceInstruction& instruction) {
+    return FenceLabel{instruction.mode};
+}
@@ -7,11 +7,39 @@
 
 #include <cstddef>
 #include <inttypes.h>
-#include <functional>
 #include <optional>
 #include <variant>
 
-using RmwAtomicOperation = std::function<uint64_t(uint64_t&)>;
+// atomic modification of a cell by an rmw, a plain value: labels are built on every step and copied freely
+struct RmwAtomicOperation {
+    RmwKind kind;
+    // expected value for COMPARE_EXCHANGE, the argument of the other kinds
+    uint64_t operand;
+    // value stored by a successful COMPARE_EXCHANGE
+    uint64_t desired = 0;
+
+    // stores the new value to the cell and returns the old one
+    uint64_t Apply(uint64_t& cell) const {
+        uint64_t old_value = cell;
+        switch (kind) {
+            case RmwKind::COMPARE_EXCHANGE:
+                if (cell == operand) {
+                    cell = desired;
+                }
+                break;
+            case RmwKind::FETCH_ADD:
+                cell += operand;
+                break;
+            case RmwKind::EXCHANGE:
+                cell = operand;
+                break;
+            case RmwKind::FETCH_OR:
+                cell |= operand;
+                break;
+        }
+        return old_value;
+    }
+};
 
 struct WriteLabel {
     AccessMode mode;
@@ -41,4 +69,12 @@ using MemoryTransitionLabel = std::variant<FenceLabel, RmwLabel, ReadLabel, Writ
 
 MemoryTransitionLabel GetTransitionLabelByInstruction(const Instruction& instruction, const ThreadLocalStorage& registers);
 
+// labels of particular instructions, for callers that already know the instruction type
+RmwLabel GetRmwLabel(const CasInstruction& instruction, const ThreadLocalStorage& registers);
+RmwLabel GetRmwLabel(const FaiInstruction& instruction, const ThreadLocalStorage& registers);
+RmwLabel GetRmwLabel(const FetchOpInstruction& instruction, const ThreadLocalStorage& registers);
+ReadLabel GetReadLabel(const LoadInstruction& instruction, const ThreadLocalStorage& registers);
+WriteLabel GetWriteLabel(const StoreInstruction& instruction, const ThreadLocalStorage& registers);
+FenceLabel GetFenceLabel(const FenceInstruction& instruction);
+
 #endif //MEMORY_TRANSITION_LABELS_H
\ No newline at end of file
@@ -30,6 +30,14 @@ struct PsoPropagate : PropagateDescription {
         }
         os << " with a new value " << value << '\n';
     }
+
+    size_t GetThreadId() const override {
+        return tid;
+    }
+
+    MemoryCell GetMemoryCell() const override {
+        return memory_cell;
+    }
 };
 
 PsoMemorySubsystem::PsoMemorySubsystem(const ProgramDescriptor& descriptor, size_t threads_cnt)
@@ -71,10 +79,14 @@ void PsoMemorySubsystem::MakePropagation(const std::unique_ptr<PropagateDescript
 }
 
 uint64_t PsoMemorySubsystem::MakeReadTransition(size_t thread_id, ReadLabel read_label) {
-    if (pso_buffers_[thread_id][read_label.src].empty()) {
-        return global_memory_[read_label.src];
+    return GetVisibleValue(thread_id, read_label.src);
+}
+
+uint64_t PsoMemorySubsystem::GetVisibleValue(size_t thread_id, MemoryCell cell) const {
+    if (pso_buffers_[thread_id][cell].empty()) {
+        return global_memory_[cell];
     }
-    return pso_buffers_[thread_id][read_label.src].back();
+    return pso_buffers_[thread_id][cell].back();
 }
 
 void PsoMemorySubsystem::MakeWriteTransition(size_t thread_id, WriteLabel write_label) {
@@ -88,18 +100,44 @@ void PsoMemorySubsystem::MakeFenceTransition(size_t thread_id, FenceLabel fence_
     if (fence_label.mode == AccessMode::RLX) { // fences with relaxed accesses are no op
         return;
     }
-    auto propagations = GetAvailablePropagations();
-    while (!propagations.empty()) {
-        for (auto &propagation : propagations) {
-            MakePropagation(propagation);
+    // a fence only waits for the own buffers to drain, writes of other threads stay pending
+    for (MemoryCell cell = 0; cell < pso_buffers_[thread_id].size(); ++cell) {
+        auto& buffer = pso_buffers_[thread_id][cell];
+        if (!buffer.empty()) {
+            global_memory_[cell] = buffer.back();
+            buffer.clear();
         }
-        propagations = GetAvailablePropagations();
     }
 }
 
-uint64_t PsoMemorySubsystem::MakeRmwTransition(size_t thread_id, RmwLabel rmw_label) {
+uint64_t PsoMemorySubsystem::MakeRmwTransition(size_t thread_id, const RmwLabel& rmw_label) {
     MakeFenceTransition(thread_id, FenceLabel{AccessMode::SEQ_CST});
-    return rmw_label.modification(global_memory_[rmw_label.src]);
+    return rmw_label.modification.Apply(global_memory_[rmw_label.src]);
+}
+
+std::vector<uint64_t> PsoMemorySubsystem::GetMainMemory() const {
+    return global_memory_;
+}
+
+bool PsoMemorySubsystem::HasPendingWrite(MemoryCell cell, uint64_t value) const {
+    for (auto& buffer : pso_buffers_) {
+        for (auto buffered_value : buffer[cell]) {
+            if (buffered_value == value) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void PsoMemorySubsystem::AppendStateKey(std::vector<uint64_t>& key) const {
+    key.insert(key.end(), global_memory_.begin(), global_memory_.end());
+    for (auto& buffer : pso_buffers_) {
+        for (auto& cell_buffer : buffer) {
+            key.push_back(cell_buffer.size());
+            key.insert(key.end(), cell_buffer.begin(), cell_buffer.end());
+        }
+    }
 }
 
 void PsoMemorySubsystem::Print(std::ostream& os, size_t indent) const {
@@ -8,16 +8,20 @@
 
 using PsoBuffer = std::vector<std::deque<uint64_t>>;
 
-struct PsoMemorySubsystem : MemorySubsystem {
+struct PsoMemorySubsystem final : MemorySubsystem {
     PsoMemorySubsystem(const ProgramDescriptor& descriptor, size_t threads_cnt);
     PsoMemorySubsystem(std::vector<uint64_t> global_memory, const std::vector<std::string>& memory_name, std::vector<PsoBuffer> pso_buffers);
 
     std::vector<std::unique_ptr<PropagateDescription>> GetAvailablePropagations() const override;
     void MakePropagation(const std::unique_ptr<PropagateDescription>& propagate_description) override;
     uint64_t MakeReadTransition(size_t thread_id, ReadLabel read_label) override;
+    uint64_t GetVisibleValue(size_t thread_id, MemoryCell cell) const override;
     void MakeWriteTransition(size_t thread_id, WriteLabel write_label) override;
     void MakeFenceTransition(size_t thread_id, FenceLabel fence_label) override;
-    uint64_t MakeRmwTransition(size_t thread_id, RmwLabel rmw_label) override;
+    uint64_t MakeRmwTransition(size_t thread_id, const RmwLabel& rmw_label) override;
+    std::vector<uint64_t> GetMainMemory() const override;
+    bool HasPendingWrite(MemoryCell cell, uint64_t value) const override;
+    void AppendStateKey(std::vector<uint64_t>& key) const override;
     void Print(std::ostream& os, size_t indent = 0) const override;
     std::unique_ptr<MemorySubsystem> Clone() const override;
 private:
@@ -0,0 +1,323 @@
+#include "ra_memory_subsystem.h"
+#include "../../utility/print_util.h"
+
+#include <algorithm>
+#include <ostream>
+
+struct RaObserve : PropagateDescription {
+    size_t tid;
+    MemoryCell cell;
+    Timestamp timestamp;
+    uint64_t value;
+    const std::vector<std::string>& memory_name;
+
+    RaObserve(size_t tid, MemoryCell cell, Timestamp timestamp, uint64_t value, const std::vector<std::string>& memory_name)
+        : tid(tid)
+        , cell(cell)
+        , timestamp(timestamp)
+        , value(value)
+        , memory_name(memory_name) {
+
+    }
+
+    void Print(std::ostream& os, size_t indent = 0) const override {
+        os << Indent{indent} << "Thread#" << tid << " observes memory cell ";
+        if (cell < memory_name.size()) {
+            os << memory_name[cell];
+        } else {
+            os << '#' << cell;
+        }
+        os << " with a new value " << value << " (timestamp " << timestamp << ")\n";
+    }
+
+    size_t GetThreadId() const override {
+        return tid;
+    }
+
+    MemoryCell GetMemoryCell() const override {
+        return cell;
+    }
+};
+
+RaMemorySubsystem::RaMemorySubsystem(const ProgramDescriptor& descriptor, size_t threads_cnt)
+    : memory_size_(descriptor.memory_size)
+    , threads_cnt_(threads_cnt)
+    , memory_name_(descriptor.memory_name)
+    , message_views_(descriptor.memory_size * descriptor.memory_size, 0)
+    , thread_views_(threads_cnt * VIEW_KINDS * descriptor.memory_size, 0)
+    , sc_view_(descriptor.memory_size, 0)
+    , completed_(threads_cnt, false) {
+    // initial message of every location holds zero
+    for (MemoryCell cell = 0; cell < memory_size_; ++cell) {
+        messages_.push_back(RaMessage{cell, 0, 0});
+    }
+}
+
+Timestamp* RaMemorySubsystem::ThreadView(size_t thread_id, ViewKind kind) {
+    return thread_views_.data() + (thread_id * VIEW_KINDS + kind) * memory_size_;
+}
+
+const Timestamp* RaMemorySubsystem::ThreadView(size_t thread_id, ViewKind kind) const {
+    return thread_views_.data() + (thread_id * VIEW_KINDS + kind) * memory_size_;
+}
+
+Timestamp* RaMemorySubsystem::MessageView(size_t message) {
+    return message_views_.data() + message * memory_size_;
+}
+
+const Timestamp* RaMemorySubsystem::MessageView(size_t message) const {
+    return message_views_.data() + message * memory_size_;
+}
+
+void RaMemorySubsystem::Join(Timestamp* dst, const Timestamp* src) const {
+    for (MemoryCell cell = 0; cell < memory_size_; ++cell) {
+        dst[cell] = std::max(dst[cell], src[cell]);
+    }
+}
+
+size_t RaMemorySubsystem::FindMessage(MemoryCell cell, Timestamp timestamp) const {
+    auto it = std::lower_bound(messages_.begin(), messages_.end(), std::make_pair(cell, timestamp), [] (const RaMessage& message, const std::pair<MemoryCell, Timestamp>& key) {
+        return std::make_pair(message.cell, message.timestamp) < key;
+    });
+    return it - messages_.begin();
+}
+
+size_t RaMemorySubsystem::FindLatestMessage(MemoryCell cell) const {
+    return FindMessage(cell + 1, 0) - 1;
+}
+
+std::vector<std::unique_ptr<PropagateDescription>> RaMemorySubsystem::GetAvailablePropagations() const {
+    std::vector<std::unique_ptr<PropagateDescription>> propagate_options;
+    for (size_t tid = 0; tid < threads_cnt_; ++tid) {
+        // completed threads never read again, there is no point in advancing their views
+        if (completed_[tid]) {
+            continue;
+        }
+        const Timestamp* cur = ThreadView(tid, CUR_VIEW);
+        for (auto& message : messages_) {
+            if (message.timestamp > cur[message.cell]) {
+                propagate_options.push_back(std::make_unique<RaObserve>(tid, message.cell, message.timestamp, message.value, memory_name_));
+            }
+        }
+    }
+    return propagate_options;
+}
+
+void RaMemorySubsystem::MakePropagation(const std::unique_ptr<PropagateDescription>& propagate_description) {
+    auto& observe = *static_cast<RaObserve *>(propagate_description.get());
+    ThreadView(observe.tid, CUR_VIEW)[observe.cell] = observe.timestamp;
+    Timestamp& acq = ThreadView(observe.tid, ACQ_VIEW)[observe.cell];
+    acq = std::max(acq, observe.timestamp);
+    CollectGarbage();
+}
+
+void RaMemorySubsystem::Acquire(size_t thread_id, size_t message, AccessMode mode) {
+    if (mode >= AccessMode::ACQ && mode != AccessMode::REL) {
+        Join(ThreadView(thread_id, CUR_VIEW), MessageView(message));
+    }
+    // an acquire fence later on makes views of relaxedly read messages visible
+    Join(ThreadView(thread_id, ACQ_VIEW), MessageView(message));
+}
+
+uint64_t RaMemorySubsystem::MakeReadTransition(size_t thread_id, ReadLabel read_label) {
+    if (read_label.mode == AccessMode::SEQ_CST) {
+        MakeFenceTransition(thread_id, FenceLabel{AccessMode::SEQ_CST});
+    }
+    size_t message = FindMessage(read_label.src, ThreadView(thread_id, CUR_VIEW)[read_label.src]);
+    uint64_t value = messages_[message].value;
+    Acquire(thread_id, message, read_label.mode);
+    CollectGarbage();
+    return value;
+}
+
+uint64_t RaMemorySubsystem::GetVisibleValue(size_t thread_id, MemoryCell cell) const {
+    return messages_[FindMessage(cell, ThreadView(thread_id, CUR_VIEW)[cell])].value;
+}
+
+void RaMemorySubsystem::AddMessage(size_t thread_id, MemoryCell cell, uint64_t value, AccessMode mode, const Timestamp* extra_view) {
+    size_t position = FindLatestMessage(cell) + 1;
+    Timestamp timestamp = messages_[position - 1].timestamp + 1;
+    Timestamp* cur = ThreadView(thread_id, CUR_VIEW);
+    cur[cell] = timestamp;
+    Timestamp& acq = ThreadView(thread_id, ACQ_VIEW)[cell];
+    acq = std::max(acq, timestamp);
+
+    std::vector<Timestamp> view;
+    if (mode >= AccessMode::REL && mode != AccessMode::ACQ) {
+        view.assign(cur, cur + memory_size_);
+    } else {
+        const Timestamp* rel = ThreadView(thread_id, REL_VIEW);
+        view.assign(rel, rel + memory_size_);
+        view[cell] = timestamp;
+    }
+    if (extra_view) {
+        Join(view.data(), extra_view);
+    }
+    messages_.insert(messages_.begin() + position, RaMessage{cell, timestamp, value});
+    message_views_.insert(message_views_.begin() + position * memory_size_, view.begin(), view.end());
+}
+
+void RaMemorySubsystem::MakeWriteTransition(size_t thread_id, WriteLabel write_label) {
+    AddMessage(thread_id, write_label.dst, write_label.value, write_label.mode, nullptr);
+    if (write_label.mode == AccessMode::SEQ_CST) {
+        MakeFenceTransition(thread_id, FenceLabel{AccessMode::SEQ_CST});
+    }
+    CollectGarbage();
+}
+
+void RaMemorySubsystem::MakeFenceTransition(size_t thread_id, FenceLabel fence_label) {
+    if (fence_label.mode == AccessMode::RLX) {
+        return;
+    }
+    Timestamp* cur = ThreadView(thread_id, CUR_VIEW);
+    if (fence_label.mode != AccessMode::REL) {
+        Join(cur, ThreadView(thread_id, ACQ_VIEW));
+    }
+    if (fence_label.mode == AccessMode::SEQ_CST) {
+        Join(cur, sc_view_.data());
+        std::copy(cur, cur + memory_size_, sc_view_.begin());
+        Join(ThreadView(thread_id, ACQ_VIEW), cur);
+    }
+    if (fence_label.mode != AccessMode::ACQ) {
+        std::copy(cur, cur + memory_size_, ThreadView(thread_id, REL_VIEW));
+    }
+}
+
+uint64_t RaMemorySubsystem::MakeRmwTransition(size_t thread_id, const RmwLabel& rmw_label) {
+    if (rmw_label.mode == AccessMode::SEQ_CST) {
+        MakeFenceTransition(thread_id, FenceLabel{AccessMode::SEQ_CST});
+    }
+    // atomicity: the update reads the last message in modification order and is placed right after it
+    size_t message = FindLatestMessage(rmw_label.src);
+    uint64_t cell_value = messages_[message].value;
+    Timestamp* cur = ThreadView(thread_id, CUR_VIEW);
+    cur[rmw_label.src] = messages_[message].timestamp;
+    Acquire(thread_id, message, rmw_label.mode);
+    uint64_t new_value = cell_value;
+    uint64_t result = rmw_label.modification.Apply(new_value);
+    // a failed compare-exchange is only a read, it neither adds a message nor continues a release sequence
+    if (rmw_label.modification.kind == RmwKind::COMPARE_EXCHANGE && cell_value != rmw_label.modification.operand) {
+        CollectGarbage();
+        return result;
+    }
+    // continues the release sequence of the message it reads from
+    std::vector<Timestamp> read_view(MessageView(message), MessageView(message) + memory_size_);
+    AddMessage(thread_id, rmw_label.src, new_value, rmw_label.mode, read_view.data());
+    if (rmw_label.mode == AccessMode::SEQ_CST) {
+        MakeFenceTransition(thread_id, FenceLabel{AccessMode::SEQ_CST});
+    }
+    CollectGarbage();
+    return result;
+}
+
+void RaMemorySubsystem::MarkThreadCompleted(size_t thread_id) {
+    completed_[thread_id] = true;
+    CollectGarbage();
+}
+
+void RaMemorySubsystem::CollectGarbage() {
+    // the oldest message of each location that some running thread can still read
+    std::vector<Timestamp> base(memory_size_);
+    for (MemoryCell cell = 0; cell < memory_size_; ++cell) {
+        base[cell] = messages_[FindLatestMessage(cell)].timestamp;
+    }
+    for (size_t tid = 0; tid < threads_cnt_; ++tid) {
+        if (completed_[tid]) {
+            continue;
+        }
+        const Timestamp* cur = ThreadView(tid, CUR_VIEW);
+        for (MemoryCell cell = 0; cell < memory_size_; ++cell) {
+            base[cell] = std::min(base[cell], cur[cell]);
+        }
+    }
+    if (std::all_of(base.begin(), base.end(), [] (Timestamp timestamp) { return timestamp == 0; })) {
+        return;
+    }
+
+    auto rebase = [this, &base] (Timestamp* view) {
+        for (MemoryCell cell = 0; cell < memory_size_; ++cell) {
+            view[cell] = view[cell] > base[cell] ? view[cell] - base[cell] : 0;
+        }
+    };
+    size_t kept = 0;
+    for (size_t message = 0; message < messages_.size(); ++message) {
+        RaMessage cur_message = messages_[message];
+        if (cur_message.timestamp < base[cur_message.cell]) {
+            continue;
+        }
+        cur_message.timestamp -= base[cur_message.cell];
+        messages_[kept] = cur_message;
+        std::copy(MessageView(message), MessageView(message) + memory_size_, MessageView(kept));
+        rebase(MessageView(kept));
+        ++kept;
+    }
+    messages_.resize(kept);
+    message_views_.resize(kept * memory_size_);
+    for (size_t view = 0; view < threads_cnt_ * VIEW_KINDS; ++view) {
+        rebase(thread_views_.data() + view * memory_size_);
+    }
+    rebase(sc_view_.data());
+}
+
+std::vector<uint64_t> RaMemorySubsystem::GetMainMemory() const {
+    std::vector<uint64_t> memory(memory_size_);
+    for (MemoryCell cell = 0; cell < memory_size_; ++cell) {
+        memory[cell] = messages_[FindLatestMessage(cell)].value;
+    }
+    return memory;
+}
+
+bool RaMemorySubsystem::HasPendingWrite(MemoryCell cell, uint64_t value) const {
+    return std::any_of(messages_.begin(), messages_.end(), [cell, value] (const RaMessage& message) {
+        return message.cell == cell && message.value == value;
+    });
+}
+
+void RaMemorySubsystem::AppendStateKey(std::vector<uint64_t>& key) const {
+    key.push_back(messages_.size());
+    for (auto& message : messages_) {
+        key.push_back(message.cell);
+        key.push_back(message.timestamp);
+        key.push_back(message.value);
+    }
+    key.insert(key.end(), message_views_.begin(), message_views_.end());
+    key.insert(key.end(), thread_views_.begin(), thread_views_.end());
+    key.insert(key.end(), sc_view_.begin(), sc_view_.end());
+    key.insert(key.end(), completed_.begin(), completed_.end());
+}
+
+void RaMemorySubsystem::Print(std::ostream& os, size_t indent) const {
+    auto print_cell = [this, &os] (MemoryCell cell) {
+        if (cell < memory_name_.size()) {
+            os << memory_name_[cell];
+        } else {
+            os << '#' << cell;
+        }
+    };
+    os << Indent{indent} << "RA Memory:\n";
+    os << Indent{indent + 1} << "Messages:\n";
+    for (MemoryCell cell = 0; cell < memory_size_; ++cell) {
+        os << Indent{indent + 2};
+        print_cell(cell);
+        os << ": ";
+        for (size_t message = FindMessage(cell, 0); message < messages_.size() && messages_[message].cell == cell; ++message) {
+            os << '<' << messages_[message].timestamp << ", " << messages_[message].value << "> ";
+        }
+        os << '\n';
+    }
+    os << Indent{indent + 1} << "Thread views:\n";
+    for (size_t tid = 0; tid < threads_cnt_; ++tid) {
+        os << Indent{indent + 2} << "Thread #" << tid << ':';
+        const Timestamp* cur = ThreadView(tid, CUR_VIEW);
+        for (MemoryCell cell = 0; cell < memory_size_; ++cell) {
+            os << ' ';
+            print_cell(cell);
+            os << '@' << cur[cell];
+        }
+        os << '\n';
+    }
+}
+
+std::unique_ptr<MemorySubsystem> RaMemorySubsystem::Clone() const {
+    return std::make_unique<RaMemorySubsystem>(*this);
+}
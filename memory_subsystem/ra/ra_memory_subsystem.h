@@ -0,0 +1,81 @@
+#ifndef RA_MEMORY_SUBSYSTEM_H
+#define RA_MEMORY_SUBSYSTEM_H
+#include "../memory_subsystem.h"
+#include "../../common/program_descriptor.h"
+#include "../../common/memory_primitives.h"
+
+#include <cstdint>
+#include <vector>
+
+using Timestamp = uint32_t;
+
+struct RaMessage {
+    MemoryCell cell;
+    Timestamp timestamp;
+    uint64_t value;
+};
+
+/**
+ * Release-Acquire semantics based on per-location message histories and per-thread views.
+ *
+ * Writes append a message at the end of the location's modification order (strong RA), a thread
+ * reads the message its view points to. Advancing the view of a running thread to a newer message
+ * is an epsilon transition, analogous to propagation of store buffers.
+ *
+ * Every view is a fixed-size array of timestamps (one per memory cell) stored in flat vectors,
+ * so Clone only copies a few contiguous buffers. Messages older than views of all running threads
+ * can never be read again: they are collected and timestamps are renumbered from zero,
+ * which keeps equal states equal.
+ */
+struct RaMemorySubsystem : MemorySubsystem {
+    RaMemorySubsystem(const ProgramDescriptor& descriptor, size_t threads_cnt);
+
+    std::vector<std::unique_ptr<PropagateDescription>> GetAvailablePropagations() const override;
+    void MakePropagation(const std::unique_ptr<PropagateDescription>& propagate_description) override;
+    uint64_t MakeReadTransition(size_t thread_id, ReadLabel read_label) override;
+    uint64_t GetVisibleValue(size_t thread_id, MemoryCell cell) const override;
+    void MakeWriteTransition(size_t thread_id, WriteLabel write_label) override;
+    void MakeFenceTransition(size_t thread_id, FenceLabel fence_label) override;
+    uint64_t MakeRmwTransition(size_t thread_id, const RmwLabel& rmw_label) override;
+    void MarkThreadCompleted(size_t thread_id) override;
+    std::vector<uint64_t> GetMainMemory() const override;
+    bool HasPendingWrite(MemoryCell cell, uint64_t value) const override;
+    void AppendStateKey(std::vector<uint64_t>& key) const override;
+    void Print(std::ostream& os, size_t indent = 0) const override;
+    std::unique_ptr<MemorySubsystem> Clone() const override;
+
+private:
+    // views kept for every thread
+    enum ViewKind {
+        CUR_VIEW = 0, // what the thread has observed
+        ACQ_VIEW = 1, // what the thread observes after an acquire fence
+        REL_VIEW = 2, // what relaxed writes of the thread carry after a release fence
+        VIEW_KINDS = 3
+    };
+
+    Timestamp* ThreadView(size_t thread_id, ViewKind kind);
+    const Timestamp* ThreadView(size_t thread_id, ViewKind kind) const;
+    Timestamp* MessageView(size_t message);
+    const Timestamp* MessageView(size_t message) const;
+    void Join(Timestamp* dst, const Timestamp* src) const;
+
+    size_t FindMessage(MemoryCell cell, Timestamp timestamp) const;
+    size_t FindLatestMessage(MemoryCell cell) const;
+    void AddMessage(size_t thread_id, MemoryCell cell, uint64_t value, AccessMode mode, const Timestamp* extra_view);
+    void Acquire(size_t thread_id, size_t message, AccessMode mode);
+    void CollectGarbage();
+
+    size_t memory_size_;
+    size_t threads_cnt_;
+    const std::vector<std::string>& memory_name_;
+    // sorted by (cell, timestamp)
+    std::vector<RaMessage> messages_;
+    // memory_size_ timestamps per message, in the same order as messages_
+    std::vector<Timestamp> message_views_;
+    // memory_size_ timestamps per (thread, view kind)
+    std::vector<Timestamp> thread_views_;
+    std::vector<Timestamp> sc_view_;
+    std::vector<bool> completed_;
+};
+
+#endif //RA_MEMORY_SUBSYSTEM_H
@@ -16,7 +16,11 @@ void ScMemorySubsystem::MakePropagation(const std::unique_ptr<PropagateDescripti
 }
 
 uint64_t ScMemorySubsystem::MakeReadTransition(size_t thread_id, ReadLabel read_label) {
-    return global_memory_[read_label.src];
+    return GetVisibleValue(thread_id, read_label.src);
+}
+
+uint64_t ScMemorySubsystem::GetVisibleValue(size_t thread_id, MemoryCell cell) const {
+    return global_memory_[cell];
 }
 
 void ScMemorySubsystem::MakeWriteTransition(size_t thread_id, WriteLabel write_label) {
@@ -27,8 +31,20 @@ void ScMemorySubsystem::MakeFenceTransition(size_t thread_id, FenceLabel fence_l
 
 }
 
-uint64_t ScMemorySubsystem::MakeRmwTransition(size_t thread_id, RmwLabel rmw_label) {
-    return rmw_label.modification(global_memory_[rmw_label.src]);
+uint64_t ScMemorySubsystem::MakeRmwTransition(size_t thread_id, const RmwLabel& rmw_label) {
+    return rmw_label.modification.Apply(global_memory_[rmw_label.src]);
+}
+
+std::vector<uint64_t> ScMemorySubsystem::GetMainMemory() const {
+    return global_memory_;
+}
+
+bool ScMemorySubsystem::HasPendingWrite(MemoryCell cell, uint64_t value) const {
+    return false;
+}
+
+void ScMemorySubsystem::AppendStateKey(std::vector<uint64_t>& key) const {
+    key.insert(key.end(), global_memory_.begin(), global_memory_.end());
 }
 
 void ScMemorySubsystem::Print(std::ostream& os, size_t indent) const {
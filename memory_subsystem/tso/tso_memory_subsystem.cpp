@@ -24,6 +24,14 @@ struct TsoPropagate : PropagateDescription {
         }
         os << " with a new value " << value << '\n';
     }
+
+    size_t GetThreadId() const override {
+        return tid;
+    }
+
+    MemoryCell GetMemoryCell() const override {
+        return store_buffer.front().first;
+    }
 };
 
 TsoMemorySubsystem::TsoMemorySubsystem(const ProgramDescriptor& descriptor, [[maybe_unused]] size_t threads_cnt)
@@ -50,16 +58,17 @@ void TsoMemorySubsystem::MakePropagation(const std::unique_ptr<PropagateDescript
 }
 
 uint64_t TsoMemorySubsystem::MakeReadTransition(size_t thread_id, ReadLabel read_label) {
-    if (store_buffers_[thread_id].empty()) {
-        return global_memory_[read_label.src];
-    }
+    return GetVisibleValue(thread_id, read_label.src);
+}
+
+uint64_t TsoMemorySubsystem::GetVisibleValue(size_t thread_id, MemoryCell cell) const {
     // find first value from the back
     for (size_t i = store_buffers_[thread_id].size(); i > 0; --i) {
-        if (store_buffers_[thread_id][i].first == read_label.src) {
-            return store_buffers_[thread_id][i].second;
+        if (store_buffers_[thread_id][i - 1].first == cell) {
+            return store_buffers_[thread_id][i - 1].second;
         }
     }
-    return global_memory_[read_label.src];
+    return global_memory_[cell];
 }
 
 void TsoMemorySubsystem::MakeWriteTransition(size_t thread_id, WriteLabel write_label) {
@@ -70,18 +79,47 @@ void TsoMemorySubsystem::MakeWriteTransition(size_t thread_id, WriteLabel write_
 }
 
 void TsoMemorySubsystem::MakeFenceTransition(size_t thread_id, FenceLabel fence_label) {
-    auto propagations = GetAvailablePropagations();
-    while (!propagations.empty()) {
-        for (auto& propagation : propagations) {
-            MakePropagation(std::move(propagation));
-        }
-        propagations = GetAvailablePropagations();
+    if (fence_label.mode == AccessMode::RLX) { // fences with relaxed accesses are no op
+        return;
+    }
+    // a fence only waits for the own store buffer to drain, writes of other threads stay pending
+    auto& buffer = store_buffers_[thread_id];
+    while (!buffer.empty()) {
+        auto [cell, value] = buffer.front();
+        buffer.pop_front();
+        global_memory_[cell] = value;
     }
 }
 
-uint64_t TsoMemorySubsystem::MakeRmwTransition(size_t thread_id, RmwLabel rmw_label) {
+uint64_t TsoMemorySubsystem::MakeRmwTransition(size_t thread_id, const RmwLabel& rmw_label) {
     MakeFenceTransition(thread_id, FenceLabel{AccessMode::SEQ_CST});
-    return rmw_label.modification(global_memory_[rmw_label.src]);
+    return rmw_label.modification.Apply(global_memory_[rmw_label.src]);
+}
+
+std::vector<uint64_t> TsoMemorySubsystem::GetMainMemory() const {
+    return global_memory_;
+}
+
+bool TsoMemorySubsystem::HasPendingWrite(MemoryCell cell, uint64_t value) const {
+    for (auto& buffer : store_buffers_) {
+        for (auto [buffered_cell, buffered_value] : buffer) {
+            if (buffered_cell == cell && buffered_value == value) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void TsoMemorySubsystem::AppendStateKey(std::vector<uint64_t>& key) const {
+    key.insert(key.end(), global_memory_.begin(), global_memory_.end());
+    for (auto& buffer : store_buffers_) {
+        key.push_back(buffer.size());
+        for (auto [cell, value] : buffer) {
+            key.push_back(cell);
+            key.push_back(value);
+        }
+    }
 }
 
 void TsoMemorySubsystem::Print(std::ostream& os, size_t indent) const {
@@ -0,0 +1,568 @@
+#include "litmus.h"
+#include "parser.h"
+#include "../utility/mapped_file.h"
+
+#include <algorithm>
+#include <cctype>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+std::string_view Trim(std::string_view text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+bool StartsWith(std::string_view text, std::string_view prefix) {
+    return text.substr(0, prefix.size()) == prefix;
+}
+
+// splits by the separator outside of parentheses
+std::vector<std::string_view> Split(std::string_view text, char separator) {
+    std::vector<std::string_view> parts;
+    size_t depth = 0;
+    size_t begin = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '(') {
+            ++depth;
+        } else if (text[i] == ')' && depth > 0) {
+            --depth;
+        } else if (text[i] == separator && depth == 0) {
+            parts.push_back(Trim(text.substr(begin, i - begin)));
+            begin = i + 1;
+        }
+    }
+    parts.push_back(Trim(text.substr(begin)));
+    return parts;
+}
+
+std::string ToUpper(std::string_view text) {
+    std::string result{text};
+    for (char& c : result) {
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    return result;
+}
+
+bool IsNumber(std::string_view text) {
+    return !text.empty() && std::all_of(text.begin(), text.end(), [] (char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+}
+
+bool IsName(std::string_view text) {
+    return !text.empty() && std::isalpha(static_cast<unsigned char>(text.front()))
+        && std::all_of(text.begin(), text.end(), [] (char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; });
+}
+
+std::string CheckName(std::string_view text) {
+    if (!IsName(text)) {
+        throw std::runtime_error{"Unsupported operand in litmus test: " + std::string{text}};
+    }
+    return std::string{text};
+}
+
+// "f(a, b)" as the name and the arguments
+struct Call {
+    std::string_view name;
+    std::vector<std::string_view> args;
+};
+
+std::optional<Call> ParseCall(std::string_view text) {
+    size_t open = text.find('(');
+    if (open == std::string_view::npos || text.back() != ')' || !IsName(Trim(text.substr(0, open)))) {
+        return std::nullopt;
+    }
+    Call call{Trim(text.substr(0, open)), {}};
+    std::string_view args = Trim(text.substr(open + 1, text.size() - open - 2));
+    if (!args.empty()) {
+        call.args = Split(args, ',');
+    }
+    return call;
+}
+
+std::string GetModeByMemoryOrder(std::string_view order) {
+    if (order == "memory_order_relaxed") {
+        return "RLX";
+    } else if (order == "memory_order_acquire" || order == "memory_order_consume") {
+        return "ACQ";
+    } else if (order == "memory_order_release") {
+        return "REL";
+    } else if (order == "memory_order_acq_rel") {
+        return "REL_ACQ";
+    } else if (order == "memory_order_seq_cst") {
+        return "SEQ_CST";
+    }
+    throw std::runtime_error{"Unknown memory order in litmus test: " + std::string{order}};
+}
+
+struct ThreadCode {
+    std::vector<std::string> instructions;
+    // locations whose address register is already set
+    std::set<std::string> addresses;
+    std::set<std::string> constants;
+};
+
+struct LitmusTranslator {
+    explicit LitmusTranslator(std::string_view contents)
+        : contents_(contents) {
+    }
+
+    LitmusTranslation Translate() {
+        ParseHeader();
+        ParseInitialState();
+        auto [code, condition] = SplitCodeAndCondition(contents_.substr(pos_));
+        if (is_c_) {
+            TranslateCCode(code);
+        } else {
+            TranslateX86Code(code);
+        }
+        return LitmusTranslation{name_, Assemble(condition), instruction_pointers_};
+    }
+
+private:
+    void ParseHeader() {
+        size_t end = contents_.find('\n');
+        std::string_view header = Trim(contents_.substr(0, end));
+        size_t space = header.find_first_of(" \t");
+        std::string arch = ToUpper(header.substr(0, space));
+        if (space != std::string_view::npos) {
+            name_ = std::string{Trim(header.substr(space))};
+        }
+        if (arch == "C") {
+            is_c_ = true;
+        } else if (arch != "X86" && arch != "X86_64") {
+            throw std::runtime_error{"Unsupported litmus architecture " + arch + ", expected X86 or C"};
+        }
+        pos_ = end == std::string_view::npos ? contents_.size() : end + 1;
+    }
+
+    // { x=0; 0:EAX=1; int y = 0; }
+    void ParseInitialState() {
+        size_t open = contents_.find('{', pos_);
+        size_t close = contents_.find('}', open);
+        if (open == std::string_view::npos || close == std::string_view::npos) {
+            throw std::runtime_error{"Litmus test has no initial state"};
+        }
+        for (std::string_view entry : Split(contents_.substr(open + 1, close - open - 1), ';')) {
+            if (entry.empty()) {
+                continue;
+            }
+            size_t eq = entry.find('=');
+            std::string_view lhs = Trim(entry.substr(0, eq));
+            // drop the type of a declaration
+            lhs = Trim(lhs.substr(lhs.find_last_of(" \t*") == std::string_view::npos ? 0 : lhs.find_last_of(" \t*") + 1));
+            std::string_view rhs = eq == std::string_view::npos ? "0" : Trim(entry.substr(eq + 1));
+            size_t colon = lhs.find(':');
+            if (colon != std::string_view::npos) {
+                std::string_view tid = lhs.substr(0, colon);
+                if (!IsNumber(tid) || !IsNumber(rhs)) {
+                    throw std::runtime_error{"Unsupported initial value in litmus test: " + std::string{entry}};
+                }
+                ThreadCode& thread = GetThread(std::stoull(std::string{tid}));
+                thread.instructions.push_back(CheckName(lhs.substr(colon + 1)) + " = " + std::string{rhs});
+                continue;
+            }
+            if (!lhs.empty() && lhs.front() == '[' && lhs.back() == ']') {
+                lhs = lhs.substr(1, lhs.size() - 2);
+            }
+            if (rhs != "0") {
+                throw std::runtime_error{"Memory starts zeroed, initial value of " + std::string{lhs} + " is not supported"};
+            }
+            AddLocation(lhs);
+        }
+        pos_ = close + 1;
+    }
+
+    // the condition starts at the first line that starts with one of its keywords
+    static std::pair<std::string_view, std::string_view> SplitCodeAndCondition(std::string_view text) {
+        size_t line_begin = 0;
+        while (line_begin < text.size()) {
+            size_t line_end = text.find('\n', line_begin);
+            if (line_end == std::string_view::npos) {
+                line_end = text.size();
+            }
+            std::string_view line = Trim(text.substr(line_begin, line_end - line_begin));
+            for (std::string_view keyword : {"exists", "~exists", "~ exists", "forall", "locations", "filter"}) {
+                if (StartsWith(line, keyword)) {
+                    return {text.substr(0, line_begin), text.substr(line_begin)};
+                }
+            }
+            line_begin = line_end + 1;
+        }
+        return {text, {}};
+    }
+
+    ThreadCode& GetThread(size_t tid) {
+        if (tid >= threads_.size()) {
+            threads_.resize(tid + 1);
+        }
+        return threads_[tid];
+    }
+
+    void AddLocation(std::string_view location) {
+        std::string name = CheckName(location);
+        if (std::find(locations_.begin(), locations_.end(), name) == locations_.end()) {
+            locations_.push_back(name);
+        }
+    }
+
+    // register holding the address of the location
+    std::string Address(ThreadCode& thread, std::string_view location) {
+        while (!location.empty() && (location.front() == '*' || location.front() == '&')) {
+            location = Trim(location.substr(1));
+        }
+        if (!location.empty() && location.front() == '[' && location.back() == ']') {
+            location = Trim(location.substr(1, location.size() - 2));
+        }
+        AddLocation(location);
+        std::string address = std::string{location} + "_loc";
+        if (thread.addresses.insert(std::string{location}).second) {
+            thread.instructions.push_back(address + " = " + std::string{location});
+        }
+        return address;
+    }
+
+    // register holding the value of the operand, a constant or a register
+    static std::string Value(ThreadCode& thread, std::string_view operand) {
+        if (!operand.empty() && operand.front() == '$') {
+            operand = operand.substr(1);
+        }
+        if (IsNumber(operand)) {
+            std::string constant = "const_" + std::string{operand};
+            if (thread.constants.insert(constant).second) {
+                thread.instructions.push_back(constant + " = " + std::string{operand});
+            }
+            return constant;
+        }
+        return CheckName(operand);
+    }
+
+    static void Assign(ThreadCode& thread, const std::string& dst, std::string_view operand) {
+        if (!operand.empty() && operand.front() == '$') {
+            operand = operand.substr(1);
+        }
+        if (IsNumber(operand)) {
+            thread.instructions.push_back(dst + " = " + std::string{operand});
+        } else {
+            thread.instructions.push_back(dst + " = " + CheckName(operand) + " + " + Value(thread, "0"));
+        }
+    }
+
+    static bool IsMemoryOperand(std::string_view operand) {
+        return !operand.empty() && operand.front() == '[';
+    }
+
+    //  P0          | P1          ;
+    //  MOV [x],$1  | MOV [y],$1  ;
+    void TranslateX86Code(std::string_view code) {
+        std::optional<size_t> threads_cnt;
+        for (std::string_view line : Split(code, '\n')) {
+            if (line.empty()) {
+                continue;
+            }
+            if (line.back() == ';') {
+                line = Trim(line.substr(0, line.size() - 1));
+            }
+            auto columns = Split(line, '|');
+            if (!threads_cnt) {
+                threads_cnt = columns.size();
+                GetThread(*threads_cnt - 1);
+                continue;
+            }
+            if (columns.size() != *threads_cnt) {
+                throw std::runtime_error{"Litmus test has a row with a wrong number of threads: " + std::string{line}};
+            }
+            for (size_t tid = 0; tid < columns.size(); ++tid) {
+                if (!columns[tid].empty()) {
+                    TranslateX86Instruction(threads_[tid], columns[tid]);
+                }
+            }
+        }
+    }
+
+    void TranslateX86Instruction(ThreadCode& thread, std::string_view text) {
+        size_t space = text.find_first_of(" \t");
+        std::string mnemonic = ToUpper(text.substr(0, space));
+        std::string_view rest = space == std::string_view::npos ? std::string_view{} : Trim(text.substr(space));
+        if (mnemonic == "LOCK") {
+            space = rest.find_first_of(" \t");
+            mnemonic = ToUpper(rest.substr(0, space));
+            rest = space == std::string_view::npos ? std::string_view{} : Trim(rest.substr(space));
+        }
+        auto operands = rest.empty() ? std::vector<std::string_view>{} : Split(rest, ',');
+        auto unsupported = [text] () {
+            return std::runtime_error{"Unsupported x86 instruction in litmus test: " + std::string{text}};
+        };
+        if (mnemonic == "MFENCE" && operands.empty()) {
+            thread.instructions.emplace_back("fence SEQ_CST");
+            return;
+        }
+        if (operands.size() != 2) {
+            throw unsupported();
+        }
+        auto dst = operands[0];
+        auto src = operands[1];
+        if (mnemonic == "MOV") {
+            if (IsMemoryOperand(dst) && !IsMemoryOperand(src)) {
+                std::string value = Value(thread, src);
+                thread.instructions.push_back("store RLX #" + Address(thread, dst) + " " + value);
+            } else if (!IsMemoryOperand(dst) && IsMemoryOperand(src)) {
+                thread.instructions.push_back("load RLX #" + Address(thread, src) + " " + CheckName(dst));
+            } else if (!IsMemoryOperand(dst)) {
+                Assign(thread, CheckName(dst), src);
+            } else {
+                throw unsupported();
+            }
+        } else if (mnemonic == "XCHG" || mnemonic == "XADD") {
+            if (mnemonic == "XCHG" && IsMemoryOperand(src)) {
+                std::swap(dst, src);
+            }
+            if (!IsMemoryOperand(dst) || IsMemoryOperand(src)) {
+                throw unsupported();
+            }
+            std::string reg = CheckName(src);
+            std::string operation = mnemonic == "XCHG" ? "xchg" : "fai";
+            thread.instructions.push_back(reg + " := " + operation + " SEQ_CST #" + Address(thread, dst) + " " + reg);
+        } else if (mnemonic == "ADD" && !IsMemoryOperand(dst) && !IsMemoryOperand(src)) {
+            std::string reg = CheckName(dst);
+            thread.instructions.push_back(reg + " = " + reg + " + " + Value(thread, src));
+        } else {
+            throw unsupported();
+        }
+    }
+
+    // P0 (int* x, int* y) { WRITE_ONCE(*x, 1); int r0 = READ_ONCE(*y); }
+    void TranslateCCode(std::string_view code) {
+        std::string text = RemoveComments(code);
+        size_t pos = 0;
+        while ((pos = text.find('P', pos)) != std::string::npos) {
+            size_t digits_end = pos + 1;
+            while (digits_end < text.size() && std::isdigit(static_cast<unsigned char>(text[digits_end]))) {
+                ++digits_end;
+            }
+            size_t open = text.find('{', digits_end);
+            if (digits_end == pos + 1 || open == std::string::npos || (pos > 0 && IsName(text.substr(pos - 1, 1)))) {
+                ++pos;
+                continue;
+            }
+            size_t close = text.find('}', open);
+            if (close == std::string::npos) {
+                throw std::runtime_error{"Litmus test has a thread without the closing brace"};
+            }
+            ThreadCode& thread = GetThread(std::stoull(text.substr(pos + 1, digits_end - pos - 1)));
+            for (std::string_view statement : Split(std::string_view{text}.substr(open + 1, close - open - 1), ';')) {
+                if (!statement.empty()) {
+                    TranslateCStatement(thread, statement);
+                }
+            }
+            pos = close + 1;
+        }
+    }
+
+    static std::string RemoveComments(std::string_view code) {
+        std::string text;
+        for (size_t i = 0; i < code.size(); ++i) {
+            if (code.substr(i, 2) == "//") {
+                i = std::min(code.find('\n', i), code.size()) - 1;
+            } else if (code.substr(i, 2) == "/*") {
+                size_t end = code.find("*/", i + 2);
+                i = end == std::string_view::npos ? code.size() : end + 1;
+            } else {
+                text += code[i];
+            }
+        }
+        return text;
+    }
+
+    static std::string_view DropType(std::string_view statement) {
+        static const std::set<std::string_view> kTypeWords = {
+                "int", "long", "unsigned", "short", "char", "atomic_int", "intptr_t",
+                "int32_t", "int64_t", "uint32_t", "uint64_t", "volatile", "const"
+        };
+        while (true) {
+            size_t space = statement.find_first_of(" \t\n");
+            if (space == std::string_view::npos || kTypeWords.count(statement.substr(0, space)) == 0) {
+                return statement;
+            }
+            statement = Trim(statement.substr(space));
+        }
+    }
+
+    void TranslateCStatement(ThreadCode& thread, std::string_view statement) {
+        statement = DropType(statement);
+        auto unsupported = [statement] () {
+            return std::runtime_error{"Unsupported C statement in litmus test: " + std::string{statement}};
+        };
+        size_t eq = statement.find('=');
+        if (eq == std::string_view::npos) {
+            if (IsName(statement)) {
+                // declaration of a register
+                return;
+            }
+            auto call = ParseCall(statement);
+            if (!call || !TranslateCCall(thread, *call, "unused")) {
+                throw unsupported();
+            }
+            return;
+        }
+        std::string_view lhs = Trim(statement.substr(0, eq));
+        std::string_view rhs = Trim(statement.substr(eq + 1));
+        if (!lhs.empty() && lhs.front() == '*') {
+            std::string value = Value(thread, rhs);
+            thread.instructions.push_back("store RLX #" + Address(thread, lhs) + " " + value);
+            return;
+        }
+        std::string dst = CheckName(lhs);
+        if (auto call = ParseCall(rhs)) {
+            if (!TranslateCCall(thread, *call, dst)) {
+                throw unsupported();
+            }
+        } else if (!rhs.empty() && rhs.front() == '*') {
+            thread.instructions.push_back("load RLX #" + Address(thread, rhs) + " " + dst);
+        } else if (size_t op = rhs.find_first_of("+-*/<>"); op != std::string_view::npos) {
+            std::string lhs_value = Value(thread, Trim(rhs.substr(0, op)));
+            std::string rhs_value = Value(thread, Trim(rhs.substr(op + 1)));
+            thread.instructions.push_back(dst + " = " + lhs_value + " " + rhs[op] + " " + rhs_value);
+        } else {
+            Assign(thread, dst, rhs);
+        }
+    }
+
+    // false if the call is not supported
+    bool TranslateCCall(ThreadCode& thread, const Call& call, const std::string& dst) {
+        auto& name = call.name;
+        auto& args = call.args;
+        auto mode_arg = [&args] (size_t index) {
+            return index < args.size() ? GetModeByMemoryOrder(args[index]) : std::string{"SEQ_CST"};
+        };
+        if ((name == "smp_mb" || name == "smp_wmb" || name == "smp_rmb") && args.empty()) {
+            thread.instructions.emplace_back(name == "smp_mb" ? "fence SEQ_CST" : "fence REL_ACQ");
+        } else if (name == "atomic_thread_fence" && args.size() == 1) {
+            thread.instructions.push_back("fence " + mode_arg(0));
+        } else if (name == "WRITE_ONCE" || name == "smp_store_release" || name == "atomic_store" || name == "atomic_store_explicit") {
+            if (args.size() != (name == "atomic_store_explicit" ? 3 : 2)) {
+                return false;
+            }
+            std::string mode = name == "WRITE_ONCE" ? "RLX" : name == "smp_store_release" ? "REL" : mode_arg(2);
+            std::string value = Value(thread, args[1]);
+            thread.instructions.push_back("store " + mode + " #" + Address(thread, args[0]) + " " + value);
+        } else if (name == "READ_ONCE" || name == "smp_load_acquire" || name == "atomic_load" || name == "atomic_load_explicit") {
+            if (args.size() != (name == "atomic_load_explicit" ? 2 : 1)) {
+                return false;
+            }
+            std::string mode = name == "READ_ONCE" ? "RLX" : name == "smp_load_acquire" ? "ACQ" : mode_arg(1);
+            thread.instructions.push_back("load " + mode + " #" + Address(thread, args[0]) + " " + dst);
+        } else if (StartsWith(name, "atomic_exchange") || StartsWith(name, "atomic_fetch_add") || StartsWith(name, "atomic_fetch_or")) {
+            bool is_explicit = name.substr(name.size() - std::min<size_t>(name.size(), 9)) == "_explicit";
+            if (args.size() != (is_explicit ? 3 : 2)) {
+                return false;
+            }
+            std::string operation = StartsWith(name, "atomic_exchange") ? "xchg" : StartsWith(name, "atomic_fetch_add") ? "fai" : "fetch_or";
+            std::string value = Value(thread, args[1]);
+            thread.instructions.push_back(dst + " := " + operation + " " + mode_arg(2) + " #" + Address(thread, args[0]) + " " + value);
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // exists (0:EAX=0 /\ [x]=1) in the syntax of the final condition
+    static std::string TranslateCondition(std::string_view condition) {
+        std::string text;
+        for (std::string_view line : Split(condition, '\n')) {
+            if (StartsWith(line, "locations")) {
+                continue;
+            }
+            if (StartsWith(line, "filter")) {
+                throw std::runtime_error{"Filters of litmus tests are not supported"};
+            }
+            for (char c : line) {
+                if (c != '[' && c != ']') {
+                    text += c;
+                }
+            }
+            text += ' ';
+        }
+        std::string_view result = Trim(text);
+        while (!result.empty() && result.back() == ';') {
+            result = Trim(result.substr(0, result.size() - 1));
+        }
+        if (result.empty()) {
+            return {};
+        }
+        if (StartsWith(result, "~")) {
+            result = Trim(result.substr(1));
+            if (!StartsWith(result, "exists")) {
+                throw std::runtime_error{"Unsupported litmus condition: ~" + std::string{result}};
+            }
+            return "forall (~" + std::string{Trim(result.substr(6))} + ");\n";
+        }
+        return std::string{result} + ";\n";
+    }
+
+    // threads one after another, all but the last jump to the common end
+    std::string Assemble(std::string_view condition) {
+        if (threads_.empty()) {
+            throw std::runtime_error{"Litmus test has no threads"};
+        }
+        std::string program;
+        if (!locations_.empty()) {
+            program += "shared_state:";
+            for (auto& location : locations_) {
+                program += " " + location;
+            }
+            program += ";\n";
+        }
+        size_t ip = 0;
+        for (size_t tid = 0; tid < threads_.size(); ++tid) {
+            instruction_pointers_.push_back(ip);
+            for (auto& instruction : threads_[tid].instructions) {
+                program += instruction + ";\n";
+            }
+            ip += threads_[tid].instructions.size();
+            if (tid + 1 < threads_.size()) {
+                program += "done = 1;\nif done goto end;\n";
+                ip += 2;
+            }
+        }
+        program += "end: done = 1;\n";
+        program += TranslateCondition(condition);
+        return program;
+    }
+
+    std::string_view contents_;
+    size_t pos_ = 0;
+    std::string name_;
+    bool is_c_ = false;
+    std::vector<std::string> locations_;
+    std::vector<ThreadCode> threads_;
+    std::vector<size_t> instruction_pointers_;
+};
+
+}  // namespace
+
+LitmusTranslation TranslateLitmus(std::string_view contents) {
+    return LitmusTranslator{contents}.Translate();
+}
+
+LitmusProgram ParseLitmus(std::string_view contents) {
+    LitmusTranslation translation = TranslateLitmus(contents);
+    return LitmusProgram{translation.name, Parse(std::string_view{translation.program}), translation.instruction_pointers};
+}
+
+LitmusProgram ParseLitmusFile(const std::string& path) {
+    MappedFile file{path};
+    return ParseLitmus(file.GetContents());
+}
+
+bool IsLitmusPath(const std::string& path) {
+    constexpr std::string_view kExtension = ".litmus";
+    return path.size() >= kExtension.size() && path.compare(path.size() - kExtension.size(), kExtension.size(), kExtension) == 0;
+}
@@ -0,0 +1,46 @@
+#ifndef LITMUS_H
+#define LITMUS_H
+#include "../common/program_descriptor.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// herd litmus test rewritten in the syntax of this project
+struct LitmusTranslation {
+    std::string name;
+    std::string program;
+    std::vector<size_t> instruction_pointers;
+};
+
+struct LitmusProgram {
+    std::string name;
+    ProgramDescriptor descriptor;
+    std::vector<size_t> instruction_pointers;
+};
+
+/**
+ * Translates a test in the `.litmus` format of herd: the header line with the architecture and the name, the
+ * initial state in braces, the code of the threads and the final condition (`exists`, `~exists` or `forall`).
+ * Two architectures are supported:
+ *
+ * - X86: threads are columns of a table separated by '|', rows end with ';'. Instructions are MOV between
+ *   registers, memory ([x]) and immediates ($1), ADD, MFENCE, XCHG and LOCK XADD. Plain accesses are RLX,
+ *   locked ones and MFENCE are SEQ_CST, so the tso model gives them the x86 semantics.
+ * - C: threads are functions `P0(...) { ... }` of statements like WRITE_ONCE(*x, 1), r0 = READ_ONCE(*x),
+ *   smp_store_release, smp_load_acquire, smp_mb, the atomic_*_explicit loads, stores, exchanges and fetch-adds
+ *   with their memory orders, atomic_thread_fence and plain assignments of constants and registers.
+ *
+ * Memory starts zeroed, so the initial state may only set registers and declare locations.
+ * Each thread gets its own code; all threads but the last jump to a shared final instruction.
+ */
+LitmusTranslation TranslateLitmus(std::string_view contents);
+
+LitmusProgram ParseLitmus(std::string_view contents);
+
+LitmusProgram ParseLitmusFile(const std::string& path);
+
+bool IsLitmusPath(const std::string& path);
+
+#endif //LITMUS_H
@@ -2,10 +2,15 @@
 #include "tokenizer.h"
 #include "../common/memory_primitives.h"
 #include "../common/program_descriptor.h"
+#include "../common/instruction_text.h"
+#include "../utility/mapped_file.h"
+#include "symbol_interner.h"
 
-#include <unordered_map>
-#include <sstream>
+#include <cstdint>
 #include <istream>
+#include <optional>
+#include <string_view>
+#include <utility>
 
 template<typename T>
 bool Is(const Token& token) {
@@ -17,75 +22,6 @@ T As(const Token& token) {
     return std::get<T>(token);
 }
 
-/**
- * using Token = std::variant<
-        ConstantToken,
-        TaggedSymbolToken,
-        SymbolToken,
-        AssignmentToken,
-        ThreadLocalAssignmentToken,
-        BinOp,
-        SemicolonToken,
-        ColonToken,
-        StreamEnd,
-        KeywordToken>;
- */
-
-struct TokenPrinter {
-    std::ostream& os;
-
-    void operator()(const KeywordToken& keyword) {
-        os << KeywordToString(keyword);
-    }
-
-    void operator()(const ConstantToken& constant) {
-        os << constant.value;
-    }
-
-    void operator()(const TaggedSymbolToken& symbol) {
-        os << '#' << symbol.value;
-    }
-
-    void operator()(const SymbolToken& symbol) {
-        os << symbol.value;
-    }
-
-    void operator()(const AssignmentToken&) {
-        os << ":=";
-    }
-
-    void operator()(const ThreadLocalAssignmentToken&) {
-        os << '=';
-    }
-
-    void operator()(const BinOp& op) {
-        os << BinOpToString(op);
-    }
-
-    void operator()(const SemicolonToken&) {
-        os << ";";
-    }
-
-    void operator()(const ColonToken&) {
-        os << ":";
-    }
-
-    // should never be invoked
-    void operator()(const StreamEnd&) {
-        assert(false);
-    }
-};
-
-std::string GetStringRepr(const std::vector<Token> &tokens) {
-    std::stringstream ss;
-    TokenPrinter printer{ss};
-    for (auto &token : tokens) {
-        std::visit(printer, token);
-        ss << ' ';
-    }
-    return ss.str();
-}
-
 AccessMode GetAccessModeByKeyword(KeywordToken keyword) {
     switch (keyword) {
         case SEQ_CST:
@@ -107,17 +43,29 @@ class Parser {
 public:
     explicit Parser(Tokenizer* tokenizer) : tokenizer_(tokenizer) {}
 
+    /**
+     * Single pass over the tokens: every instruction is built as soon as its tokens are read, jumps to labels
+     * that are not defined yet are patched at the end
+     */
     ProgramDescriptor ParseAll() {
         ParseSharedState();
         ParseReserveSpace();
-        FirstPassParsing();
-        SecondPassParsing();
+        while (!tokenizer_->IsDone()) {
+            if (IsFinalConditionStart(tokenizer_->GetToken())) {
+                TokenizeFinalCondition();
+                break;
+            }
+            ParseInstruction();
+        }
+        PatchJumps();
+        ParseFinalCondition();
         return ProgramDescriptor{
                 .memory_size = reserved_space_.value_or(0) + memory_name_.size(),
-                .instructions = instructions_,
-                .instructions_str = instructions_str_,
-                .memory_name = memory_name_,
-                .register_name = register_name_
+                .instructions = std::move(instructions_),
+                .instructions_str = std::move(instructions_str_),
+                .memory_name = std::move(memory_name_),
+                .register_name = std::move(register_name_),
+                .final_condition = std::move(final_condition_)
         };
     }
 
@@ -135,12 +83,13 @@ private:
                 if (!Is<SymbolToken>(cur_token)) {
                     throw std::runtime_error{"Incorrect use of shared state syntax, expected symbol"};
                 }
-                auto symbol = As<SymbolToken>(cur_token);
-                if (symbol_to_memory_.find(symbol.value) != symbol_to_memory_.end()) {
+                auto name = As<SymbolToken>(cur_token).value;
+                auto& symbol = symbols_[InternSymbol(name)];
+                if (symbol.cell) {
                     throw std::runtime_error{"Incorrect use of shared state syntax, found duplicate symbol"};
                 }
-                symbol_to_memory_[symbol.value] = memory_name_.size();
-                memory_name_.push_back(std::move(symbol.value));
+                symbol.cell = memory_name_.size();
+                memory_name_.emplace_back(name);
                 tokenizer_->Next();
             }
             assert(Is<SemicolonToken>(tokenizer_->GetToken()));
@@ -168,66 +117,125 @@ private:
         }
     }
 
-    void TokenizeInstruction(const Token& starting_token) {
-        std::vector<Token> instruction = {starting_token};
-        Token current_token = tokenizer_->GetToken();
-        while (!tokenizer_->IsDone() && !Is<SemicolonToken>(current_token)) {
-            instruction.push_back(current_token);
-            current_instruction_.push_back(current_token);
-            tokenizer_->Next();
-            current_token = tokenizer_->GetToken();
+    uint32_t InternSymbol(std::string_view name) {
+        uint32_t id = interner_.Intern(name);
+        if (id == symbols_.size()) {
+            symbols_.emplace_back();
+            instructions_str_.AddSymbol(name);
         }
-        if (!Is<SemicolonToken>(current_token)) {
-            throw std::runtime_error{"Each instruction should end with a semicolon"};
+        return id;
+    }
+
+    // adds the token to the text of the instruction and the id of its symbol (kSymbolNone if it is not a symbol)
+    // to instruction_symbols_
+    void EncodeToken(const Token& token) {
+        uint32_t symbol = kSymbolNone;
+        SourceToken source_token{SourceToken::Kind::COLON};
+        if (Is<SymbolToken>(token)) {
+            symbol = InternSymbol(As<SymbolToken>(token).value);
+            source_token = {SourceToken::Kind::SYMBOL, symbol};
+        } else if (Is<TaggedSymbolToken>(token)) {
+            symbol = InternSymbol(As<TaggedSymbolToken>(token).value);
+            source_token = {SourceToken::Kind::TAGGED_SYMBOL, symbol};
+        } else if (Is<ConstantToken>(token)) {
+            source_token = {SourceToken::Kind::CONSTANT, As<ConstantToken>(token).value};
+        } else if (Is<KeywordToken>(token)) {
+            source_token = {SourceToken::Kind::KEYWORD, static_cast<uint64_t>(As<KeywordToken>(token))};
+        } else if (Is<BinOp>(token)) {
+            source_token = {SourceToken::Kind::BIN_OP, static_cast<uint64_t>(As<BinOp>(token))};
+        } else if (Is<AssignmentToken>(token)) {
+            source_token = {SourceToken::Kind::ASSIGNMENT};
+        } else if (Is<ThreadLocalAssignmentToken>(token)) {
+            source_token = {SourceToken::Kind::THREAD_LOCAL_ASSIGNMENT};
+        } else if (!Is<ColonToken>(token)) {
+            throw std::runtime_error{"Unexpected token in an instruction"};
         }
-        tokenized_instructions_.push_back(std::move(instruction));
-        tokenizer_->Next();
+        instructions_str_.AddToken(source_token);
+        instruction_symbols_.push_back(symbol);
     }
 
-    // NOLINTNEXTLINE
-    void ParseSingleInstruction() {
+    void DefineLabel(std::string_view name) {
+        uint32_t id = InternSymbol(name);
+        if (symbols_[id].label) {
+            throw std::runtime_error{"Repeating labels are prohibited"};
+        }
+        symbols_[id].label = instructions_.size();
+        instructions_str_.AddToken({SourceToken::Kind::SYMBOL, id});
+        instructions_str_.AddToken({SourceToken::Kind::COLON});
+    }
+
+    // [label:]* instruction;
+    void ParseInstruction() {
+        instruction_tokens_.clear();
+        instruction_symbols_.clear();
         Token token = tokenizer_->GetToken();
-        current_instruction_.push_back(token);
         tokenizer_->Next();
-        if (Is<SymbolToken>(token) && Is<ColonToken>(tokenizer_->GetToken())) {
-            current_instruction_.emplace_back(ColonToken{});
+        while (Is<SymbolToken>(token) && Is<ColonToken>(tokenizer_->GetToken())) {
+            tokenizer_->Next();
+            DefineLabel(As<SymbolToken>(token).value);
+            token = tokenizer_->GetToken();
             tokenizer_->Next();
-            if (label_to_instruction_.find(As<SymbolToken>(token).value) != label_to_instruction_.end()) {
-                throw std::runtime_error{"Repeating labels are prohibited"};
-            }
-            label_to_instruction_[As<SymbolToken>(token).value] = tokenized_instructions_.size();
-            ParseSingleInstruction();
-            return;
         }
-        if (Is<SymbolToken>(token) || Is<KeywordToken>(token)) {
-            TokenizeInstruction(token);
-        } else {
+        if (!Is<SymbolToken>(token) && !Is<KeywordToken>(token)) {
             throw std::runtime_error{"Unexpected instruction start"};
         }
+        instruction_tokens_.push_back(token);
+        while (!tokenizer_->IsDone() && !Is<SemicolonToken>(tokenizer_->GetToken())) {
+            instruction_tokens_.push_back(tokenizer_->GetToken());
+            tokenizer_->Next();
+        }
+        if (!Is<SemicolonToken>(tokenizer_->GetToken())) {
+            throw std::runtime_error{"Each instruction should end with a semicolon"};
+        }
+        tokenizer_->Next();
+        for (const Token& instruction_token : instruction_tokens_) {
+            EncodeToken(instruction_token);
+        }
+        instructions_str_.EndInstruction();
+        instructions_.push_back(GetInstructionFromTokens(instruction_tokens_));
+    }
+
+    static bool IsFinalConditionStart(const Token& token) {
+        return Is<KeywordToken>(token) && (As<KeywordToken>(token) == KeywordToken::EXISTS || As<KeywordToken>(token) == KeywordToken::FORALL);
     }
 
     /**
-     * The goal is to determine which index of instruction corresponds to each label
+     * Final condition is only collected here, it is parsed after all instructions so that
+     * registers mentioned only in the condition don't affect numbering of the program's registers
      */
-    void FirstPassParsing() {
-        while(!tokenizer_->IsDone()) {
-            current_instruction_.clear();
-            ParseSingleInstruction();
-            instructions_str_.push_back(GetStringRepr(current_instruction_));
+    void TokenizeFinalCondition() {
+        while (!tokenizer_->IsDone() && !Is<SemicolonToken>(tokenizer_->GetToken())) {
+            condition_tokens_.push_back(tokenizer_->GetToken());
+            tokenizer_->Next();
+        }
+        if (!tokenizer_->IsDone()) {
+            tokenizer_->Next();
+        }
+        if (!tokenizer_->IsDone()) {
+            throw std::runtime_error{"Final condition should be the last statement of a program"};
         }
     }
 
-    Register GetRegister(const std::string& register_name) {
-        if (symbol_to_register_.find(register_name) == symbol_to_register_.end()) {
-            symbol_to_register_[register_name] = register_name_.size();
-            register_name_.push_back(register_name);
+    // register named by the symbol at the position `token` of the current instruction
+    Register GetRegister(size_t token) {
+        uint32_t id = instruction_symbols_[token];
+        if (id == kSymbolNone) {
+            throw std::runtime_error{"Expected a register in the instruction"};
         }
-        return symbol_to_register_[register_name];
+        auto& symbol = symbols_[id];
+        if (!symbol.reg) {
+            symbol.reg = register_name_.size();
+            register_name_.emplace_back(interner_.GetName(id));
+        }
+        return *symbol.reg;
     }
 
-    Register GetMemory(const std::string& memory_alias) {
-        assert(symbol_to_memory_.find(memory_alias) != symbol_to_memory_.end());
-        return symbol_to_memory_[memory_alias];
+    MemoryCell GetMemory(size_t token) {
+        auto& cell = symbols_[instruction_symbols_[token]].cell;
+        if (!cell) {
+            throw std::runtime_error{"Unknown shared memory location in thread local assignment"};
+        }
+        return *cell;
     }
 
     Instruction GetInstructionFromTokens(const std::vector<Token>& tokens) {
@@ -238,49 +246,69 @@ private:
             throw std::runtime_error{"Invalid tokens as a start of an instruction"};
         }
         if (Is<SymbolToken>(tokens[0])) {
-            Register dst = GetRegister(As<SymbolToken>(tokens[0]).value);
+            Register dst = GetRegister(0);
+            if (tokens.size() < 3) {
+                throw std::runtime_error{"Incomplete assignment"};
+            }
             if (Is<ThreadLocalAssignmentToken>(tokens[1])) {
                 if (tokens.size() == 3) { // expect either constant or symbol corresponding to some global variable on the right hand side
                     if (Is<SymbolToken>(tokens[2])) {
-                        return RegisterConstantAssignment{.dst = dst, .value = GetMemory(As<SymbolToken>(tokens[2]).value)};
+                        return RegisterConstantAssignment{.dst = dst, .value = GetMemory(2)};
                     } else if (Is<ConstantToken>(tokens[2])) {
                         return RegisterConstantAssignment{.dst = dst, .value = As<ConstantToken>(tokens[2]).value};
                     } else {
                         throw std::runtime_error{"Thread local assignment with unknown token"};
                     }
                 } else {
-                    assert(tokens.size() == 5); // r = r1 op r2
+                    if (tokens.size() != 5 || !Is<BinOp>(tokens[3])) { // r = r1 op r2
+                        throw std::runtime_error{"Incorrect usage of binary operation"};
+                    }
                     return RegisterBinOpAssignment{
-                            GetRegister(As<SymbolToken>(tokens[0]).value),
-                            GetRegister(As<SymbolToken>(tokens[2]).value),
-                            GetRegister(As<SymbolToken>(tokens[4]).value),
+                            GetRegister(0),
+                            GetRegister(2),
+                            GetRegister(4),
                             As<BinOp>(tokens[3])
                     };
                 }
             } else if (Is<AssignmentToken>(tokens[1])) {
-                assert(Is<KeywordToken>(tokens[2]));
+                if (!Is<KeywordToken>(tokens[2])) {
+                    throw std::runtime_error{"Unexpected keyword in assignment"};
+                }
                 switch (As<KeywordToken>(tokens[2])) {
                     case FAI: { // r1 := fai m #r2 r3
-                        if(!(Is<KeywordToken>(tokens[3]) && Is<TaggedSymbolToken>(tokens[4]) && Is<SymbolToken>(tokens[5]))) {
+                        if (tokens.size() != 6 || !(Is<KeywordToken>(tokens[3]) && Is<TaggedSymbolToken>(tokens[4]) && Is<SymbolToken>(tokens[5]))) {
                             throw std::runtime_error{"Incorrect usage of fetch-and-increment instruction"};
                         }
                         return FaiInstruction{
                                 GetAccessModeByKeyword(As<KeywordToken>(tokens[3])),
                                 dst,
-                                GetRegister(As<TaggedSymbolToken>(tokens[4]).value),
-                                GetRegister(As<SymbolToken>(tokens[5]).value)
+                                GetRegister(4),
+                                GetRegister(5)
                         };
                     }
                     case CAS: { // r1 := cas m #r2 r3 r4
-                        if(!(Is<KeywordToken>(tokens[3]) && Is<TaggedSymbolToken>(tokens[4]) && Is<SymbolToken>(tokens[5]) && Is<SymbolToken>(tokens[6]))) {
+                        if (tokens.size() != 7 || !(Is<KeywordToken>(tokens[3]) && Is<TaggedSymbolToken>(tokens[4]) && Is<SymbolToken>(tokens[5]) && Is<SymbolToken>(tokens[6]))) {
                             throw std::runtime_error{"Incorrect usage of compare-and-swap instruction"};
                         }
                         return CasInstruction{
                                 GetAccessModeByKeyword(As<KeywordToken>(tokens[3])),
                                 dst,
-                                GetRegister(As<TaggedSymbolToken>(tokens[4]).value),
-                                GetRegister(As<SymbolToken>(tokens[5]).value),
-                                GetRegister(As<SymbolToken>(tokens[6]).value)
+                                GetRegister(4),
+                                GetRegister(5),
+                                GetRegister(6)
+                        };
+                    }
+                    case XCHG: // r1 := xchg m #r2 r3
+                    case FETCH_OR: { // r1 := fetch_or m #r2 r3
+                        if (tokens.size() != 6 || !(Is<KeywordToken>(tokens[3]) && Is<TaggedSymbolToken>(tokens[4]) && Is<SymbolToken>(tokens[5]))) {
+                            throw std::runtime_error{"Incorrect usage of fetch-and-modify instruction"};
+                        }
+                        return FetchOpInstruction{
+                                GetAccessModeByKeyword(As<KeywordToken>(tokens[3])),
+                                As<KeywordToken>(tokens[2]) == XCHG ? RmwKind::EXCHANGE : RmwKind::FETCH_OR,
+                                dst,
+                                GetRegister(4),
+                                GetRegister(5)
                         };
                     }
                     default:
@@ -301,34 +329,31 @@ private:
                     }
                     return LoadInstruction{
                             GetAccessModeByKeyword(As<KeywordToken>(tokens[1])),
-                            GetRegister(As<SymbolToken>(tokens[3]).value),
-                            GetRegister(As<TaggedSymbolToken>(tokens[2]).value)
+                            GetRegister(3),
+                            GetRegister(2)
                     };
                 case STORE: // store m #r1 r2
                     if (tokens.size() != 4) {
-                        throw std::runtime_error{"Incorrect load instruction, wrong number of arguments"};
+                        throw std::runtime_error{"Incorrect store instruction, wrong number of arguments"};
                     }
                     if (!(Is<KeywordToken>(tokens[1]) && Is<TaggedSymbolToken>(tokens[2]) && Is<SymbolToken>(tokens[3]))) {
-                        throw std::runtime_error{"Incorrect type of arguments of load instruction"};
+                        throw std::runtime_error{"Incorrect type of arguments of store instruction"};
                     }
                     return StoreInstruction{
                             GetAccessModeByKeyword(As<KeywordToken>(tokens[1])),
-                            GetRegister(As<TaggedSymbolToken>(tokens[2]).value),
-                            GetRegister(As<SymbolToken>(tokens[3]).value)
+                            GetRegister(2),
+                            GetRegister(3)
                     };
                 case IF: // if r goto L
                     if (tokens.size() != 4) {
-                        throw std::runtime_error{"Incorrect load instruction, wrong number of arguments"};
+                        throw std::runtime_error{"Incorrect if instruction, wrong number of arguments"};
                     }
                     if (!(Is<SymbolToken>(tokens[1]) && Is<KeywordToken>(tokens[2]) && As<KeywordToken>(tokens[2]) == KeywordToken::GOTO && Is<SymbolToken>(tokens[3]))) {
-                        throw std::runtime_error{"Incorrect type of arguments of load instruction"};
-                    }
-                    if (label_to_instruction_.find(As<SymbolToken>(tokens[3]).value) == label_to_instruction_.end()) {
-                        throw std::runtime_error{"Unknown label in conditional jump instruction"};
+                        throw std::runtime_error{"Incorrect type of arguments of if instruction"};
                     }
                     return IfInstruction{
-                            GetRegister(As<SymbolToken>(tokens[1]).value),
-                            label_to_instruction_[As<SymbolToken>(tokens[3]).value]
+                            GetRegister(1),
+                            GetJumpTarget(instruction_symbols_[3])
                     };
                 case FENCE: // fence m
                     if (tokens.size() != 2) {
@@ -346,28 +371,160 @@ private:
         }
     }
 
+    // jumps forward are patched once all the labels are known
+    size_t GetJumpTarget(uint32_t label) {
+        if (!symbols_[label].label) {
+            pending_jumps_.emplace_back(instructions_.size(), label);
+            return 0;
+        }
+        return *symbols_[label].label;
+    }
+
+    void PatchJumps() {
+        for (auto [ip, label] : pending_jumps_) {
+            if (!symbols_[label].label) {
+                throw std::runtime_error{"Unknown label in conditional jump instruction"};
+            }
+            std::get<IfInstruction>(instructions_[ip]).instr_on_success = *symbols_[label].label;
+        }
+    }
+
+    const Token& ConditionToken() const {
+        static const Token stream_end = StreamEnd{};
+        return condition_pos_ < condition_tokens_.size() ? condition_tokens_[condition_pos_] : stream_end;
+    }
+
+    size_t AddConditionNode(ConditionNode node) {
+        condition_nodes_.push_back(node);
+        return condition_nodes_.size() - 1;
+    }
+
+    uint64_t ParseConditionValue() {
+        if (!Is<ThreadLocalAssignmentToken>(ConditionToken())) {
+            throw std::runtime_error{"Incorrect final condition, expected '=' after location"};
+        }
+        ++condition_pos_;
+        if (!Is<ConstantToken>(ConditionToken())) {
+            throw std::runtime_error{"Incorrect final condition, expected constant value"};
+        }
+        return As<ConstantToken>(condition_tokens_[condition_pos_++]).value;
+    }
+
+    // tid:reg = value | cell = value
+    size_t ParseConditionAtom() {
+        const Token& token = ConditionToken();
+        if (Is<ConstantToken>(token)) {
+            size_t thread_id = As<ConstantToken>(token).value;
+            ++condition_pos_;
+            if (!Is<ColonToken>(ConditionToken())) {
+                throw std::runtime_error{"Incorrect final condition, expected colon after thread id"};
+            }
+            ++condition_pos_;
+            if (!Is<SymbolToken>(ConditionToken())) {
+                throw std::runtime_error{"Incorrect final condition, expected register name"};
+            }
+            auto id = interner_.Find(As<SymbolToken>(ConditionToken()).value);
+            if (!id || !symbols_[*id].reg) {
+                throw std::runtime_error{"Unknown register in final condition"};
+            }
+            ++condition_pos_;
+            return AddConditionNode(RegisterEquals{thread_id, *symbols_[*id].reg, ParseConditionValue()});
+        }
+        if (Is<SymbolToken>(token)) {
+            auto id = interner_.Find(As<SymbolToken>(token).value);
+            if (!id || !symbols_[*id].cell) {
+                throw std::runtime_error{"Unknown shared memory location in final condition"};
+            }
+            ++condition_pos_;
+            return AddConditionNode(MemoryEquals{*symbols_[*id].cell, ParseConditionValue()});
+        }
+        throw std::runtime_error{"Incorrect final condition, unexpected token"};
+    }
+
+    // NOLINTNEXTLINE
+    size_t ParseConditionUnary() {
+        if (Is<NegationToken>(ConditionToken())) {
+            ++condition_pos_;
+            size_t operand = ParseConditionUnary();
+            return AddConditionNode(Negation{operand});
+        }
+        if (Is<LeftParenthesisToken>(ConditionToken())) {
+            ++condition_pos_;
+            size_t node = ParseConditionDisjunction();
+            if (!Is<RightParenthesisToken>(ConditionToken())) {
+                throw std::runtime_error{"Incorrect final condition, unbalanced parentheses"};
+            }
+            ++condition_pos_;
+            return node;
+        }
+        return ParseConditionAtom();
+    }
+
+    size_t ParseConditionConjunction() {
+        size_t node = ParseConditionUnary();
+        while (Is<ConjunctionToken>(ConditionToken())) {
+            ++condition_pos_;
+            size_t rhs = ParseConditionUnary();
+            node = AddConditionNode(Conjunction{node, rhs});
+        }
+        return node;
+    }
+
+    // NOLINTNEXTLINE
+    size_t ParseConditionDisjunction() {
+        size_t node = ParseConditionConjunction();
+        while (Is<DisjunctionToken>(ConditionToken())) {
+            ++condition_pos_;
+            size_t rhs = ParseConditionConjunction();
+            node = AddConditionNode(Disjunction{node, rhs});
+        }
+        return node;
+    }
+
     /**
-     * The goal is to get final instructions set
+     * exists|forall <predicate>, where predicate is built from "tid:reg = value" and "cell = value" atoms
+     * with "~", "/\", "\/" and parentheses
      */
-    void SecondPassParsing() {
-        for (const auto & tokenized_instruction : tokenized_instructions_) {
-            instructions_.push_back(GetInstructionFromTokens(tokenized_instruction));
+    void ParseFinalCondition() {
+        if (condition_tokens_.empty()) {
+            return;
         }
+        auto quantifier = As<KeywordToken>(condition_tokens_[0]) == KeywordToken::EXISTS ? ConditionQuantifier::EXISTS : ConditionQuantifier::FORALL;
+        condition_pos_ = 1;
+        size_t root = ParseConditionDisjunction();
+        if (condition_pos_ != condition_tokens_.size()) {
+            throw std::runtime_error{"Incorrect final condition, unexpected trailing tokens"};
+        }
+        final_condition_ = FinalCondition{quantifier, std::move(condition_nodes_), root};
     }
 
+    // what a symbol names, the same symbol may name a register, a memory cell and a label
+    struct SymbolInfo {
+        std::optional<Register> reg;
+        std::optional<MemoryCell> cell;
+        std::optional<size_t> label;
+    };
 
+    static constexpr uint32_t kSymbolNone = UINT32_MAX;
 
-    std::vector<Token> current_instruction_;
     std::optional<size_t> reserved_space_;
-    std::vector<std::vector<Token>> tokenized_instructions_;
     Tokenizer* tokenizer_;
+    SymbolInterner interner_;
+    // indexed by symbol ids
+    std::vector<SymbolInfo> symbols_;
+    // tokens of the instruction being parsed and ids of their symbols, the storage is reused by all instructions
+    std::vector<Token> instruction_tokens_;
+    std::vector<uint32_t> instruction_symbols_;
+    // conditional jumps to labels that were not defined yet when the jumps were parsed
+    std::vector<std::pair<size_t, uint32_t>> pending_jumps_;
     std::vector<Instruction> instructions_;
-    std::unordered_map<std::string, size_t> label_to_instruction_;
-    std::vector<std::string> instructions_str_;
-    std::unordered_map<std::string, MemoryCell> symbol_to_memory_;
+    InstructionText instructions_str_;
     std::vector<std::string> memory_name_;
-    std::unordered_map<std::string, Register> symbol_to_register_;
     std::vector<std::string> register_name_;
+    std::vector<Token> condition_tokens_;
+    size_t condition_pos_ = 0;
+    std::vector<ConditionNode> condition_nodes_;
+    std::optional<FinalCondition> final_condition_;
 };
 
 
@@ -375,4 +532,15 @@ ProgramDescriptor Parse(std::istream* is) {
     Tokenizer tokenizer(is);
     Parser parser(&tokenizer);
     return parser.ParseAll();
+}
+
+ProgramDescriptor Parse(std::string_view input) {
+    Tokenizer tokenizer(input);
+    Parser parser(&tokenizer);
+    return parser.ParseAll();
+}
+
+ProgramDescriptor ParseFile(const std::string& path) {
+    MappedFile file(path);
+    return Parse(file.GetContents());
 }
\ No newline at end of file
@@ -3,7 +3,15 @@
 #include "../common/program_descriptor.h"
 
 #include <istream>
+#include <string>
+#include <string_view>
 
 ProgramDescriptor Parse(std::istream* is);
 
+// symbols are copied to the descriptor only once, tokens are views of the input
+ProgramDescriptor Parse(std::string_view input);
+
+// parses a memory-mapped file in place
+ProgramDescriptor ParseFile(const std::string& path);
+
 #endif //PARSER_H
\ No newline at end of file
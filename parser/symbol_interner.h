@@ -0,0 +1,43 @@
+#ifndef SYMBOL_INTERNER_H
+#define SYMBOL_INTERNER_H
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// gives consecutive ids to distinct symbols, symbols are views of the parsed input and are not copied
+class SymbolInterner {
+public:
+    // id of the symbol, a new one if it is met for the first time
+    uint32_t Intern(std::string_view symbol) {
+        auto [it, inserted] = ids_.try_emplace(symbol, static_cast<uint32_t>(names_.size()));
+        if (inserted) {
+            names_.push_back(symbol);
+        }
+        return it->second;
+    }
+
+    [[nodiscard]] std::optional<uint32_t> Find(std::string_view symbol) const {
+        auto it = ids_.find(symbol);
+        if (it == ids_.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    [[nodiscard]] std::string_view GetName(uint32_t id) const {
+        return names_[id];
+    }
+
+    [[nodiscard]] size_t size() const {
+        return names_.size();
+    }
+
+private:
+    std::unordered_map<std::string_view, uint32_t> ids_;
+    std::vector<std::string_view> names_;
+};
+
+#endif //SYMBOL_INTERNER_H
@@ -1,14 +1,23 @@
 #include "tokenizer.h"
 
-#include <map>
+#include <charconv>
+#include <iterator>
+#include <unordered_map>
 
-Tokenizer::Tokenizer(std::istream* is) : is_(is) {
+Tokenizer::Tokenizer(std::string_view input) : input_(input) {
+    Next();
+}
+
+Tokenizer::Tokenizer(std::istream* is) : buffer_(std::istreambuf_iterator<char>(*is), std::istreambuf_iterator<char>()) {
+    input_ = buffer_;
     Next();
 }
 
 void Tokenizer::Next() {
-    *is_ >> std::ws;
-    int c = is_->peek();
+    while (pos_ < input_.size() && std::isspace(static_cast<unsigned char>(input_[pos_]))) {
+        ++pos_;
+    }
+    int c = Peek();
     if (c == EOF) {
         current_token_ = StreamEnd{};
         return;
@@ -23,47 +32,75 @@ void Tokenizer::Next() {
         return;
     }
     if (c == '#') {
-        is_->get();
-        if (!IsStartOfSymbol(is_->peek())) {
+        ++pos_;
+        if (!IsStartOfSymbol(Peek())) {
             throw std::runtime_error{"Tag is met, but expected a symbol right after"};
         }
         current_token_ = TaggedSymbolToken{ ReadSymbol() };
         return;
     }
+    if (c == '/') {
+        ++pos_;
+        if (Peek() == '\\') {
+            ++pos_;
+            current_token_ = ConjunctionToken{};
+        } else {
+            current_token_ = BinOp::DIVIDE;
+        }
+        return;
+    }
+    if (c == '\\') {
+        ++pos_;
+        if (Peek() != '/') {
+            throw std::runtime_error{"Expected '/' right after '\\' to form a disjunction"};
+        }
+        ++pos_;
+        current_token_ = DisjunctionToken{};
+        return;
+    }
     if (IsBinOp(c)) {
-        std::string bin_op;
-        bin_op += static_cast<char>(is_->get());
-        if (is_->peek() == '=') {
-            bin_op += static_cast<char>(is_->get());
+        size_t start = pos_++;
+        if (Peek() == '=') {
+            ++pos_;
         }
-        current_token_ = BinOp{GetBinOpToken(bin_op) };
+        current_token_ = BinOp{GetBinOpToken(input_.substr(start, pos_ - start)) };
         return;
     }
     if (c == '=') {
         current_token_ = ThreadLocalAssignmentToken{};
-        is_->get();
+        ++pos_;
         return;
     }
     if (c == ':') {
-        is_->get();
-        c = is_->peek();
-        if (c == '=') {
+        ++pos_;
+        if (Peek() == '=') {
             current_token_ = AssignmentToken{};
-            is_->get();
+            ++pos_;
         } else {
             current_token_ = ColonToken{};
         }
         return;
     }
-    if (c == ';') {
-        is_->get();
-        current_token_ = SemicolonToken{};
-        return;
+    ++pos_;
+    switch (c) {
+        case ';':
+            current_token_ = SemicolonToken{};
+            return;
+        case '(':
+            current_token_ = LeftParenthesisToken{};
+            return;
+        case ')':
+            current_token_ = RightParenthesisToken{};
+            return;
+        case '~':
+            current_token_ = NegationToken{};
+            return;
+        default:
+            throw std::runtime_error{"Faced unknown symbol when tokenizing input"};
     }
-    throw std::runtime_error{"Faced unknown symbol when tokenizing input"};
 }
 
-Token Tokenizer::GetToken() const {
+const Token& Tokenizer::GetToken() const {
     return current_token_;
 }
 
@@ -71,6 +108,10 @@ bool Tokenizer::IsDone() const {
     return std::holds_alternative<StreamEnd>(current_token_);
 }
 
+int Tokenizer::Peek() const {
+    return pos_ < input_.size() ? static_cast<unsigned char>(input_[pos_]) : EOF;
+}
+
 bool Tokenizer::IsStartOfNumber(int c) {
     return std::isdigit(c);
 }
@@ -102,25 +143,29 @@ bool Tokenizer::IsStartOfTaggedSymbol(int c) {
 }
 
 void Tokenizer::TryToConvertSymbolToKeyword() {
-    static std::map<std::string, KeywordToken> string_to_token = {
+    static const std::unordered_map<std::string_view, KeywordToken> string_to_token = {
             {"goto", KeywordToken::GOTO},
             {"if", KeywordToken::IF},
             {"cas", KeywordToken::CAS},
             {"fai", KeywordToken::FAI},
+            {"xchg", KeywordToken::XCHG},
+            {"fetch_or", KeywordToken::FETCH_OR},
             {"load", KeywordToken::LOAD},
             {"store", KeywordToken::STORE},
             {"fence", KeywordToken::FENCE},
             {"shared_state", KeywordToken::SHARED_STATE},
             {"reserve_space", KeywordToken::RESERVE_SPACE},
+            {"exists", KeywordToken::EXISTS},
+            {"forall", KeywordToken::FORALL},
             {"SEQ_CST", KeywordToken::SEQ_CST},
             {"REL", KeywordToken::REL},
             {"ACQ", KeywordToken::ACQ},
             {"REL_ACQ", KeywordToken::REL_ACQ},
             {"RLX", KeywordToken::RLX},
     };
-    std::string& val = std::get<SymbolToken>(current_token_).value;
-    if (string_to_token.find(val) != string_to_token.end()) {
-        this->current_token_ = string_to_token[val];
+    auto it = string_to_token.find(std::get<SymbolToken>(current_token_).value);
+    if (it != string_to_token.end()) {
+        this->current_token_ = it->second;
     }
 }
 
@@ -130,6 +175,10 @@ std::string KeywordToString(KeywordToken keyword) {
             return "cas";
         case FAI:
             return "fai";
+        case XCHG:
+            return "xchg";
+        case FETCH_OR:
+            return "fetch_or";
         case GOTO:
             return "goto";
         case IF:
@@ -154,6 +203,10 @@ std::string KeywordToString(KeywordToken keyword) {
             return "RLX";
         case FENCE:
             return "fence";
+        case EXISTS:
+            return "exists";
+        case FORALL:
+            return "forall";
         default:
             assert(false);
     }
@@ -183,12 +236,16 @@ std::string BinOpToString(BinOp op) {
 }
 
 ConstantToken::Type Tokenizer::ReadNumber() {
-    ConstantToken::Type num;
-    *is_ >> num;
+    ConstantToken::Type num = 0;
+    auto [end, error] = std::from_chars(input_.data() + pos_, input_.data() + input_.size(), num);
+    if (error != std::errc{}) {
+        throw std::runtime_error{"Constant is too large"};
+    }
+    pos_ = end - input_.data();
     return num;
 }
 
-BinOp Tokenizer::GetBinOpToken(std::string const& s) {
+BinOp Tokenizer::GetBinOpToken(std::string_view s) {
     assert(!s.empty());
     if (s.size() > 2) {
         throw std::runtime_error{"Binary operation token of unexpected size"};
@@ -222,14 +279,12 @@ BinOp Tokenizer::GetBinOpToken(std::string const& s) {
     throw std::runtime_error{"Unknown binary operation token of length 2"};
 }
 
-std::string Tokenizer::ReadSymbol() {
-    int c = is_->peek();
-    std::string value;
-    while (IsInternalOfSymbol(c)) {
-        value += static_cast<char>(is_->get());
-        c = is_->peek();
+std::string_view Tokenizer::ReadSymbol() {
+    size_t start = pos_;
+    while (pos_ < input_.size() && IsInternalOfSymbol(static_cast<unsigned char>(input_[pos_]))) {
+        ++pos_;
     }
-    return value;
+    return input_.substr(start, pos_ - start);
 }
 
 bool ThreadLocalAssignmentToken::operator==(const ThreadLocalAssignmentToken&) const {
@@ -263,3 +318,23 @@ bool SemicolonToken::operator==(const SemicolonToken&) const {
 bool ColonToken::operator==(const ColonToken&) const {
     return true;
 }
+
+bool LeftParenthesisToken::operator==(const LeftParenthesisToken&) const {
+    return true;
+}
+
+bool RightParenthesisToken::operator==(const RightParenthesisToken&) const {
+    return true;
+}
+
+bool ConjunctionToken::operator==(const ConjunctionToken&) const {
+    return true;
+}
+
+bool DisjunctionToken::operator==(const DisjunctionToken&) const {
+    return true;
+}
+
+bool NegationToken::operator==(const NegationToken&) const {
+    return true;
+}
@@ -4,6 +4,7 @@
 #include <istream>
 #include <variant>
 #include <string>
+#include <string_view>
 #include <cctype>
 #include <cassert>
 #include <exception>
@@ -13,7 +14,7 @@ enum BinOp {
 };
 
 enum KeywordToken {
-    CAS, FAI, GOTO, IF, SHARED_STATE, LOAD, STORE, SEQ_CST, REL_ACQ, REL, ACQ, RLX, FENCE, RESERVE_SPACE
+    CAS, FAI, GOTO, IF, SHARED_STATE, LOAD, STORE, SEQ_CST, REL_ACQ, REL, ACQ, RLX, FENCE, RESERVE_SPACE, EXISTS, FORALL, XCHG, FETCH_OR
 };
 
 struct ThreadLocalAssignmentToken {
@@ -24,15 +25,16 @@ struct AssignmentToken {
     bool operator==(const AssignmentToken&) const;
 };
 
+// symbols refer to the input of the tokenizer
 struct SymbolToken {
-    std::string value;
+    std::string_view value;
     bool operator==(const SymbolToken&) const;
 };
 
 // store tokens for which we have '#' right in front of them
 // (for instance, "#foo" will be stored here with value = "foo")
 struct TaggedSymbolToken {
-    std::string value;
+    std::string_view value;
     bool operator==(const TaggedSymbolToken&) const;
 };
 
@@ -54,6 +56,30 @@ struct ColonToken {
     bool operator==(const ColonToken&) const;
 };
 
+// tokens below are only used in the final condition clause (for instance, "exists (0:a = 1 /\ ~x = 2)")
+struct LeftParenthesisToken {
+    bool operator==(const LeftParenthesisToken&) const;
+};
+
+struct RightParenthesisToken {
+    bool operator==(const RightParenthesisToken&) const;
+};
+
+// "/\"
+struct ConjunctionToken {
+    bool operator==(const ConjunctionToken&) const;
+};
+
+// "\/"
+struct DisjunctionToken {
+    bool operator==(const DisjunctionToken&) const;
+};
+
+// "~"
+struct NegationToken {
+    bool operator==(const NegationToken&) const;
+};
+
 using Token = std::variant<
         ConstantToken,
         TaggedSymbolToken,
@@ -64,7 +90,12 @@ using Token = std::variant<
         SemicolonToken,
         ColonToken,
         StreamEnd,
-        KeywordToken>;
+        KeywordToken,
+        LeftParenthesisToken,
+        RightParenthesisToken,
+        ConjunctionToken,
+        DisjunctionToken,
+        NegationToken>;
 
 std::string KeywordToString(KeywordToken keyword);
 
@@ -72,11 +103,18 @@ std::string BinOpToString(BinOp op);
 
 class Tokenizer{
 public:
+    // tokens are views of the input, it has to outlive them
+    explicit Tokenizer(std::string_view input);
+
+    // reads the whole stream, tokens are views of the tokenizer's copy of it
     explicit Tokenizer(std::istream* is);
 
+    Tokenizer(const Tokenizer&) = delete;
+    Tokenizer& operator=(const Tokenizer&) = delete;
+
     void Next();
 
-    [[nodiscard]] Token GetToken() const;
+    [[nodiscard]] const Token& GetToken() const;
 
     [[nodiscard]] bool IsDone() const;
 
@@ -92,15 +130,19 @@ private:
 
     static bool IsStartOfTaggedSymbol(int c);
 
+    [[nodiscard]] int Peek() const;
+
     ConstantToken::Type ReadNumber();
 
-    static BinOp GetBinOpToken(std::string const& s);
+    static BinOp GetBinOpToken(std::string_view s);
 
     void TryToConvertSymbolToKeyword();
 
-    std::string ReadSymbol();
+    std::string_view ReadSymbol();
 
-    std::istream* is_;
+    std::string buffer_;
+    std::string_view input_;
+    size_t pos_ = 0;
     Token current_token_;
 };
 #endif //TOKENIZER_H
\ No newline at end of file
@@ -0,0 +1,407 @@
+#include "program_server.h"
+#include "../common/binary_program.h"
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// period of checking whether the server is stopped while waiting for connections and requests
+constexpr int kPollTimeoutMs = 100;
+// responses are sent in chunks of about that many bytes
+constexpr size_t kSendChunkSize = 1 << 14;
+
+std::vector<std::string> SplitWords(const std::string& line) {
+    std::istringstream is{line};
+    std::vector<std::string> words;
+    std::string word;
+    while (is >> word) {
+        words.push_back(std::move(word));
+    }
+    return words;
+}
+
+std::string FormatResult(const ExplorationResult& result, bool cached) {
+    std::ostringstream os;
+    os << "done " << GetExplorationStatusName(result.status) << " cached=" << cached;
+    os << " states=" << result.states << " executions=" << result.executions << " outcomes=" << result.outcomes;
+    os << " found=" << (result.found ? (*result.found ? "true" : "false") : "unknown");
+    os << " time_ms=" << result.time.count();
+    return os.str();
+}
+
+// writes the whole buffer, false if the peer has gone
+bool SendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t count = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        sent += count;
+    }
+    return true;
+}
+
+// client connection, closed once neither the accept thread nor a request of it holds it
+struct Connection {
+    explicit Connection(int fd)
+        : fd(fd) {
+    }
+
+    ~Connection() {
+        close(fd);
+    }
+
+    // adds a line to the response to request `index`, only the response to the oldest unanswered request is sent right away
+    void Write(size_t index, const std::string& line) {
+        std::lock_guard lock{mutex};
+        std::string& output = responses[index].output;
+        output += line;
+        output += '\n';
+        if (index == next_response && output.size() >= kSendChunkSize) {
+            Send(output);
+        }
+    }
+
+    // sends the responses completed so far in the order of their requests
+    void Complete(size_t index) {
+        std::lock_guard lock{mutex};
+        responses[index].complete = true;
+        for (auto it = responses.find(next_response); it != responses.end(); it = responses.find(next_response)) {
+            Send(it->second.output);
+            if (!it->second.complete) {
+                break;
+            }
+            responses.erase(it);
+            ++next_response;
+        }
+    }
+
+    int fd;
+    // read by the accept thread only: the incomplete last line and the number of requests read
+    std::string input;
+    size_t requests = 0;
+
+private:
+    struct Response {
+        std::string output;
+        bool complete = false;
+    };
+
+    void Send(std::string& output) {
+        connected = connected && SendAll(fd, output);
+        output.clear();
+    }
+
+    std::mutex mutex;
+    std::map<size_t, Response> responses;
+    size_t next_response = 0;
+    // false once the peer has gone, the rest of the responses is dropped
+    bool connected = true;
+};
+
+struct Request {
+    std::shared_ptr<Connection> connection;
+    // position among the requests of the connection
+    size_t index;
+    std::string line;
+};
+
+// requests read but not answered yet, of all connections
+struct RequestQueue {
+    void Push(Request request) {
+        {
+            std::lock_guard lock{mutex};
+            requests.push(std::move(request));
+        }
+        ready.notify_one();
+    }
+
+    // std::nullopt once the queue is closed, requests left in it are dropped
+    std::optional<Request> Pop() {
+        std::unique_lock lock{mutex};
+        ready.wait(lock, [this] () {
+            return closed || !requests.empty();
+        });
+        if (closed) {
+            return std::nullopt;
+        }
+        Request request = std::move(requests.front());
+        requests.pop();
+        return request;
+    }
+
+    void Close() {
+        {
+            std::lock_guard lock{mutex};
+            closed = true;
+        }
+        ready.notify_all();
+    }
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::queue<Request> requests;
+    bool closed = false;
+};
+
+// queues the complete lines received on the connection, false once the peer has closed it
+bool ReadRequests(const std::shared_ptr<Connection>& connection, RequestQueue& requests) {
+    char buffer[4096];
+    ssize_t count = recv(connection->fd, buffer, sizeof(buffer), 0);
+    if (count < 0 && errno == EINTR) {
+        return true;
+    }
+    if (count <= 0) {
+        return false;
+    }
+    std::string& input = connection->input;
+    input.append(buffer, count);
+    size_t line_start = 0;
+    for (size_t line_end = input.find('\n'); line_end != std::string::npos; line_end = input.find('\n', line_start)) {
+        requests.Push(Request{connection, connection->requests++, input.substr(line_start, line_end - line_start)});
+        line_start = line_end + 1;
+    }
+    input.erase(0, line_start);
+    return true;
+}
+
+}  // namespace
+
+bool ProgramServer::Handle(const std::string& request, const LineWriter& write) {
+    auto words = SplitWords(request);
+    if (words.empty()) {
+        return true;
+    }
+    try {
+        if (words[0] == "load") {
+            if (words.size() < 2) {
+                throw std::runtime_error{"Expected a program path"};
+            }
+            size_t path_start = request.find_first_not_of(" \t", request.find(words[0]) + words[0].size());
+            size_t path_end = request.find_last_not_of(" \t\r");
+            Load(request.substr(path_start, path_end + 1 - path_start), write);
+        } else if (words[0] == "explore") {
+            Explore(words, write);
+        } else if (words[0] == "shutdown") {
+            stopped_ = true;
+            write("done");
+            return false;
+        } else {
+            throw std::runtime_error{"Unknown request " + words[0]};
+        }
+    } catch (const std::exception& e) {
+        std::string message = e.what();
+        for (char& c : message) {
+            if (c == '\n') {
+                c = ' ';
+            }
+        }
+        write("error " + message);
+    }
+    return true;
+}
+
+void ProgramServer::Serve(const std::string& socket_path, size_t jobs) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error{"Socket path is too long: " + socket_path};
+    }
+    std::strcpy(address.sun_path, socket_path.c_str());
+    struct stat status{};
+    // a socket left by a previous server that was killed
+    if (lstat(socket_path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode)) {
+        unlink(socket_path.c_str());
+    }
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        throw std::runtime_error{"Can't create a socket"};
+    }
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listen_fd, SOMAXCONN) != 0) {
+        close(listen_fd);
+        throw std::runtime_error{"Can't listen on " + socket_path + ": " + std::strerror(errno)};
+    }
+
+    RequestQueue requests;
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < std::max<size_t>(jobs, 1); ++i) {
+        workers.emplace_back([this, &requests] () {
+            for (auto request = requests.Pop(); request; request = requests.Pop()) {
+                Connection& connection = *request->connection;
+                size_t index = request->index;
+                bool running = Handle(request->line, [&connection, index] (const std::string& line) {
+                    connection.Write(index, line);
+                });
+                connection.Complete(index);
+                if (!running) {
+                    requests.Close();
+                }
+            }
+        });
+    }
+    // connections are only read here, so an idle client doesn't hold a worker
+    std::vector<std::shared_ptr<Connection>> connections;
+    std::vector<pollfd> polls;
+    while (!stopped_) {
+        polls.assign(1, pollfd{listen_fd, POLLIN, 0});
+        for (auto& connection : connections) {
+            polls.push_back(pollfd{connection->fd, POLLIN, 0});
+        }
+        if (poll(polls.data(), polls.size(), kPollTimeoutMs) <= 0) {
+            continue;
+        }
+        size_t open = 0;
+        for (size_t i = 0; i < connections.size(); ++i) {
+            if (polls[i + 1].revents == 0 || ReadRequests(connections[i], requests)) {
+                connections[open++] = std::move(connections[i]);
+            }
+        }
+        connections.resize(open);
+        if (polls[0].revents & POLLIN) {
+            int fd = accept(listen_fd, nullptr, nullptr);
+            if (fd >= 0) {
+                connections.push_back(std::make_shared<Connection>(fd));
+            }
+        }
+    }
+    requests.Close();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    connections.clear();
+    close(listen_fd);
+    unlink(socket_path.c_str());
+}
+
+void ProgramServer::Load(const std::string& path, const LineWriter& write) {
+    long long modification_time = std::filesystem::last_write_time(path).time_since_epoch().count();
+    ProgramPtr program;
+    std::string hash;
+    {
+        std::lock_guard lock{mutex_};
+        auto file = files_.find(path);
+        if (file != files_.end() && file->second.modification_time == modification_time) {
+            hash = file->second.hash;
+            program = programs_.at(hash);
+        }
+    }
+    if (!program) {
+        // parsing is done without the lock, a file loaded twice concurrently ends up with the same entry
+        program = OpenProgram(path);
+        hash = FormatHash(GetProgramHash(program->descriptor));
+        std::lock_guard lock{mutex_};
+        program = programs_.emplace(hash, program).first->second;
+        files_[path] = CachedFile{modification_time, hash};
+    }
+    std::string response = "program " + hash;
+    for (size_t ip : program->instruction_pointers) {
+        response += ' ' + std::to_string(ip);
+    }
+    write(response);
+}
+
+void ProgramServer::Explore(const std::vector<std::string>& words, const LineWriter& write) {
+    if (words.size() < 4) {
+        throw std::runtime_error{"Expected a program hash, an execution mode and a model"};
+    }
+    ProgramPtr program = GetProgram(words[1]);
+    ExplorationConfig config;
+    if (words[2] == "graph") {
+        config.mode = ExplorationMode::GRAPH;
+    } else if (words[2] == "mc") {
+        config.mode = ExplorationMode::OPERATIONAL;
+    } else {
+        throw std::runtime_error{"Unsupported execution mode " + words[2] + ", expected graph or mc"};
+    }
+    config.model = words[3];
+    for (size_t i = 4; i < words.size(); ++i) {
+        const std::string& word = words[i];
+        try {
+            if (word.rfind("max-states=", 0) == 0) {
+                config.max_states = std::stoull(word.substr(11));
+            } else if (word.rfind("time-limit-ms=", 0) == 0) {
+                config.time_limit = std::chrono::milliseconds{std::stoull(word.substr(14))};
+            } else if (word.rfind("memory-limit-mb=", 0) == 0) {
+                config.memory_limit_bytes = std::stoull(word.substr(16)) << 20;
+            } else if (word == "all-outcomes") {
+                config.stop_at_target = false;
+            } else if (word == "await-spin-loops") {
+                config.options.await_spin_loops = true;
+            } else if (word == "eager-private-propagation") {
+                config.options.eager_private_propagation = true;
+            } else {
+                config.instruction_pointers.push_back(std::stoull(word));
+            }
+        } catch (const std::logic_error&) {
+            throw std::runtime_error{"Unexpected " + word};
+        }
+    }
+    Exploration exploration{program, std::move(config)};
+
+    std::string key = GetExplorationKey(std::stoull(words[1], nullptr, 16), exploration.GetConfig());
+    std::optional<ExplorationRecord> cached;
+    {
+        std::lock_guard lock{mutex_};
+        auto it = results_.find(key);
+        if (it != results_.end()) {
+            cached = it->second;
+        }
+    }
+    if (cached) {
+        for (auto& outcome : cached->outcomes) {
+            write("outcome " + outcome);
+        }
+        write(FormatResult(cached->result, true));
+        return;
+    }
+
+    ExplorationRecord record = RecordExploration(exploration, program->descriptor, [&] (const std::string& outcome) {
+        write("outcome " + outcome);
+        return !stopped_;
+    });
+    write(FormatResult(record.result, false));
+    if (IsReproducible(record.result.status)) {
+        CacheResult(key, std::move(record));
+    }
+}
+
+ProgramPtr ProgramServer::GetProgram(const std::string& hash) {
+    std::lock_guard lock{mutex_};
+    auto it = programs_.find(hash);
+    if (it == programs_.end()) {
+        throw std::runtime_error{"Unknown program " + hash + ", it should be loaded first"};
+    }
+    return it->second;
+}
+
+void ProgramServer::CacheResult(const std::string& key, ExplorationRecord record) {
+    std::lock_guard lock{mutex_};
+    if (!results_.emplace(key, std::move(record)).second) {
+        return;
+    }
+    results_order_.push_back(key);
+    if (results_order_.size() > kMaxCachedResults) {
+        results_.erase(results_order_.front());
+        results_order_.pop_front();
+    }
+}
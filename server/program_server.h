@@ -0,0 +1,63 @@
+#ifndef PROGRAM_SERVER_H
+#define PROGRAM_SERVER_H
+#include "../api/exploration.h"
+#include "../cache/outcome_cache.h"
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Daemon answering queries about programs it keeps loaded. Requests are lines of text, the response to each of
+ * them is a sequence of lines ending with "done ..." or "error <message>":
+ *
+ *   load <path>                  -> program <hash> <instruction_pointers...>
+ *   explore <hash> <graph|mc> <model> [instruction_pointers...] [max-states=N] [time-limit-ms=N]
+ *           [memory-limit-mb=N] [all-outcomes] [await-spin-loops] [eager-private-propagation]
+ *                                -> outcome <outcome>... done <status> cached=<0|1> states=N executions=N
+ *                                   outcomes=N found=<true|false|unknown> time_ms=N
+ *   shutdown                     -> done
+ *
+ * Programs are cached by the hash of their compiled form, files by their path and modification time, so a
+ * changed file is loaded again. A cached program keeps its bytecode and analyses for the mc explorations. Results of reproducible explorations (see IsReproducible) are cached too,
+ * by GetExplorationKey, and streamed back without exploring.
+ */
+struct ProgramServer {
+    // called with every line of a response, without the line break
+    using LineWriter = std::function<void(const std::string&)>;
+
+    // handles a single request, errors are reported as responses; false once the server should stop
+    bool Handle(const std::string& request, const LineWriter& write);
+
+    // accepts connections on the socket and reads their requests on the calling thread, the requests run on `jobs`
+    // threads until a shutdown request; requests of a connection may run concurrently, responses keep their order
+    void Serve(const std::string& socket_path, size_t jobs);
+
+private:
+    struct CachedFile {
+        long long modification_time;
+        std::string hash;
+    };
+
+    void Load(const std::string& path, const LineWriter& write);
+    void Explore(const std::vector<std::string>& words, const LineWriter& write);
+    ProgramPtr GetProgram(const std::string& hash);
+    void CacheResult(const std::string& key, ExplorationRecord record);
+
+    // bounds the memory kept by results of explorations, the oldest ones are dropped first
+    static constexpr size_t kMaxCachedResults = 4096;
+
+    std::mutex mutex_;
+    std::map<std::string, ProgramPtr> programs_;
+    std::map<std::string, CachedFile> files_;
+    std::map<std::string, ExplorationRecord> results_;
+    std::deque<std::string> results_order_;
+    std::atomic<bool> stopped_{false};
+};
+
+#endif //PROGRAM_SERVER_H
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <unistd.h>
+
+#include "../batch/batch_runner.h"
+#include "../generator/program_family.h"
+
+namespace {
+
+std::filesystem::path CreateDirectory(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / (name + std::to_string(getpid()));
+    std::filesystem::remove_all(path);
+    std::filesystem::create_directories(path);
+    return path;
+}
+
+}  // namespace
+
+TEST(TestBatchRunner, Statuses) {
+    auto directory = CreateDirectory("wmm-batch-test");
+    // big enough to run out of any time budget
+    FamilyParameters parameters;
+    parameters.threads = 4;
+    parameters.depth = 3;
+    GeneratedProgram generated = GenerateFamily("counter-fai", parameters);
+    std::ofstream{directory / "counter.txt"} << generated.program;
+    std::string store_buffering = std::string{WMM_EXAMPLES_DIR} + "/store_buffering.txt";
+    {
+        std::ofstream manifest{directory / "manifest"};
+        manifest << "# a test of every status\n";
+        manifest << store_buffering << " tso 0 6 outcomes=4\n";
+        manifest << store_buffering << " sc 0 6 outcomes=4\n";
+        manifest << "counter.txt pso";
+        for (size_t ip : generated.instruction_pointers) {
+            manifest << ' ' << ip;
+        }
+        manifest << " time-limit-ms=0\n";
+        manifest << "\n";
+        manifest << store_buffering << " tso 0 six\n";
+    }
+
+    auto tests = ReadManifest(directory.string());
+    ASSERT_EQ(tests.size(), 4);
+    EXPECT_EQ(tests[2].path, (directory / "counter.txt").string());
+    EXPECT_EQ(tests[3].error, "Manifest " + (directory / "manifest").string() + ":6: unexpected six");
+
+    BatchOptions options;
+    options.jobs = 2;
+    auto results = RunBatch(tests, options);
+    ASSERT_EQ(results.size(), 4);
+    EXPECT_EQ(results[0].status, BatchStatus::PASSED) << results[0].message;
+    EXPECT_EQ(results[0].outcomes.size(), 4);
+    EXPECT_EQ(results[1].status, BatchStatus::FAILED);
+    EXPECT_EQ(results[1].message, "Expected 4 distinct outcomes, found 3");
+    EXPECT_EQ(results[2].status, BatchStatus::TIMEOUT);
+    EXPECT_EQ(results[3].status, BatchStatus::ERROR);
+    EXPECT_EQ(results[3].message, tests[3].error);
+
+    std::ostringstream report;
+    WriteBatchReport(report, tests, results);
+    EXPECT_NE(report.str().find(R"("summary": {"passed": 1, "failed": 1, "timeout": 1, "memory-limit": 0, "error": 1})"), std::string::npos);
+    std::filesystem::remove_all(directory);
+}
+
+TEST(TestBatchRunner, MissingManifest) {
+    auto directory = CreateDirectory("wmm-batch-missing");
+    EXPECT_THROW(ReadManifest(directory.string()), std::runtime_error);
+    std::filesystem::remove_all(directory);
+}
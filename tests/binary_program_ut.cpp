@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <variant>
+
+#include "../common/binary_program.h"
+#include "../parser/parser.h"
+
+namespace {
+
+const std::string kProgram = R""""(
+            shared_state: x y;
+            reserve_space: 2;
+            one = 1;
+            x_loc = x;
+            start: store REL #x_loc one;
+            old := cas SEQ_CST #x_loc one one;
+            prev := xchg RLX #x_loc one;
+            sum := fai ACQ #x_loc one;
+            load SEQ_CST #x_loc value;
+            fence REL_ACQ;
+            less = value < one;
+            if less goto start;
+            exists (0:value = 1 /\ ~(x = 2 \/ y = 0));
+            )"""";
+
+std::string Compile(const ProgramDescriptor& descriptor) {
+    std::stringstream ss;
+    WriteBinaryProgram(ss, descriptor);
+    return ss.str();
+}
+
+// message of the error the compiled program is rejected with
+std::string GetLoadError(const ProgramDescriptor& descriptor) {
+    try {
+        ReadBinaryProgram(Compile(descriptor));
+    } catch (const std::runtime_error& e) {
+        return e.what();
+    }
+    return "";
+}
+
+}  // namespace
+
+TEST(TestBinaryProgram, RoundTrip) {
+    auto descriptor = Parse(std::string_view{kProgram});
+    std::string compiled = Compile(descriptor);
+    EXPECT_TRUE(IsBinaryProgram(compiled));
+    EXPECT_FALSE(IsBinaryProgram(kProgram));
+
+    auto loaded = ReadBinaryProgram(compiled);
+    EXPECT_EQ(loaded.memory_size, descriptor.memory_size);
+    EXPECT_EQ(loaded.memory_name, descriptor.memory_name);
+    EXPECT_EQ(loaded.register_name, descriptor.register_name);
+    ASSERT_EQ(loaded.instructions.size(), descriptor.instructions.size());
+    ASSERT_EQ(loaded.instructions_str.size(), descriptor.instructions_str.size());
+    for (size_t ip = 0; ip < descriptor.instructions.size(); ++ip) {
+        EXPECT_EQ(loaded.instructions[ip].index(), descriptor.instructions[ip].index());
+        EXPECT_EQ(loaded.instructions_str[ip], descriptor.instructions_str[ip]);
+    }
+    auto& cas = std::get<CasInstruction>(loaded.instructions[3]);
+    EXPECT_EQ(cas.mode, AccessMode::SEQ_CST);
+    EXPECT_EQ(std::get<FetchOpInstruction>(loaded.instructions[4]).kind, RmwKind::EXCHANGE);
+    EXPECT_EQ(std::get<IfInstruction>(loaded.instructions[9]).instr_on_success, 2);
+
+    ASSERT_TRUE(loaded.final_condition.has_value());
+    std::stringstream expected_condition, loaded_condition;
+    descriptor.final_condition->Print(expected_condition, descriptor.memory_name, descriptor.register_name);
+    loaded.final_condition->Print(loaded_condition, loaded.memory_name, loaded.register_name);
+    EXPECT_EQ(loaded_condition.str(), expected_condition.str());
+
+    EXPECT_EQ(Compile(loaded), compiled);
+    EXPECT_EQ(GetProgramHash(loaded), GetProgramHash(descriptor));
+}
+
+TEST(TestBinaryProgram, HashDependsOnProgram) {
+    auto descriptor = Parse(std::string_view{kProgram});
+    auto other = Parse(std::string_view{"one = 2;"});
+    EXPECT_NE(GetProgramHash(descriptor), GetProgramHash(other));
+}
+
+TEST(TestBinaryProgram, CorruptedPayload) {
+    std::string compiled = Compile(Parse(std::string_view{kProgram}));
+    compiled[compiled.size() / 2] ^= 1;
+    EXPECT_THROW(ReadBinaryProgram(compiled), std::runtime_error);
+}
+
+TEST(TestBinaryProgram, TruncatedPayload) {
+    std::string compiled = Compile(Parse(std::string_view{kProgram}));
+    EXPECT_THROW(ReadBinaryProgram(compiled.substr(0, compiled.size() - 1)), std::runtime_error);
+    EXPECT_THROW(ReadBinaryProgram(compiled.substr(0, 6)), std::runtime_error);
+}
+
+TEST(TestBinaryProgram, UnsupportedVersion) {
+    std::string compiled = Compile(Parse(std::string_view{kProgram}));
+    compiled[4] = static_cast<char>(kBinaryProgramVersion + 1);
+    EXPECT_THROW(ReadBinaryProgram(compiled), std::runtime_error);
+}
+
+TEST(TestBinaryProgram, InvalidIndices) {
+    // the hash is recomputed by the writer, so only the checks of the contents reject these programs
+    auto descriptor = Parse(std::string_view{kProgram});
+    auto& nodes = descriptor.final_condition->nodes;
+    auto atom = std::find_if(nodes.begin(), nodes.end(), [] (const ConditionNode& node) { return std::holds_alternative<RegisterEquals>(node); });
+    ASSERT_NE(atom, nodes.end());
+    std::get<RegisterEquals>(*atom).reg = descriptor.register_name.size();
+    EXPECT_EQ(GetLoadError(descriptor), "Compiled program has an invalid final condition");
+
+    descriptor = Parse(std::string_view{kProgram});
+    std::get<IfInstruction>(descriptor.instructions[9]).instr_on_success = descriptor.instructions.size() + 1;
+    EXPECT_EQ(GetLoadError(descriptor), "Compiled program has an invalid jump target");
+
+    descriptor = Parse(std::string_view{kProgram});
+    std::get<LoadInstruction>(descriptor.instructions[6]).dst = descriptor.register_name.size();
+    EXPECT_EQ(GetLoadError(descriptor), "Compiled program has an invalid register");
+
+    // text of one instruction less than the program has
+    descriptor = Parse(std::string_view{kProgram});
+    descriptor.instructions.emplace_back(FenceInstruction{AccessMode::SEQ_CST});
+    EXPECT_EQ(GetLoadError(descriptor), "Compiled program has an invalid instruction text");
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "../instruction/bytecode.h"
+#include "../parser/parser.h"
+
+namespace {
+
+ProgramDescriptor ParseProgram(const std::string& program) {
+    std::stringstream ss{program};
+    return Parse(&ss);
+}
+
+}  // namespace
+
+TEST(TestBytecode, CompilesEveryInstruction) {
+    auto descriptor = ParseProgram(R""""(
+                shared_state: x;
+                a = x;
+                b = 5;
+                c = a + b;
+                store REL #a b;
+                load ACQ #a d;
+                r := cas SEQ_CST #a b c;
+                r := fai RLX #a b;
+                r := xchg RLX #a b;
+                fence SEQ_CST;
+                if r goto end;
+                end: b = 1;
+                )"""");
+    Bytecode bytecode = CompileBytecode(descriptor);
+    ASSERT_EQ(bytecode.ops.size(), descriptor.instructions.size());
+    EXPECT_EQ(bytecode.registers_cnt, descriptor.register_name.size());
+    Opcode expected[] = {Opcode::SET_CONSTANT, Opcode::SET_CONSTANT, Opcode::BIN_OP, Opcode::STORE, Opcode::LOAD, Opcode::CAS,
+                         Opcode::FETCH_OP, Opcode::FETCH_OP, Opcode::FENCE, Opcode::JUMP_IF, Opcode::SET_CONSTANT};
+    for (size_t ip = 0; ip < bytecode.ops.size(); ++ip) {
+        EXPECT_EQ(bytecode.ops[ip].opcode, expected[ip]) << "ip " << ip;
+    }
+    EXPECT_EQ(bytecode.ops[3].mode, AccessMode::REL);
+    EXPECT_EQ(bytecode.ops[6].rmw_kind, RmwKind::FETCH_ADD);
+    EXPECT_EQ(bytecode.ops[7].rmw_kind, RmwKind::EXCHANGE);
+    EXPECT_EQ(bytecode.ops[9].target, 10);
+    EXPECT_EQ(bytecode.constants[bytecode.ops[1].lhs], 5);
+}
+
+TEST(TestBytecode, RejectsInvalidRegistersAndTargets) {
+    auto descriptor = ParseProgram(R""""(
+                r = 1;
+                if r goto end;
+                end: r = 2;
+                )"""");
+    auto bad_register = descriptor;
+    bad_register.instructions[0] = RegisterConstantAssignment{descriptor.register_name.size(), 1};
+    EXPECT_THROW(CompileBytecode(bad_register), std::runtime_error);
+    auto bad_target = descriptor;
+    bad_target.instructions[1] = IfInstruction{0, descriptor.instructions.size() + 1};
+    EXPECT_THROW(CompileBytecode(bad_target), std::runtime_error);
+}
+
+TEST(TestBytecode, RunsThreadLocalOps) {
+    auto descriptor = ParseProgram(R""""(
+                shared_state: x;
+                one = 1;
+                i = 0;
+                loop:
+                    i = i + one;
+                    c = i < one;
+                    if c goto loop;
+                    if one goto loop;
+                a = x;
+                load RLX #a v;
+                )"""");
+    Bytecode bytecode = CompileBytecode(descriptor);
+    std::vector<uint64_t> registers(bytecode.registers_cnt, 0);
+    // stops at the jump back that is taken
+    EXPECT_EQ(RunThreadLocalOps(bytecode, registers.data(), 0), 5);
+    // stops at the memory access
+    EXPECT_EQ(RunThreadLocalOps(bytecode, registers.data(), 6), 7);
+    EXPECT_EQ(RunThreadLocalOps(bytecode, registers.data(), 8), 8);
+}
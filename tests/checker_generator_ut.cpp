@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "../api/exploration.h"
+#include "../codegen/checker_generator.h"
+
+namespace {
+
+struct Example {
+    std::string file;
+    std::vector<size_t> instruction_pointers;
+};
+
+const std::vector<Example> kExamples = {
+        {"store_buffering.txt", {0, 6}},
+        {"simple_pso.txt", {0, 6}},
+        {"spin_lock.txt", {0, 14}},
+        {"private_scratch.txt", {0, 10}},
+        {"simple_mc.txt", {0}},
+};
+
+std::set<std::string> ExploreOutcomes(const ProgramPtr& program, const std::string& model) {
+    ExplorationConfig config;
+    config.mode = ExplorationMode::OPERATIONAL;
+    config.model = model;
+    config.stop_at_target = false;
+    std::set<std::string> outcomes;
+    ExplorationCallbacks callbacks;
+    callbacks.on_outcome = [&] (const Outcome& outcome) {
+        outcomes.insert(FormatOutcome(program->descriptor, outcome));
+        return true;
+    };
+    EXPECT_EQ(Exploration(program, config).Run(callbacks).status, ExplorationStatus::COMPLETED);
+    return outcomes;
+}
+
+// generates, compiles and runs the checker, returns the final states it prints
+std::set<std::string> RunChecker(const ProgramDescriptor& descriptor, const std::vector<size_t>& instruction_pointers, const std::string& model) {
+    auto base = std::filesystem::temp_directory_path() / ("wmm_checker" + std::to_string(getpid()));
+    std::string source = base.string() + ".cpp";
+    std::string binary = base.string();
+    {
+        std::ofstream output{source};
+        GenerateChecker(output, descriptor, instruction_pointers, ParseMemoryModel(model));
+    }
+    std::string compile = std::string{WMM_CXX_COMPILER} + " -std=c++17 -O1 -o " + binary + " " + source;
+    EXPECT_EQ(std::system(compile.c_str()), 0) << compile;
+    std::set<std::string> outcomes;
+    FILE* checker = popen(binary.c_str(), "r");
+    EXPECT_NE(checker, nullptr);
+    if (!checker) {
+        return outcomes;
+    }
+    const std::string prefix = "Final state: ";
+    std::string line;
+    for (int c; (c = std::fgetc(checker)) != EOF; ) {
+        if (c != '\n') {
+            line += static_cast<char>(c);
+            continue;
+        }
+        if (line.rfind(prefix, 0) == 0) {
+            // values are separated and followed by spaces
+            outcomes.insert(line.substr(prefix.size(), line.size() - prefix.size() - 1));
+        }
+        line.clear();
+    }
+    EXPECT_EQ(pclose(checker), 0);
+    std::filesystem::remove(source);
+    std::filesystem::remove(binary);
+    return outcomes;
+}
+
+}  // namespace
+
+TEST(TestCheckerGenerator, MatchesModelChecking) {
+    for (auto& example : kExamples) {
+        auto program = OpenProgram(std::string{WMM_EXAMPLES_DIR} + "/" + example.file);
+        // without the final condition the checker prints every final state
+        ProgramDescriptor descriptor = program->descriptor;
+        descriptor.final_condition.reset();
+        auto unconditional = CreateProgram(descriptor, example.instruction_pointers);
+        for (std::string model : {"sc", "tso", "pso"}) {
+            auto expected = ExploreOutcomes(unconditional, model);
+            EXPECT_FALSE(expected.empty()) << example.file << ' ' << model;
+            EXPECT_EQ(RunChecker(descriptor, example.instruction_pointers, model), expected) << example.file << ' ' << model;
+        }
+    }
+}
@@ -0,0 +1,137 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "../executors/thread_step.h"
+#include "../memory_subsystem/pso/pso_memory_subsystem.h"
+#include "../memory_subsystem/sc/sc_memory_subsystem.h"
+#include "../memory_subsystem/tso/tso_memory_subsystem.h"
+#include "../parser/parser.h"
+
+namespace {
+
+// endless loop of memory accesses, the fence drains store buffers so that they don't grow
+const std::string kProgram = R""""(
+        shared_state: x y;
+        one = 1;
+        i = 0;
+        x_loc = x;
+        y_loc = y;
+        loop:
+            store RLX #x_loc i;
+            fence SEQ_CST;
+            load RLX #y_loc a;
+            old := fai RLX #y_loc one;
+            i = i + one;
+            if one goto loop;
+        )"""";
+
+// lock acquired and released with compare-and-swap over and over
+const std::string kCasProgram = R""""(
+        shared_state: lock;
+        zero = 0;
+        one = 1;
+        lock_loc = lock;
+        loop:
+            taken := cas SEQ_CST #lock_loc zero one;
+            released := cas SEQ_CST #lock_loc one zero;
+            if one goto loop;
+        )"""";
+
+// register computations only, as between the memory accesses of a long single-thread section
+const std::string kLocalProgram = R""""(
+        one = 1;
+        i = 0;
+        s = 0;
+        loop:
+            i = i + one;
+            s = s + i;
+            s = s * one;
+            c = i > s;
+            if c goto loop;
+            if one goto loop;
+        )"""";
+
+ProgramDescriptor ParseProgram(const std::string& program = kProgram) {
+    std::stringstream ss{program};
+    return Parse(&ss);
+}
+
+// the subsystem is only reachable through a pointer to the base, as in the executors,
+// its dynamic type is hidden from the optimizer so that virtual calls are not devirtualized
+template <typename Model>
+std::unique_ptr<MemorySubsystem> CreateMemory(const ProgramDescriptor& descriptor) {
+    std::unique_ptr<MemorySubsystem> memory = std::make_unique<Model>(descriptor, 1);
+    benchmark::DoNotOptimize(memory.get());
+    benchmark::ClobberMemory();
+    return memory;
+}
+
+template <typename Model>
+void BM_ThreadSteps(benchmark::State& state) {
+    ProgramDescriptor descriptor = ParseProgram();
+    Bytecode bytecode = CompileBytecode(descriptor);
+    Thread thread(descriptor, 0);
+    auto memory = CreateMemory<Model>(descriptor);
+    for (auto _ : state) {
+        ExecuteThreadStep(bytecode, thread, *memory, 0);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Model>
+void BM_CasThreadSteps(benchmark::State& state) {
+    ProgramDescriptor descriptor = ParseProgram(kCasProgram);
+    Thread thread(descriptor, 0);
+    auto memory = CreateMemory<Model>(descriptor);
+    Bytecode bytecode = CompileBytecode(descriptor);
+    for (auto _ : state) {
+        ExecuteThreadStep(bytecode, thread, *memory, 0);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Model>
+void BM_LocalThreadSteps(benchmark::State& state) {
+    ProgramDescriptor descriptor = ParseProgram(kLocalProgram);
+    Bytecode bytecode = CompileBytecode(descriptor);
+    Thread thread(descriptor, 0);
+    auto memory = CreateMemory<Model>(descriptor);
+    for (auto _ : state) {
+        ExecuteThreadStep(bytecode, thread, *memory, 0);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// whole thread-local sections at once, as the execution graph exploration runs them
+void BM_LocalSections(benchmark::State& state) {
+    ProgramDescriptor descriptor = ParseProgram(kLocalProgram);
+    Bytecode bytecode = CompileBytecode(descriptor);
+    Thread thread(descriptor, 0);
+    size_t ip = 0;
+    size_t steps = 0;
+    for (auto _ : state) {
+        size_t next = RunThreadLocalOps(bytecode, thread.GetRegisterFile(), ip);
+        // sections are straight-line code (s >= i, the first jump is never taken) ending with the jump back
+        steps += next - ip + 1;
+        ip = bytecode.ops[next].target;
+    }
+    state.SetItemsProcessed(steps);
+}
+
+}  // namespace
+
+BENCHMARK(BM_ThreadSteps<ScMemorySubsystem>);
+BENCHMARK(BM_ThreadSteps<TsoMemorySubsystem>);
+BENCHMARK(BM_ThreadSteps<PsoMemorySubsystem>);
+
+BENCHMARK(BM_CasThreadSteps<ScMemorySubsystem>);
+BENCHMARK(BM_CasThreadSteps<TsoMemorySubsystem>);
+BENCHMARK(BM_CasThreadSteps<PsoMemorySubsystem>);
+
+BENCHMARK(BM_LocalThreadSteps<ScMemorySubsystem>);
+BENCHMARK(BM_LocalSections);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "../analysis/liveness.h"
+#include "../analysis/shared_access.h"
+#include "../api/exploration.h"
+#include "../parser/parser.h"
+
+namespace {
+
+struct Example {
+    std::string file;
+    std::vector<size_t> instruction_pointers;
+};
+
+const std::vector<Example> kExamples = {
+        {"store_buffering.txt", {0, 6}},
+        {"simple_pso.txt", {0, 6}},
+        {"spin_lock.txt", {0, 14}},
+        {"private_scratch.txt", {0, 10}},
+};
+
+const std::string kOverwrittenRegister = R""""(
+            shared_state: x;
+            a = 1;
+            b = a + a;
+            a = 2;
+            exists (0:b = 2);
+            )"""";
+
+Register FindRegister(const ProgramDescriptor& descriptor, const std::string& name) {
+    for (Register reg = 0; reg < descriptor.register_name.size(); ++reg) {
+        if (descriptor.register_name[reg] == name) {
+            return reg;
+        }
+    }
+    throw std::runtime_error{"Unknown register " + name};
+}
+
+// outcomes of the mc mode, registers the final condition doesn't mention are cleared when `project` is set
+std::set<Outcome> CollectOutcomes(const ProgramPtr& program, const Example& example, const std::string& model,
+                                  const ExplorationOptions& options, bool project) {
+    ExplorationConfig config;
+    config.mode = ExplorationMode::OPERATIONAL;
+    config.model = model;
+    config.instruction_pointers = example.instruction_pointers;
+    config.options = options;
+    config.stop_at_target = false;
+    auto& descriptor = program->descriptor;
+    std::set<Outcome> outcomes;
+    ExplorationCallbacks callbacks;
+    callbacks.on_outcome = [&] (const Outcome& outcome) {
+        Outcome projected = outcome;
+        for (size_t tid = 0; project && tid < projected.registers.size(); ++tid) {
+            for (Register reg = 0; reg < projected.registers[tid].size(); ++reg) {
+                bool mentioned = false;
+                for (auto& node : descriptor.final_condition->nodes) {
+                    if (auto atom = std::get_if<RegisterEquals>(&node); atom && atom->thread_id == tid && atom->reg == reg) {
+                        mentioned = true;
+                    }
+                }
+                if (!mentioned) {
+                    projected.registers[tid][reg] = 0;
+                }
+            }
+        }
+        outcomes.insert(projected);
+        return true;
+    };
+    EXPECT_EQ(Exploration(program, config).Run(callbacks).status, ExplorationStatus::COMPLETED);
+    return outcomes;
+}
+
+}  // namespace
+
+TEST(TestExplorationOptions, LiveRegisters) {
+    ProgramDescriptor descriptor = Parse(std::string_view{kOverwrittenRegister});
+    Register a = FindRegister(descriptor, "a");
+    Register b = FindRegister(descriptor, "b");
+    LivenessInfo all = ComputeLiveness(descriptor, 1, false);
+    EXPECT_EQ(all.live_registers[0][0], std::vector<Register>{});
+    EXPECT_EQ(all.live_registers[0][1], std::vector<Register>{a});
+    EXPECT_EQ(all.live_registers[0][2], std::vector<Register>{b});
+    EXPECT_EQ(all.live_registers[0][3].size(), descriptor.register_name.size());
+    LivenessInfo verdict = ComputeLiveness(descriptor, 1, true);
+    EXPECT_EQ(verdict.live_registers[0][2], std::vector<Register>{b});
+    EXPECT_EQ(verdict.live_registers[0][3], std::vector<Register>{b});
+}
+
+TEST(TestExplorationOptions, VerdictOnly) {
+    for (auto& example : kExamples) {
+        auto program = OpenProgram(std::string{WMM_EXAMPLES_DIR} + "/" + example.file);
+        if (!program->descriptor.final_condition) {
+            continue;
+        }
+        ExplorationOptions options;
+        ExplorationOptions verdict_only;
+        verdict_only.verdict_only = true;
+        for (std::string model : {"sc", "tso", "pso"}) {
+            // outcomes merged by masking differ only in registers the final condition doesn't read
+            EXPECT_EQ(CollectOutcomes(program, example, model, verdict_only, true), CollectOutcomes(program, example, model, options, true))
+                << example.file << ' ' << model;
+            EXPECT_LE(CollectOutcomes(program, example, model, verdict_only, false).size(), CollectOutcomes(program, example, model, options, false).size())
+                << example.file << ' ' << model;
+        }
+    }
+}
+
+TEST(TestExplorationOptions, PrivateCells) {
+    auto program = OpenProgram(std::string{WMM_EXAMPLES_DIR} + "/private_scratch.txt");
+    SharedAccessInfo info = AnalyzeSharedAccess(program->descriptor, {0, 10});
+    // x and y are shared, each thread owns one of the reserved cells
+    ASSERT_EQ(info.owner.size(), 4);
+    EXPECT_FALSE(info.IsPrivate(0));
+    EXPECT_FALSE(info.IsPrivate(1));
+    EXPECT_EQ(info.owner[2], 0);
+    EXPECT_EQ(info.owner[3], 1);
+}
+
+TEST(TestExplorationOptions, EagerPrivatePropagation) {
+    ExplorationOptions options;
+    ExplorationOptions eager;
+    eager.eager_private_propagation = true;
+    for (auto& example : kExamples) {
+        auto program = OpenProgram(std::string{WMM_EXAMPLES_DIR} + "/" + example.file);
+        for (std::string model : {"sc", "tso", "pso"}) {
+            EXPECT_EQ(CollectOutcomes(program, example, model, eager, false), CollectOutcomes(program, example, model, options, false))
+                << example.file << ' ' << model;
+        }
+    }
+}
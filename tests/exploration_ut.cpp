@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../api/exploration.h"
+#include "../executors/best_first_executor.h"
+#include "../memory_subsystem/memory_subsystem_factory.h"
+#include "../parser/parser.h"
+
+namespace {
+
+const std::string kStoreBuffering = R""""(
+            shared_state: x y;
+            r = 1;
+            x_loc = x;
+            y_loc = y;
+            store RLX #x_loc r;
+            load RLX #y_loc a;
+            if r goto end;
+            r = 1;
+            x_loc = x;
+            y_loc = y;
+            store RLX #y_loc r;
+            load RLX #x_loc b;
+            end: r = 1;
+            exists (0:a = 0 /\ 1:b = 0);
+            )"""";
+
+// thread 0 exits its loop only when it reads x = 1 and y = 0, which never hold at the same time
+const std::string kTwoLoadSpinLoop = R""""(
+            shared_state: x y f w;
+            one = 1;
+            x_loc = x;
+            y_loc = y;
+            f_loc = f;
+            w_loc = w;
+            wait_f:
+                load RLX #f_loc g;
+                z = g < one;
+                if z goto wait_f;
+            loop:
+                load SEQ_CST #x_loc a;
+                load SEQ_CST #y_loc b;
+                c = a + b;
+                if c goto loop;
+            store SEQ_CST #w_loc one;
+            done = 1;
+            if done goto end;
+            one = 1;
+            zero = 0;
+            x_loc = x;
+            y_loc = y;
+            f_loc = f;
+            w_loc = w;
+            store SEQ_CST #y_loc one;
+            store SEQ_CST #f_loc one;
+            store SEQ_CST #x_loc one;
+            store SEQ_CST #y_loc zero;
+            load SEQ_CST #w_loc d;
+            end: done = 1;
+            forall (1:d = 5);
+            )"""";
+
+// the flag is never set, so the thread spins forever and no execution completes
+const std::string kEndlessSpinLoop = R""""(
+            shared_state: f;
+            one = 1;
+            f_loc = f;
+            wait:
+                load RLX #f_loc g;
+                z = g < one;
+                if z goto wait;
+            g = 7;
+            forall (0:g = 7);
+            )"""";
+
+ProgramPtr CreateStoreBuffering() {
+    return CreateProgram(Parse(std::string_view{kStoreBuffering}), {0, 6});
+}
+
+std::set<std::string> CollectOutcomes(const ProgramPtr& program, ExplorationConfig config, ExplorationResult* result = nullptr) {
+    config.stop_at_target = false;
+    Exploration exploration{program, std::move(config)};
+    std::set<std::string> outcomes;
+    ExplorationCallbacks callbacks;
+    callbacks.on_outcome = [&] (const Outcome& outcome) {
+        outcomes.insert(FormatOutcome(program->descriptor, outcome));
+        return true;
+    };
+    auto run_result = exploration.Run(callbacks);
+    EXPECT_EQ(run_result.status, ExplorationStatus::COMPLETED);
+    EXPECT_EQ(run_result.outcomes, outcomes.size());
+    if (result) {
+        *result = run_result;
+    }
+    return outcomes;
+}
+
+}  // namespace
+
+TEST(TestExploration, GraphOutcomes) {
+    auto program = CreateStoreBuffering();
+    ExplorationConfig config;
+    ExplorationResult result;
+    EXPECT_EQ(CollectOutcomes(program, config, &result).size(), 3);
+    EXPECT_EQ(result.found, false);
+    config.model = "tso";
+    EXPECT_EQ(CollectOutcomes(program, config, &result).size(), 4);
+    EXPECT_EQ(result.found, true);
+}
+
+TEST(TestExploration, OperationalMatchesGraph) {
+    auto program = CreateStoreBuffering();
+    for (std::string model : {"sc", "tso", "pso"}) {
+        ExplorationConfig graph;
+        graph.model = model;
+        ExplorationConfig operational = graph;
+        operational.mode = ExplorationMode::OPERATIONAL;
+        EXPECT_EQ(CollectOutcomes(program, graph), CollectOutcomes(program, operational)) << model;
+    }
+}
+
+TEST(TestExploration, StopsAtTarget) {
+    auto program = CreateStoreBuffering();
+    ExplorationConfig config;
+    config.model = "tso";
+    Exploration exploration{program, config};
+    size_t targets = 0;
+    ExplorationCallbacks callbacks;
+    callbacks.on_target = [&] (const Outcome& outcome) {
+        EXPECT_TRUE(program->descriptor.final_condition->IsTarget(outcome));
+        ++targets;
+    };
+    auto result = exploration.Run(callbacks);
+    EXPECT_EQ(result.status, ExplorationStatus::TARGET_FOUND);
+    EXPECT_EQ(result.found, true);
+    EXPECT_EQ(targets, 1);
+}
+
+TEST(TestExploration, Bounds) {
+    auto program = CreateStoreBuffering();
+    ExplorationConfig config;
+    config.model = "tso";
+    config.stop_at_target = false;
+    config.max_states = 3;
+    Exploration bounded{program, config};
+    auto result = bounded.Run();
+    EXPECT_EQ(result.status, ExplorationStatus::STATE_LIMIT);
+    EXPECT_FALSE(result.found.has_value());
+
+    config.max_states.reset();
+    config.memory_limit_bytes = 1;
+    Exploration small{program, config};
+    EXPECT_EQ(small.Run().status, ExplorationStatus::MEMORY_LIMIT);
+
+    config.memory_limit_bytes.reset();
+    Exploration exploration{program, config};
+    ExplorationCallbacks callbacks;
+    callbacks.on_outcome = [] (const Outcome&) {
+        return false;
+    };
+    auto stopped = exploration.Run(callbacks);
+    EXPECT_EQ(stopped.status, ExplorationStatus::STOPPED);
+    EXPECT_EQ(stopped.outcomes, 1);
+    exploration.Cancel();
+    EXPECT_EQ(exploration.Run().status, ExplorationStatus::CANCELLED);
+}
+
+TEST(TestExploration, ConcurrentRuns) {
+    auto program = CreateStoreBuffering();
+    ExplorationConfig config;
+    config.model = "pso";
+    auto expected = CollectOutcomes(program, config);
+    std::vector<std::set<std::string>> outcomes(4);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < outcomes.size(); ++i) {
+        threads.emplace_back([&, i] () {
+            ExplorationConfig thread_config = config;
+            thread_config.mode = i % 2 == 0 ? ExplorationMode::GRAPH : ExplorationMode::OPERATIONAL;
+            outcomes[i] = CollectOutcomes(program, thread_config);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (auto& thread_outcomes : outcomes) {
+        EXPECT_EQ(thread_outcomes, expected);
+    }
+}
+
+TEST(TestExploration, InvalidConfig) {
+    auto program = CreateStoreBuffering();
+    ExplorationConfig config;
+    config.model = "ra";
+    EXPECT_THROW((Exploration{program, config}), std::runtime_error);
+    config.mode = ExplorationMode::OPERATIONAL;
+    EXPECT_NO_THROW((Exploration{program, config}));
+    config.instruction_pointers = {0, 100};
+    EXPECT_THROW((Exploration{program, config}), std::runtime_error);
+    config.instruction_pointers = {0};
+    EXPECT_THROW((Exploration{program, config}), std::runtime_error);
+    EXPECT_THROW((Exploration{CreateProgram(Parse(std::string_view{kStoreBuffering})), ExplorationConfig{}}), std::runtime_error);
+}
+
+TEST(TestExploration, AwaitTwoLoadSpinLoop) {
+    auto program = CreateProgram(Parse(std::string_view{kTwoLoadSpinLoop}), {0, 15});
+    for (bool await_spin_loops : {false, true}) {
+        ExplorationConfig config;
+        config.mode = ExplorationMode::OPERATIONAL;
+        config.options.await_spin_loops = await_spin_loops;
+        // a snapshot between the writes of thread 1 lets thread 0 out of the loop, so executions complete
+        EXPECT_EQ(Exploration(program, config).Run().status, ExplorationStatus::TARGET_FOUND) << await_spin_loops;
+    }
+}
+
+TEST(TestExploration, BestFirstSkipsBlockedStates) {
+    auto program = CreateProgram(Parse(std::string_view{kEndlessSpinLoop}), {0});
+    ExplorationOptions options;
+    options.await_spin_loops = true;
+    auto executor = CreateBestFirstExecutor(CreateMemorySubsystem(program->descriptor, 1, "sc"), program->descriptor, {0}, false, options);
+    while (!executor->IsDone()) {
+        executor->ExecuteNext();
+    }
+    EXPECT_FALSE(executor->context->target_found);
+}
+
+TEST(TestExploration, SharedCompiledForms) {
+    auto program = CreateStoreBuffering();
+    ExplorationOptions options;
+    auto analysis = program->GetAnalysis({0, 6}, options);
+    EXPECT_EQ(program->GetAnalysis({0, 6}, options), analysis);
+    options.eager_private_propagation = true;
+    EXPECT_NE(program->GetAnalysis({0, 6}, options), analysis);
+    EXPECT_NE(program->GetAnalysis({6, 0}, {}), analysis);
+
+    auto bytecode = program->GetBytecode();
+    ExplorationConfig config;
+    config.mode = ExplorationMode::OPERATIONAL;
+    EXPECT_EQ(Exploration(program, config).Run().status, ExplorationStatus::COMPLETED);
+    EXPECT_EQ(program->GetBytecode(), bytecode);
+    EXPECT_EQ(program->GetAnalysis({0, 6}, {}), analysis);
+}
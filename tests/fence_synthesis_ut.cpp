@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../api/exploration.h"
+#include "../axiomatic/fence_synthesis.h"
+#include "../axiomatic/robustness.h"
+
+namespace {
+
+std::set<size_t> SynthesizeFences(const ProgramDescriptor& descriptor, MemoryModel model) {
+    FenceSynthesizer synthesizer{descriptor, {0, 6}, model, false};
+    synthesizer.Synthesize();
+    return synthesizer.GetFences();
+}
+
+}  // namespace
+
+TEST(TestFenceSynthesis, StoreBuffering) {
+    auto program = OpenProgram(std::string{WMM_EXAMPLES_DIR} + "/store_buffering.txt");
+    auto& descriptor = program->descriptor;
+    // the store of each thread, before its load
+    std::set<size_t> expected{3, 9};
+    EXPECT_EQ(SynthesizeFences(descriptor, MemoryModel::TSO), expected);
+    EXPECT_EQ(SynthesizeFences(descriptor, MemoryModel::PSO), expected);
+    EXPECT_THROW(SynthesizeFences(descriptor, MemoryModel::SC), std::runtime_error);
+
+    PatchedProgram patched = InsertFences(descriptor, {0, 6}, expected);
+    EXPECT_EQ(patched.instruction_pointers, (std::vector<size_t>{0, 7}));
+    EXPECT_EQ(patched.descriptor.instructions.size(), descriptor.instructions.size() + 2);
+    RobustnessChecker checker{patched.descriptor, patched.instruction_pointers, MemoryModel::TSO, false};
+    checker.Explore();
+    EXPECT_FALSE(checker.GetViolation().has_value());
+}
+
+TEST(TestFenceSynthesis, MessagePassing) {
+    auto program = OpenProgram(std::string{WMM_EXAMPLES_DIR} + "/simple_pso.txt");
+    EXPECT_TRUE(SynthesizeFences(program->descriptor, MemoryModel::TSO).empty());
+    // only the writer's stores may be reordered
+    EXPECT_EQ(SynthesizeFences(program->descriptor, MemoryModel::PSO), std::set<size_t>{2});
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../api/exploration.h"
+
+namespace {
+
+struct Example {
+    std::string file;
+    std::vector<size_t> instruction_pointers;
+};
+
+// store buffering, message passing, a spin lock and accesses to reserved cells
+const std::vector<Example> kExamples = {
+        {"store_buffering.txt", {0, 6}},
+        {"simple_pso.txt", {0, 6}},
+        {"spin_lock.txt", {0, 14}},
+        {"private_scratch.txt", {0, 10}},
+};
+
+std::set<std::string> CollectOutcomes(const ProgramPtr& program, const std::vector<size_t>& instruction_pointers,
+                                      ExplorationMode mode, const std::string& model) {
+    ExplorationConfig config;
+    config.mode = mode;
+    config.model = model;
+    config.instruction_pointers = instruction_pointers;
+    config.stop_at_target = false;
+    std::set<std::string> outcomes;
+    ExplorationCallbacks callbacks;
+    callbacks.on_outcome = [&] (const Outcome& outcome) {
+        outcomes.insert(FormatOutcome(program->descriptor, outcome));
+        return true;
+    };
+    EXPECT_EQ(Exploration(program, config).Run(callbacks).status, ExplorationStatus::COMPLETED);
+    return outcomes;
+}
+
+}  // namespace
+
+TEST(TestGraphExplorer, MatchesModelChecking) {
+    for (auto& example : kExamples) {
+        auto program = OpenProgram(std::string{WMM_EXAMPLES_DIR} + "/" + example.file);
+        for (std::string model : {"sc", "tso", "pso"}) {
+            auto graph = CollectOutcomes(program, example.instruction_pointers, ExplorationMode::GRAPH, model);
+            EXPECT_FALSE(graph.empty()) << example.file << ' ' << model;
+            EXPECT_EQ(graph, CollectOutcomes(program, example.instruction_pointers, ExplorationMode::OPERATIONAL, model)) << example.file << ' ' << model;
+        }
+    }
+}
+
+TEST(TestGraphExplorer, WeakOutcomes) {
+    auto store_buffering = OpenProgram(std::string{WMM_EXAMPLES_DIR} + "/store_buffering.txt");
+    auto message_passing = OpenProgram(std::string{WMM_EXAMPLES_DIR} + "/simple_pso.txt");
+    // a = b = 0 only once stores are buffered, b = 0 after a = 1 only once they are reordered
+    EXPECT_EQ(CollectOutcomes(store_buffering, {0, 6}, ExplorationMode::GRAPH, "sc").size(), 3);
+    EXPECT_EQ(CollectOutcomes(store_buffering, {0, 6}, ExplorationMode::GRAPH, "tso").size(), 4);
+    EXPECT_EQ(CollectOutcomes(message_passing, {0, 6}, ExplorationMode::GRAPH, "tso").size(), 3);
+    EXPECT_EQ(CollectOutcomes(message_passing, {0, 6}, ExplorationMode::GRAPH, "pso").size(), 4);
+}
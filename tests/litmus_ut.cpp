@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <variant>
+
+#include "../parser/litmus.h"
+
+TEST(TestLitmus, X86StoreBuffering) {
+    std::string litmus = R""""(X86 SB
+"Fre PodWR Fre PodWR"
+{ x=0; y=0; }
+ P0          | P1          ;
+ MOV [x],$1  | MOV [y],$1  ;
+ MFENCE      |             ;
+ MOV EAX,[y] | MOV EAX,[x] ;
+exists (0:EAX=0 /\ 1:EAX=0)
+)"""";
+    auto program = ParseLitmus(litmus);
+    EXPECT_EQ(program.name, "SB");
+    EXPECT_EQ(program.descriptor.memory_name, (std::vector<std::string>{"x", "y"}));
+    ASSERT_EQ(program.instruction_pointers, (std::vector<size_t>{0, 8}));
+    auto& instructions = program.descriptor.instructions;
+    EXPECT_TRUE(std::holds_alternative<StoreInstruction>(instructions[2]));
+    EXPECT_TRUE(std::holds_alternative<FenceInstruction>(instructions[3]));
+    EXPECT_TRUE(std::holds_alternative<LoadInstruction>(instructions[5]));
+    EXPECT_TRUE(std::holds_alternative<IfInstruction>(instructions[7]));
+    EXPECT_TRUE(std::holds_alternative<StoreInstruction>(instructions[10]));
+    ASSERT_TRUE(program.descriptor.final_condition.has_value());
+    EXPECT_EQ(program.descriptor.final_condition->quantifier, ConditionQuantifier::EXISTS);
+}
+
+TEST(TestLitmus, X86LockedInstructions) {
+    std::string litmus = R""""(X86 locked
+{ x=0; 0:EAX=1; }
+ P0              | P1           ;
+ XCHG [x],EAX    | MOV EBX,$2   ;
+ LOCK XADD [x],EAX | LOCK XADD [x],EBX ;
+exists (x=3)
+)"""";
+    auto program = ParseLitmus(litmus);
+    auto& instructions = program.descriptor.instructions;
+    ASSERT_TRUE(std::holds_alternative<FetchOpInstruction>(instructions[2]));
+    EXPECT_EQ(std::get<FetchOpInstruction>(instructions[2]).kind, RmwKind::EXCHANGE);
+    EXPECT_EQ(std::get<FetchOpInstruction>(instructions[2]).mode, AccessMode::SEQ_CST);
+    EXPECT_TRUE(std::holds_alternative<FaiInstruction>(instructions[3]));
+}
+
+TEST(TestLitmus, CMessagePassing) {
+    std::string litmus = R""""(C MP+rel+acq
+{}
+
+P0(int *x, int *y)
+{
+	WRITE_ONCE(*x, 1); // data
+	smp_store_release(y, 1);
+}
+
+P1(int *x, int *y)
+{
+	int r0;
+	int r1 = 0;
+	r0 = smp_load_acquire(y);
+	r1 = atomic_load_explicit(x, memory_order_relaxed);
+}
+
+~exists (1:r0=1 /\ 1:r1=0)
+)"""";
+    auto program = ParseLitmus(litmus);
+    EXPECT_EQ(program.instruction_pointers.size(), 2);
+    auto& instructions = program.descriptor.instructions;
+    auto& release = std::get<StoreInstruction>(instructions[4]);
+    EXPECT_EQ(release.mode, AccessMode::REL);
+    auto& acquire = std::get<LoadInstruction>(instructions[program.instruction_pointers[1] + 2]);
+    EXPECT_EQ(acquire.mode, AccessMode::ACQ);
+    ASSERT_TRUE(program.descriptor.final_condition.has_value());
+    EXPECT_EQ(program.descriptor.final_condition->quantifier, ConditionQuantifier::FORALL);
+}
+
+TEST(TestLitmus, NonZeroInitialMemory) {
+    std::string litmus = R""""(X86 init
+{ x=1; }
+ P0          ;
+ MOV EAX,[x] ;
+exists (0:EAX=1)
+)"""";
+    EXPECT_THROW(TranslateLitmus(litmus), std::runtime_error);
+}
+
+TEST(TestLitmus, UnsupportedInstruction) {
+    std::string litmus = R""""(X86 cmpxchg
+{ x=0; }
+ P0                ;
+ CMPXCHG [x],EBX   ;
+exists (x=1)
+)"""";
+    EXPECT_THROW(TranslateLitmus(litmus), std::runtime_error);
+}
+
+TEST(TestLitmus, UnsupportedArchitecture) {
+    EXPECT_THROW(TranslateLitmus("ARM SB\n{}\n P0 ;\n"), std::runtime_error);
+}
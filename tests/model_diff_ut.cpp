@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../api/exploration.h"
+#include "../axiomatic/model_diff.h"
+
+namespace {
+
+// number of outcomes whose strongest allowing model is each of the requested ones
+std::vector<size_t> ClassifyOutcomes(const std::string& file, const std::string& models) {
+    auto program = OpenProgram(std::string{WMM_EXAMPLES_DIR} + "/" + file);
+    std::vector<MemoryModel> parsed = ParseMemoryModels(models);
+    ModelDiffExplorer explorer{program->descriptor, {0, 6}, parsed, false};
+    explorer.Explore();
+    std::vector<size_t> counts(parsed.size(), 0);
+    for (auto& [outcome, strongest] : explorer.GetStrongestModels()) {
+        ++counts[strongest];
+    }
+    return counts;
+}
+
+}  // namespace
+
+TEST(TestModelDiff, ParseMemoryModels) {
+    std::vector<MemoryModel> expected = {MemoryModel::SC, MemoryModel::TSO, MemoryModel::PSO};
+    EXPECT_EQ(ParseMemoryModels("pso,sc,tso"), expected);
+    EXPECT_THROW(ParseMemoryModels("sc,sc"), std::runtime_error);
+    EXPECT_THROW(ParseMemoryModels("sc,"), std::runtime_error);
+}
+
+TEST(TestModelDiff, StoreBuffering) {
+    // a=0 b=0 is the only outcome sc forbids and tso allows
+    EXPECT_EQ(ClassifyOutcomes("store_buffering.txt", "sc,tso,pso"), (std::vector<size_t>{3, 1, 0}));
+    EXPECT_EQ(ClassifyOutcomes("store_buffering.txt", "tso,pso"), (std::vector<size_t>{4, 0}));
+}
+
+TEST(TestModelDiff, MessagePassing) {
+    // only pso reorders the two stores of the writer
+    EXPECT_EQ(ClassifyOutcomes("simple_pso.txt", "sc,tso,pso"), (std::vector<size_t>{3, 0, 1}));
+    EXPECT_EQ(ClassifyOutcomes("simple_pso.txt", "sc,tso"), (std::vector<size_t>{3, 0}));
+}
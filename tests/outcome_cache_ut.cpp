@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+
+#include <unistd.h>
+
+#include "../cache/outcome_cache.h"
+#include "../common/binary_program.h"
+#include "../parser/parser.h"
+
+namespace {
+
+const std::string kStoreBuffering = R""""(
+            shared_state: x y;
+            r = 1;
+            x_loc = x;
+            y_loc = y;
+            store RLX #x_loc r;
+            load RLX #y_loc a;
+            if r goto end;
+            r = 1;
+            x_loc = x;
+            y_loc = y;
+            store RLX #y_loc r;
+            load RLX #x_loc b;
+            end: r = 1;
+            exists (0:a = 0 /\ 1:b = 0);
+            )"""";
+
+std::string CreateCacheDirectory(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / (name + std::to_string(getpid()));
+    std::filesystem::remove_all(path);
+    return path.string();
+}
+
+}  // namespace
+
+TEST(TestOutcomeCache, Keys) {
+    ExplorationConfig config;
+    config.instruction_pointers = {0, 6};
+    std::set<std::string> keys{GetExplorationKey(1, config), GetExplorationKey(2, config)};
+    config.model = "tso";
+    keys.insert(GetExplorationKey(1, config));
+    config.mode = ExplorationMode::OPERATIONAL;
+    keys.insert(GetExplorationKey(1, config));
+    config.options.await_spin_loops = true;
+    keys.insert(GetExplorationKey(1, config));
+    config.instruction_pointers = {6, 0};
+    keys.insert(GetExplorationKey(1, config));
+    config.stop_at_target = false;
+    keys.insert(GetExplorationKey(1, config));
+    config.max_states = 10;
+    keys.insert(GetExplorationKey(1, config));
+    EXPECT_EQ(keys.size(), 8);
+    config.time_limit = std::chrono::milliseconds{10};
+    EXPECT_EQ(keys.count(GetExplorationKey(1, config)), 1);
+}
+
+TEST(TestOutcomeCache, StoreAndFind) {
+    auto program = CreateProgram(Parse(std::string_view{kStoreBuffering}), {0, 6});
+    ExplorationConfig config;
+    config.model = "tso";
+    Exploration exploration{program, config};
+    ExplorationRecord record = RecordExploration(exploration, program->descriptor);
+    EXPECT_EQ(record.result.status, ExplorationStatus::TARGET_FOUND);
+    ASSERT_TRUE(record.target.has_value());
+    EXPECT_EQ(record.outcomes.back(), *record.target);
+
+    OutcomeCache cache{CreateCacheDirectory("wmm_cache")};
+    std::string key = GetExplorationKey(GetProgramHash(program->descriptor), exploration.GetConfig());
+    EXPECT_FALSE(cache.Find(key).has_value());
+    cache.Store(key, record);
+    auto found = cache.Find(key);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->outcomes, record.outcomes);
+    EXPECT_EQ(found->target, record.target);
+    EXPECT_EQ(found->result.status, record.result.status);
+    EXPECT_EQ(found->result.states, record.result.states);
+    EXPECT_EQ(found->result.executions, record.result.executions);
+    EXPECT_EQ(found->result.outcomes, record.result.outcomes);
+    EXPECT_EQ(found->result.found, record.result.found);
+    EXPECT_FALSE(cache.Find(key + " max-states=1").has_value());
+}
+
+TEST(TestOutcomeCache, BrokenEntry) {
+    OutcomeCache cache{CreateCacheDirectory("wmm_broken_cache")};
+    ExplorationRecord record;
+    record.outcomes = {"0:r=1 x=1", "0:r=0 x=1"};
+    record.result.outcomes = 2;
+    cache.Store("key", record);
+    ASSERT_TRUE(cache.Find("key").has_value());
+    std::string contents;
+    {
+        std::ifstream input{cache.GetEntryPath("key")};
+        contents.assign(std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{});
+    }
+    // an entry cut in the middle of the outcomes
+    std::ofstream{cache.GetEntryPath("key")} << contents.substr(0, contents.size() - 5);
+    EXPECT_FALSE(cache.Find("key").has_value());
+    std::ofstream{cache.GetEntryPath("key")} << "garbage\n";
+    EXPECT_FALSE(cache.Find("key").has_value());
+}
@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "../common/binary_program.h"
+#include "../parser/parser.h"
+#include "../parser/tokenizer.h"
+
+namespace {
+
+// program of the size of generated stress tests: every thread repeats a block of memory accesses with a label
+std::string GenerateProgram(size_t threads_cnt, size_t blocks_cnt) {
+    constexpr size_t kCells = 16;
+    std::string program = "shared_state:";
+    for (size_t cell = 0; cell < kCells; ++cell) {
+        program += " x" + std::to_string(cell);
+    }
+    program += ";\n";
+    for (size_t tid = 0; tid < threads_cnt; ++tid) {
+        program += "one = 1;\nzero = 0;\n";
+        for (size_t block = 0; block < blocks_cnt; ++block) {
+            std::string label = "block_" + std::to_string(tid) + "_" + std::to_string(block);
+            program += label + ":\n";
+            program += "    x_loc = x" + std::to_string(block % kCells) + ";\n";
+            program += "    store RLX #x_loc one;\n";
+            program += "    load ACQ #x_loc value;\n";
+            program += "    value = value + one;\n";
+            program += "    old := cas SEQ_CST #x_loc zero one;\n";
+            program += "    if zero goto " + label + ";\n";
+        }
+        program += "if one goto end;\n";
+    }
+    program += "end: one = 1;\n";
+    program += "exists (0:value = 1 /\\ x0 = 1);\n";
+    return program;
+}
+
+const std::string& GetProgram() {
+    static const std::string program = GenerateProgram(8, 20000);
+    return program;
+}
+
+void BM_TokenizeStream(benchmark::State& state) {
+    const std::string& program = GetProgram();
+    for (auto _ : state) {
+        std::stringstream ss{program};
+        Tokenizer tokenizer{&ss};
+        size_t tokens = 0;
+        while (!tokenizer.IsDone()) {
+            tokenizer.Next();
+            ++tokens;
+        }
+        benchmark::DoNotOptimize(tokens);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * program.size()));
+}
+
+void BM_Tokenize(benchmark::State& state) {
+    const std::string& program = GetProgram();
+    for (auto _ : state) {
+        Tokenizer tokenizer{std::string_view{program}};
+        size_t tokens = 0;
+        while (!tokenizer.IsDone()) {
+            tokenizer.Next();
+            ++tokens;
+        }
+        benchmark::DoNotOptimize(tokens);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * program.size()));
+}
+
+void BM_ParseStream(benchmark::State& state) {
+    const std::string& program = GetProgram();
+    for (auto _ : state) {
+        std::stringstream ss{program};
+        ProgramDescriptor descriptor = Parse(&ss);
+        benchmark::DoNotOptimize(descriptor.instructions.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * program.size()));
+}
+
+void BM_Parse(benchmark::State& state) {
+    const std::string& program = GetProgram();
+    for (auto _ : state) {
+        ProgramDescriptor descriptor = Parse(std::string_view{program});
+        benchmark::DoNotOptimize(descriptor.instructions.data());
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * program.size()));
+}
+
+void BM_ParseFile(benchmark::State& state) {
+    const std::string& program = GetProgram();
+    std::string path = "parser_bench_program.txt";
+    std::ofstream{path} << program;
+    for (auto _ : state) {
+        ProgramDescriptor descriptor = ParseFile(path);
+        benchmark::DoNotOptimize(descriptor.instructions.data());
+    }
+    std::remove(path.c_str());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * program.size()));
+}
+
+// startup cost of a program compiled with `wmm_emulator compile`, bytes are the ones of the text form
+void BM_LoadCompiled(benchmark::State& state) {
+    const std::string& program = GetProgram();
+    std::string path = "parser_bench_program.wmmp";
+    {
+        std::ofstream output{path, std::ios::binary};
+        WriteBinaryProgram(output, Parse(std::string_view{program}));
+    }
+    for (auto _ : state) {
+        ProgramDescriptor descriptor = LoadProgram(path);
+        benchmark::DoNotOptimize(descriptor.instructions.data());
+    }
+    std::remove(path.c_str());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * program.size()));
+}
+
+}  // namespace
+
+BENCHMARK(BM_TokenizeStream)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Tokenize)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseStream)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Parse)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseFile)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadCompiled)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
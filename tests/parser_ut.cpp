@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <variant>
 
@@ -85,6 +86,23 @@ TEST(TestParser, CasInstruction) {
     EXPECT_TRUE(std::holds_alternative<CasInstruction>(descriptor.instructions[5]));
 }
 
+TEST(TestParser, FetchOpInstruction) {
+    std::string program = R""""(
+                shared_state: x;
+                r1 = x;
+                r2 = 6;
+                r := xchg SEQ_CST #r1 r2;
+                r := fetch_or RLX #r1 r2;
+                )"""";
+    std::stringstream ss{program};
+    auto descriptor = Parse(&ss);
+    EXPECT_EQ(descriptor.instructions.size(), 4);
+    ASSERT_TRUE(std::holds_alternative<FetchOpInstruction>(descriptor.instructions[2]));
+    ASSERT_TRUE(std::holds_alternative<FetchOpInstruction>(descriptor.instructions[3]));
+    EXPECT_EQ(std::get<FetchOpInstruction>(descriptor.instructions[2]).kind, RmwKind::EXCHANGE);
+    EXPECT_EQ(std::get<FetchOpInstruction>(descriptor.instructions[3]).kind, RmwKind::FETCH_OR);
+}
+
 TEST(TestParser, LoadInstruction) {
     std::string program = R""""(
                 shared_state: x;
@@ -117,3 +135,118 @@ TEST(TestParser, IfInstruction) {
     EXPECT_EQ(descriptor.instructions.size(), 6);
     EXPECT_TRUE(std::holds_alternative<IfInstruction>(descriptor.instructions[5]));
 }
+
+TEST(TestParser, ForwardJump) {
+    std::string program = R""""(
+                one = 1;
+                if one goto end;
+                one = 2;
+                end: done: one = 3;
+                )"""";
+    auto descriptor = Parse(std::string_view{program});
+    ASSERT_EQ(descriptor.instructions.size(), 4);
+    ASSERT_TRUE(std::holds_alternative<IfInstruction>(descriptor.instructions[1]));
+    EXPECT_EQ(std::get<IfInstruction>(descriptor.instructions[1]).instr_on_success, 3);
+    EXPECT_EQ(descriptor.register_name.size(), 1);
+    EXPECT_EQ(descriptor.instructions_str.size(), 4);
+    EXPECT_EQ(descriptor.instructions_str[1], "if one goto end ");
+    EXPECT_EQ(descriptor.instructions_str[3], "end : done : one = 3 ");
+}
+
+TEST(TestParser, UnknownLabel) {
+    std::string program = R""""(
+                one = 1;
+                if one goto end;
+                )"""";
+    EXPECT_THROW(Parse(std::string_view{program}), std::runtime_error);
+}
+
+TEST(TestParser, RepeatingLabel) {
+    std::string program = R""""(
+                start: one = 1;
+                start: one = 2;
+                )"""";
+    EXPECT_THROW(Parse(std::string_view{program}), std::runtime_error);
+}
+
+TEST(TestParser, InstructionErrors) {
+    auto error = [] (const std::string& program) -> std::string {
+        try {
+            Parse(std::string_view{program});
+        } catch (const std::runtime_error& e) {
+            return e.what();
+        }
+        return "";
+    };
+    EXPECT_EQ(error("shared_state: x; r = x; load RLX #r;"), "Incorrect load instruction, wrong number of arguments");
+    EXPECT_EQ(error("shared_state: x; r = x; store RLX #r;"), "Incorrect store instruction, wrong number of arguments");
+    EXPECT_EQ(error("shared_state: x; r = x; store RLX r r;"), "Incorrect type of arguments of store instruction");
+    EXPECT_EQ(error("r = 1; if r goto;"), "Incorrect if instruction, wrong number of arguments");
+    EXPECT_EQ(error("r = 1; end: if r r end;"), "Incorrect type of arguments of if instruction");
+    EXPECT_EQ(error("shared_state: x; r = x; r := xchg;"), "Incorrect usage of fetch-and-modify instruction");
+    EXPECT_EQ(error("shared_state: x; r = x; r := fetch_or RLX #r;"), "Incorrect usage of fetch-and-modify instruction");
+    EXPECT_EQ(error("shared_state: x; r = x; r := fai RLX;"), "Incorrect usage of fetch-and-increment instruction");
+    EXPECT_EQ(error("shared_state: x; r = x; r := cas RLX #r r;"), "Incorrect usage of compare-and-swap instruction");
+    EXPECT_EQ(error("r = 1; r :=;"), "Incomplete assignment");
+    EXPECT_EQ(error("r = 1; r = r +;"), "Incorrect usage of binary operation");
+}
+
+TEST(TestParser, ExistsFinalCondition) {
+    std::string program = R""""(
+                shared_state: x y;
+                r = 1;
+                loc = x;
+                store RLX #loc r;
+                load RLX #loc a;
+                exists (0:a = 1 /\ ~y = 1);
+                )"""";
+    std::stringstream ss{program};
+    auto descriptor = Parse(&ss);
+    EXPECT_EQ(descriptor.instructions.size(), 4);
+    ASSERT_TRUE(descriptor.final_condition.has_value());
+    EXPECT_EQ(descriptor.final_condition->quantifier, ConditionQuantifier::EXISTS);
+    EXPECT_TRUE(std::holds_alternative<Conjunction>(descriptor.final_condition->nodes[descriptor.final_condition->root]));
+
+    Outcome outcome{{{1, 0, 1}}, {1, 0}};
+    EXPECT_TRUE(descriptor.final_condition->Evaluate(outcome));
+    EXPECT_TRUE(descriptor.final_condition->IsTarget(outcome));
+    outcome.memory[1] = 1;
+    EXPECT_FALSE(descriptor.final_condition->Evaluate(outcome));
+}
+
+TEST(TestParser, ForallFinalCondition) {
+    std::string program = R""""(
+                shared_state: x;
+                r = 1;
+                forall (x = 0 \/ 1:r = 1)
+                )"""";
+    std::stringstream ss{program};
+    auto descriptor = Parse(&ss);
+    ASSERT_TRUE(descriptor.final_condition.has_value());
+    EXPECT_EQ(descriptor.final_condition->quantifier, ConditionQuantifier::FORALL);
+    EXPECT_EQ(descriptor.final_condition->GetMaxThreadId(), 1);
+
+    Outcome outcome{{{0}, {0}}, {1}};
+    EXPECT_FALSE(descriptor.final_condition->Evaluate(outcome));
+    EXPECT_TRUE(descriptor.final_condition->IsTarget(outcome));
+}
+
+TEST(TestParser, FinalConditionMustBeLast) {
+    std::string program = R""""(
+                shared_state: x;
+                r = 1;
+                exists (x = 0);
+                r = 2;
+                )"""";
+    std::stringstream ss{program};
+    EXPECT_THROW(Parse(&ss), std::runtime_error);
+}
+
+TEST(TestParser, FinalConditionUnknownRegister) {
+    std::string program = R""""(
+                r = 1;
+                exists (0:q = 0);
+                )"""";
+    std::stringstream ss{program};
+    EXPECT_THROW(Parse(&ss), std::runtime_error);
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+
+#include "../api/exploration.h"
+#include "../generator/program_family.h"
+#include "../parser/parser.h"
+
+namespace {
+
+ExplorationResult Explore(const std::string& family, const FamilyParameters& parameters, ExplorationMode mode, const std::string& model) {
+    GeneratedProgram generated = GenerateFamily(family, parameters);
+    auto program = CreateProgram(Parse(std::string_view{generated.program}), generated.instruction_pointers);
+    ExplorationConfig config;
+    config.mode = mode;
+    config.model = model;
+    return Exploration{program, config}.Run();
+}
+
+}  // namespace
+
+TEST(TestProgramFamily, Layout) {
+    for (auto& family : GetFamilyNames()) {
+        FamilyParameters parameters;
+        parameters.threads = family == "iriw" ? 5 : 2;
+        parameters.depth = 3;
+        parameters.cells = 4;
+        GeneratedProgram generated = GenerateFamily(family, parameters);
+        ProgramDescriptor descriptor = Parse(std::string_view{generated.program});
+        ASSERT_EQ(generated.instruction_pointers.size(), parameters.threads) << family;
+        EXPECT_EQ(generated.instruction_pointers[0], 0) << family;
+        // every thread but the last one ends with the jump to the final instruction
+        for (size_t tid = 1; tid < parameters.threads; ++tid) {
+            EXPECT_EQ(descriptor.instructions_str[generated.instruction_pointers[tid] - 1], "if done goto end ") << family;
+        }
+        EXPECT_EQ(descriptor.memory_size, descriptor.memory_name.size() + parameters.cells) << family;
+        EXPECT_TRUE(descriptor.final_condition) << family;
+    }
+}
+
+TEST(TestProgramFamily, Verdicts) {
+    FamilyParameters parameters;
+    parameters.threads = 3;
+    parameters.depth = 2;
+    EXPECT_EQ(Explore("sb", parameters, ExplorationMode::GRAPH, "sc").found, false);
+    EXPECT_EQ(Explore("sb", parameters, ExplorationMode::OPERATIONAL, "tso").found, true);
+    EXPECT_EQ(Explore("mp", parameters, ExplorationMode::GRAPH, "tso").found, false);
+    EXPECT_EQ(Explore("mp", parameters, ExplorationMode::GRAPH, "pso").found, true);
+    parameters.threads = 4;
+    EXPECT_EQ(Explore("iriw", parameters, ExplorationMode::GRAPH, "tso").found, false);
+}
+
+TEST(TestProgramFamily, Counters) {
+    FamilyParameters parameters;
+    parameters.threads = 3;
+    parameters.depth = 2;
+    parameters.cells = 2;
+    EXPECT_EQ(Explore("counter-fai", parameters, ExplorationMode::GRAPH, "tso").status, ExplorationStatus::COMPLETED);
+    EXPECT_EQ(Explore("counter-cas", parameters, ExplorationMode::OPERATIONAL, "pso").status, ExplorationStatus::COMPLETED);
+    parameters.threads = 2;
+    EXPECT_EQ(Explore("peterson", parameters, ExplorationMode::OPERATIONAL, "tso").status, ExplorationStatus::COMPLETED);
+    EXPECT_EQ(Explore("dekker", parameters, ExplorationMode::OPERATIONAL, "sc").status, ExplorationStatus::COMPLETED);
+}
+
+TEST(TestProgramFamily, Errors) {
+    FamilyParameters parameters;
+    EXPECT_THROW(GenerateFamily("unknown", parameters), std::runtime_error);
+    parameters.threads = 3;
+    EXPECT_THROW(GenerateFamily("peterson", parameters), std::runtime_error);
+    EXPECT_THROW(GenerateFamily("iriw", parameters), std::runtime_error);
+    parameters.threads = 1;
+    EXPECT_THROW(GenerateFamily("sb", parameters), std::runtime_error);
+    EXPECT_NO_THROW(GenerateFamily("counter-fai", parameters));
+    parameters.depth = 0;
+    EXPECT_THROW(GenerateFamily("counter-fai", parameters), std::runtime_error);
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../server/program_server.h"
+
+namespace {
+
+const std::string kStoreBuffering = R""""(
+            shared_state: x y;
+            r = 1;
+            x_loc = x;
+            y_loc = y;
+            store RLX #x_loc r;
+            load RLX #y_loc a;
+            if r goto end;
+            r = 1;
+            x_loc = x;
+            y_loc = y;
+            store RLX #y_loc r;
+            load RLX #x_loc b;
+            end: r = 1;
+            exists (0:a = 0 /\ 1:b = 0);
+            )"""";
+
+std::string WriteProgram(const std::string& name, const std::string& contents) {
+    auto path = std::filesystem::temp_directory_path() / (name + std::to_string(getpid()) + ".txt");
+    std::ofstream{path} << contents;
+    return path.string();
+}
+
+std::vector<std::string> Request(ProgramServer& server, const std::string& request) {
+    std::vector<std::string> lines;
+    server.Handle(request, [&lines] (const std::string& line) {
+        lines.push_back(line);
+    });
+    return lines;
+}
+
+std::string LoadHash(ProgramServer& server, const std::string& path) {
+    auto lines = Request(server, "load " + path);
+    EXPECT_EQ(lines.size(), 1);
+    EXPECT_EQ(lines[0].rfind("program ", 0), 0) << lines[0];
+    return lines[0].substr(8, 16);
+}
+
+}  // namespace
+
+TEST(TestProgramServer, CachedExploration) {
+    ProgramServer server;
+    std::string hash = LoadHash(server, WriteProgram("sb", kStoreBuffering));
+    EXPECT_EQ(LoadHash(server, WriteProgram("sb_copy", kStoreBuffering)), hash);
+
+    auto first = Request(server, "explore " + hash + " graph tso 0 6 all-outcomes");
+    ASSERT_EQ(first.size(), 5);
+    EXPECT_EQ(first[4].rfind("done completed cached=0 ", 0), 0) << first[4];
+    EXPECT_NE(first[4].find("outcomes=4 found=true"), std::string::npos) << first[4];
+
+    auto second = Request(server, "explore " + hash + " graph tso 0 6 all-outcomes");
+    ASSERT_EQ(second.size(), 5);
+    EXPECT_EQ(second[4].rfind("done completed cached=1 ", 0), 0) << second[4];
+    EXPECT_TRUE(std::equal(first.begin(), first.begin() + 4, second.begin()));
+
+    auto target = Request(server, "explore " + hash + " mc tso 0 6");
+    EXPECT_EQ(target.back().rfind("done target-found cached=0 ", 0), 0) << target.back();
+}
+
+TEST(TestProgramServer, ReloadsChangedFile) {
+    ProgramServer server;
+    std::string path = WriteProgram("changed", kStoreBuffering);
+    std::string hash = LoadHash(server, path);
+    std::string changed = kStoreBuffering;
+    changed.replace(changed.find("0:a = 0"), 7, "0:a = 1");
+    std::ofstream{path} << changed;
+    std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds{1});
+    EXPECT_NE(LoadHash(server, path), hash);
+}
+
+TEST(TestProgramServer, Errors) {
+    ProgramServer server;
+    std::string hash = LoadHash(server, WriteProgram("errors", kStoreBuffering));
+    std::vector<std::string> requests = {"explore 0123456789abcdef graph sc 0 6", "explore " + hash + " random sc 0 6",
+                                         "explore " + hash + " graph ra 0 6", "explore " + hash + " graph sc 0 x", "unknown", "load /nonexistent"};
+    for (auto& request : requests) {
+        auto lines = Request(server, request);
+        ASSERT_EQ(lines.size(), 1) << request;
+        EXPECT_EQ(lines[0].rfind("error ", 0), 0) << request;
+    }
+}
+
+int Connect(const std::string& socket_path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    socket_path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+    // the server may not be listening yet
+    for (size_t attempt = 0; connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0; ++attempt) {
+        EXPECT_LT(attempt, 100);
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    return fd;
+}
+
+// reads until the response ends with a non-empty `suffix` or the server closes the connection
+std::string Receive(int fd, const std::string& suffix) {
+    std::string response;
+    char buffer[4096];
+    while (suffix.empty() || response.size() < suffix.size() || response.compare(response.size() - suffix.size(), suffix.size(), suffix) != 0) {
+        ssize_t count = recv(fd, buffer, sizeof(buffer), 0);
+        if (count <= 0) {
+            break;
+        }
+        response.append(buffer, count);
+    }
+    return response;
+}
+
+TEST(TestProgramServer, Socket) {
+    std::string socket_path = (std::filesystem::temp_directory_path() / ("wmm_server" + std::to_string(getpid()) + ".sock")).string();
+    std::string program_path = WriteProgram("socket", kStoreBuffering);
+    ProgramServer server;
+    std::thread serving([&] () {
+        server.Serve(socket_path, 2);
+    });
+    // idle clients don't hold the workers
+    int idle_fds[] = {Connect(socket_path), Connect(socket_path)};
+    int fd = Connect(socket_path);
+    std::string hash = LoadHash(server, program_path);
+    std::string program_line = "program " + hash + "\n";
+    std::string requests = "load " + program_path + "\nexplore " + hash + " graph sc 0 6 all-outcomes\nload " + program_path + "\n";
+    ASSERT_EQ(send(fd, requests.data(), requests.size(), 0), static_cast<ssize_t>(requests.size()));
+    // responses come in the order of requests
+    std::string response = Receive(fd, "\n" + program_line);
+    EXPECT_EQ(response.rfind(program_line, 0), 0) << response;
+    EXPECT_NE(response.find("done completed cached=0 "), std::string::npos) << response;
+    EXPECT_EQ(response.find(program_line, program_line.size()), response.size() - program_line.size()) << response;
+    ASSERT_EQ(send(fd, "shutdown\n", 9, 0), 9);
+    EXPECT_EQ(Receive(fd, ""), "done\n");
+    close(fd);
+    for (int idle_fd : idle_fds) {
+        close(idle_fd);
+    }
+    serving.join();
+    EXPECT_FALSE(std::filesystem::exists(socket_path));
+}
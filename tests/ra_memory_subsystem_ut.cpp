@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "../api/exploration.h"
+#include "../memory_subsystem/ra/ra_memory_subsystem.h"
+#include "../parser/parser.h"
+
+namespace {
+
+// message passing with the given access modes of the store and the load of the flag
+std::string CreateMessagePassing(const std::string& store_mode, const std::string& load_mode) {
+    return R""""(
+            shared_state: x y;
+            one = 1;
+            x_loc = x;
+            y_loc = y;
+            store RLX #x_loc one;
+            store )"""" + store_mode + R""""( #y_loc one;
+            done = 1;
+            if done goto end;
+            x_loc = x;
+            y_loc = y;
+            load )"""" + load_mode + R""""( #y_loc a;
+            load RLX #x_loc b;
+            end: done = 1;
+            exists (1:a = 1 /\ 1:b = 0);
+            )"""";
+}
+
+const std::string kStoreBuffering = R""""(
+            shared_state: x y;
+            r = 1;
+            x_loc = x;
+            y_loc = y;
+            store RLX #x_loc r;
+            load RLX #y_loc a;
+            if r goto end;
+            r = 1;
+            x_loc = x;
+            y_loc = y;
+            store RLX #y_loc r;
+            load RLX #x_loc b;
+            end: r = 1;
+            exists (0:a = 0 /\ 1:b = 0);
+            )"""";
+
+bool IsReachable(const std::string& text, const std::vector<size_t>& instruction_pointers) {
+    auto program = CreateProgram(Parse(std::string_view{text}), instruction_pointers);
+    ExplorationConfig config;
+    config.mode = ExplorationMode::OPERATIONAL;
+    config.model = "ra";
+    auto result = Exploration{program, config}.Run();
+    EXPECT_TRUE(result.found.has_value());
+    return result.found.value_or(false);
+}
+
+std::vector<uint64_t> GetStateKey(const MemorySubsystem& memory) {
+    std::vector<uint64_t> key;
+    memory.AppendStateKey(key);
+    return key;
+}
+
+}  // namespace
+
+TEST(TestRaMemorySubsystem, Verdicts) {
+    EXPECT_FALSE(IsReachable(CreateMessagePassing("REL", "ACQ"), {0, 7}));
+    EXPECT_TRUE(IsReachable(CreateMessagePassing("RLX", "RLX"), {0, 7}));
+    EXPECT_TRUE(IsReachable(CreateMessagePassing("REL", "RLX"), {0, 7}));
+    EXPECT_TRUE(IsReachable(kStoreBuffering, {0, 6}));
+}
+
+TEST(TestRaMemorySubsystem, RenumberedTimestamps) {
+    ProgramDescriptor descriptor;
+    descriptor.memory_size = 1;
+    descriptor.memory_name = {"x"};
+    // thread 1 never reads again, so only the latest message of x stays readable
+    RaMemorySubsystem overwritten{descriptor, 2};
+    overwritten.MarkThreadCompleted(1);
+    overwritten.MakeWriteTransition(0, WriteLabel{AccessMode::RLX, 1, 0});
+    overwritten.MakeWriteTransition(0, WriteLabel{AccessMode::RLX, 2, 0});
+    RaMemorySubsystem written{descriptor, 2};
+    written.MarkThreadCompleted(1);
+    written.MakeWriteTransition(0, WriteLabel{AccessMode::RLX, 2, 0});
+    EXPECT_EQ(GetStateKey(overwritten), GetStateKey(written));
+    EXPECT_EQ(written.GetMainMemory(), std::vector<uint64_t>{2});
+
+    // a running thread still may read the older message
+    RaMemorySubsystem reader_running{descriptor, 2};
+    reader_running.MakeWriteTransition(0, WriteLabel{AccessMode::RLX, 1, 0});
+    reader_running.MakeWriteTransition(0, WriteLabel{AccessMode::RLX, 2, 0});
+    reader_running.MarkThreadCompleted(1);
+    EXPECT_EQ(GetStateKey(reader_running), GetStateKey(written));
+    EXPECT_EQ(reader_running.GetAvailablePropagations().size(), 0);
+}
+
+TEST(TestRaMemorySubsystem, FailedCompareExchange) {
+    ProgramDescriptor descriptor;
+    descriptor.memory_size = 1;
+    descriptor.memory_name = {"x"};
+    for (AccessMode mode : {AccessMode::RLX, AccessMode::ACQ, AccessMode::REL_ACQ, AccessMode::SEQ_CST}) {
+        // the failed compare-exchange behaves as a read of the latest message
+        RaMemorySubsystem failed{descriptor, 2};
+        failed.MakeWriteTransition(0, WriteLabel{AccessMode::REL, 1, 0});
+        EXPECT_EQ(failed.MakeRmwTransition(0, RmwLabel{mode, 0, RmwAtomicOperation{RmwKind::COMPARE_EXCHANGE, 5, 7}}), 1);
+        RaMemorySubsystem read{descriptor, 2};
+        read.MakeWriteTransition(0, WriteLabel{AccessMode::REL, 1, 0});
+        EXPECT_EQ(read.MakeReadTransition(0, ReadLabel{mode, 0}), 1);
+        EXPECT_EQ(GetStateKey(failed), GetStateKey(read)) << static_cast<int>(mode);
+        // thread 1 may still read the initial message or advance to the only new one
+        EXPECT_EQ(failed.GetVisibleValue(1, 0), 0);
+        EXPECT_EQ(failed.GetAvailablePropagations().size(), 1);
+
+        RaMemorySubsystem succeeded{descriptor, 2};
+        succeeded.MakeWriteTransition(0, WriteLabel{AccessMode::REL, 1, 0});
+        EXPECT_EQ(succeeded.MakeRmwTransition(0, RmwLabel{mode, 0, RmwAtomicOperation{RmwKind::COMPARE_EXCHANGE, 1, 7}}), 1);
+        EXPECT_EQ(succeeded.GetMainMemory(), std::vector<uint64_t>{7});
+    }
+}
@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include "../axiomatic/relation.h"
+
+namespace {
+
+// acyclic relation (edges only go forward) with a few edges per element, like po | rf | co of a large execution graph
+Relation MakeRandomDag(size_t size, size_t edges_per_element, uint32_t seed) {
+    std::mt19937 generator(seed);
+    Relation relation(size);
+    for (size_t from = 0; from + 1 < size; ++from) {
+        std::uniform_int_distribution<size_t> distribution(from + 1, size - 1);
+        for (size_t edge = 0; edge < edges_per_element; ++edge) {
+            relation.Add(from, distribution(generator));
+        }
+    }
+    return relation;
+}
+
+void BM_Union(benchmark::State& state) {
+    Relation lhs = MakeRandomDag(state.range(0), 4, 1);
+    Relation rhs = MakeRandomDag(state.range(0), 4, 2);
+    for (auto _ : state) {
+        Relation result = lhs | rhs;
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+void BM_Compose(benchmark::State& state) {
+    Relation lhs = MakeRandomDag(state.range(0), 4, 1);
+    Relation rhs = MakeRandomDag(state.range(0), 4, 2);
+    for (auto _ : state) {
+        Relation result = lhs.Compose(rhs);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+void BM_TransitiveClosure(benchmark::State& state) {
+    Relation relation = MakeRandomDag(state.range(0), 2, 1);
+    for (auto _ : state) {
+        Relation result = relation;
+        result.TransitivelyClose();
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+// one more edge into an already closed relation, the way events are added to a graph one by one
+void BM_IncrementalClosure(benchmark::State& state) {
+    size_t size = state.range(0);
+    Relation closed = MakeRandomDag(size, 2, 1);
+    closed.TransitivelyClose();
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<size_t> distribution(0, size / 2 - 1);
+    for (auto _ : state) {
+        state.PauseTiming();
+        Relation result = closed;
+        size_t from = distribution(generator);
+        state.ResumeTiming();
+        result.AddClosed(from, from + size / 2);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+void BM_FindCycle(benchmark::State& state) {
+    size_t size = state.range(0);
+    Relation relation = MakeRandomDag(size, 4, 1);
+    relation.Add(size - 1, 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(relation.FindCycle());
+    }
+}
+
+}  // namespace
+
+BENCHMARK(BM_Union)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_Compose)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_TransitiveClosure)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_IncrementalClosure)->RangeMultiplier(4)->Range(64, 4096);
+BENCHMARK(BM_FindCycle)->RangeMultiplier(4)->Range(64, 4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "../axiomatic/relation.h"
+
+TEST(TestRelation, AddContains) {
+    Relation relation(130);
+    relation.Add(0, 129);
+    relation.Add(64, 63);
+    EXPECT_TRUE(relation.Contains(0, 129));
+    EXPECT_TRUE(relation.Contains(64, 63));
+    EXPECT_FALSE(relation.Contains(129, 0));
+    EXPECT_EQ(relation.Successors(0), std::vector<size_t>{129});
+}
+
+TEST(TestRelation, UnionInverseCompose) {
+    Relation lhs(4);
+    Relation rhs(4);
+    lhs.Add(0, 1);
+    lhs.Add(0, 2);
+    rhs.Add(1, 3);
+    rhs.Add(2, 2);
+
+    Relation united = lhs | rhs;
+    EXPECT_TRUE(united.Contains(0, 1));
+    EXPECT_TRUE(united.Contains(1, 3));
+
+    Relation composed = lhs.Compose(rhs);
+    EXPECT_EQ(composed.Successors(0), (std::vector<size_t>{2, 3}));
+    EXPECT_TRUE(composed.Successors(1).empty());
+
+    Relation inverse = lhs.Inverse();
+    EXPECT_TRUE(inverse.Contains(2, 0));
+    EXPECT_FALSE(inverse.Contains(0, 2));
+
+    united.RemoveIdentity();
+    EXPECT_FALSE(united.Contains(2, 2));
+}
+
+TEST(TestRelation, IncrementalClosureMatchesClosure) {
+    const size_t size = 100;
+    Relation incremental(size);
+    Relation relation(size);
+    for (size_t i = 0; i + 3 < size; i += 3) {
+        incremental.AddClosed(i + 3, i);
+        relation.Add(i + 3, i);
+        incremental.AddClosed(i, i + 1);
+        relation.Add(i, i + 1);
+    }
+    relation.TransitivelyClose();
+    for (size_t from = 0; from < size; ++from) {
+        EXPECT_EQ(incremental.Successors(from), relation.Successors(from));
+    }
+    EXPECT_TRUE(relation.Contains(99, 1));
+    EXPECT_FALSE(relation.Contains(1, 99));
+}
+
+TEST(TestRelation, FindCycle) {
+    Relation relation(70);
+    relation.Add(0, 65);
+    relation.Add(65, 3);
+    EXPECT_TRUE(relation.IsAcyclic());
+    relation.Add(3, 0);
+    auto cycle = relation.FindCycle();
+    ASSERT_TRUE(cycle);
+    EXPECT_EQ(*cycle, (std::vector<size_t>{0, 65, 3}));
+}
+
+TEST(TestRelation, Resize) {
+    Relation relation(60);
+    relation.Add(59, 1);
+    relation.Resize(70);
+    relation.Add(69, 59);
+    EXPECT_TRUE(relation.Contains(59, 1));
+    EXPECT_TRUE(relation.Contains(69, 59));
+    EXPECT_FALSE(relation.Contains(1, 59));
+}
+
+TEST(TestRelation, Shrink) {
+    Relation relation(130);
+    relation.Add(0, 129);
+    relation.Add(1, 40);
+    relation.Add(2, 1);
+    relation.Add(129, 0);
+    relation.Resize(30);
+    EXPECT_EQ(relation.Size(), 30);
+    EXPECT_EQ(relation.Successors(0), std::vector<size_t>{});
+    EXPECT_EQ(relation.Successors(1), std::vector<size_t>{});
+    EXPECT_EQ(relation.Successors(2), std::vector<size_t>{1});
+    // columns dropped within the same word don't come back when growing again
+    relation.Resize(50);
+    EXPECT_FALSE(relation.Contains(1, 40));
+    EXPECT_TRUE(relation.Contains(2, 1));
+
+    Relation same_words(60);
+    same_words.Add(3, 50);
+    same_words.Resize(40);
+    same_words.Resize(60);
+    EXPECT_FALSE(same_words.Contains(3, 50));
+}
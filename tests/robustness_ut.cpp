@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "../api/exploration.h"
+#include "../axiomatic/robustness.h"
+
+namespace {
+
+bool IsRobust(const std::string& file, MemoryModel model) {
+    auto program = OpenProgram(std::string{WMM_EXAMPLES_DIR} + "/" + file);
+    RobustnessChecker checker{program->descriptor, {0, 6}, model, false};
+    checker.Explore();
+    return !checker.GetViolation().has_value();
+}
+
+}  // namespace
+
+TEST(TestRobustness, StoreBuffering) {
+    EXPECT_TRUE(IsRobust("store_buffering.txt", MemoryModel::SC));
+    EXPECT_FALSE(IsRobust("store_buffering.txt", MemoryModel::TSO));
+    EXPECT_FALSE(IsRobust("store_buffering.txt", MemoryModel::PSO));
+}
+
+TEST(TestRobustness, MessagePassing) {
+    EXPECT_TRUE(IsRobust("simple_pso.txt", MemoryModel::TSO));
+    EXPECT_FALSE(IsRobust("simple_pso.txt", MemoryModel::PSO));
+}
+
+TEST(TestRobustness, ViolationCycle) {
+    auto program = OpenProgram(std::string{WMM_EXAMPLES_DIR} + "/store_buffering.txt");
+    RobustnessChecker checker{program->descriptor, {0, 6}, MemoryModel::TSO, false};
+    checker.Explore();
+    auto& violation = checker.GetViolation();
+    ASSERT_TRUE(violation.has_value());
+    // both writes and both reads take part in the cycle
+    EXPECT_EQ(violation->cycle.size(), 4);
+}
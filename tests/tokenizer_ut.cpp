@@ -156,6 +156,23 @@ TEST(TestTokenizer, TestFAIInstruction) {
                 SymbolToken{"r3"});
 }
 
+TEST(TestTokenizer, TestFetchOpInstructions) {
+    CheckTokens("r1 := xchg RLX #r2 r3; r4 := fetch_or ACQ #r2 r3",
+                SymbolToken{"r1"},
+                AssignmentToken{},
+                KeywordToken::XCHG,
+                KeywordToken::RLX,
+                TaggedSymbolToken{"r2"},
+                SymbolToken{"r3"},
+                SemicolonToken{},
+                SymbolToken{"r4"},
+                AssignmentToken{},
+                KeywordToken::FETCH_OR,
+                KeywordToken::ACQ,
+                TaggedSymbolToken{"r2"},
+                SymbolToken{"r3"});
+}
+
 TEST(TestTokenizer, LabelledInstruction) {
     CheckTokens("main_loop: r1 := fai REL_ACQ #r2 r3",
                 SymbolToken{"main_loop"},
@@ -216,3 +233,58 @@ TEST(TestTokenizer, MemoryAccessMode) {
                 KeywordToken::REL_ACQ,
                 KeywordToken::RLX);
 }
+
+TEST(TestTokenizer, FinalCondition) {
+    CheckTokens("exists (0:a = 1 /\\ ~(x = 2 \\/ 1:b = 0))",
+                KeywordToken::EXISTS,
+                LeftParenthesisToken{},
+                ConstantToken{0},
+                ColonToken{},
+                SymbolToken{"a"},
+                ThreadLocalAssignmentToken{},
+                ConstantToken{1},
+                ConjunctionToken{},
+                NegationToken{},
+                LeftParenthesisToken{},
+                SymbolToken{"x"},
+                ThreadLocalAssignmentToken{},
+                ConstantToken{2},
+                DisjunctionToken{},
+                ConstantToken{1},
+                ColonToken{},
+                SymbolToken{"b"},
+                ThreadLocalAssignmentToken{},
+                ConstantToken{0},
+                RightParenthesisToken{},
+                RightParenthesisToken{});
+}
+
+TEST(TestTokenizer, DivisionIsNotConjunction) {
+    CheckTokens("r = r1 / r2",
+                SymbolToken{"r"},
+                ThreadLocalAssignmentToken{},
+                SymbolToken{"r1"},
+                BinOp::DIVIDE,
+                SymbolToken{"r2"});
+}
+
+TEST(TestTokenizer, SymbolsAreViewsOfInput) {
+    std::string data = "store RLX #x_loc value;";
+    Tokenizer tokenizer{std::string_view{data}};
+    tokenizer.Next();
+    tokenizer.Next();
+    auto tagged = std::get<TaggedSymbolToken>(tokenizer.GetToken()).value;
+    ASSERT_EQ(tagged, "x_loc");
+    ASSERT_EQ(tagged.data(), data.data() + data.find("x_loc"));
+    tokenizer.Next();
+    ASSERT_EQ(std::get<SymbolToken>(tokenizer.GetToken()).value, "value");
+    tokenizer.Next();
+    ASSERT_TRUE(std::holds_alternative<SemicolonToken>(tokenizer.GetToken()));
+    tokenizer.Next();
+    ASSERT_TRUE(tokenizer.IsDone());
+}
+
+TEST(TestTokenizer, TooLargeConstant) {
+    ASSERT_EQ(std::get<ConstantToken>(Tokenizer{std::string_view{"18446744073709551615"}}.GetToken()).value, 18446744073709551615ull);
+    ASSERT_THROW(Tokenizer{std::string_view{"18446744073709551616"}}, std::runtime_error);
+}
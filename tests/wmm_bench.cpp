@@ -0,0 +1,222 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../api/exploration.h"
+#include "../executors/controllable_executor.h"
+#include "../memory_subsystem/memory_subsystem_factory.h"
+#include "../memory_subsystem/pso/pso_memory_subsystem.h"
+#include "../memory_subsystem/sc/sc_memory_subsystem.h"
+#include "../memory_subsystem/tso/tso_memory_subsystem.h"
+
+namespace {
+
+constexpr size_t kThreads = 4;
+
+// memory subsystems only look at the memory size and the names of the cells
+ProgramDescriptor CreateDescriptor(size_t memory_size) {
+    ProgramDescriptor descriptor;
+    descriptor.memory_size = memory_size;
+    for (size_t cell = 0; cell < memory_size; ++cell) {
+        descriptor.memory_name.push_back("m" + std::to_string(cell));
+    }
+    return descriptor;
+}
+
+// every thread has `depth` pending writes spread over the cells, behind the base pointer as in the executors
+template <typename Model>
+std::unique_ptr<MemorySubsystem> CreateMemory(const ProgramDescriptor& descriptor, size_t depth) {
+    std::unique_ptr<MemorySubsystem> memory = std::make_unique<Model>(descriptor, kThreads);
+    for (size_t tid = 0; tid < kThreads; ++tid) {
+        for (size_t i = 0; i < depth; ++i) {
+            memory->MakeWriteTransition(tid, WriteLabel{AccessMode::RLX, i + 1, static_cast<MemoryCell>((tid + i) % descriptor.memory_size)});
+        }
+    }
+    benchmark::DoNotOptimize(memory.get());
+    benchmark::ClobberMemory();
+    return memory;
+}
+
+template <typename Model>
+void BM_Read(benchmark::State& state) {
+    auto descriptor = CreateDescriptor(state.range(0));
+    auto memory = CreateMemory<Model>(descriptor, state.range(1));
+    MemoryCell cell = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(memory->MakeReadTransition(0, ReadLabel{AccessMode::RLX, cell}));
+        cell = cell + 1 == descriptor.memory_size ? 0 : cell + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// `depth` writes of a thread and the fence draining them, items are writes
+template <typename Model>
+void BM_Write(benchmark::State& state) {
+    auto descriptor = CreateDescriptor(state.range(0));
+    size_t depth = state.range(1);
+    auto memory = CreateMemory<Model>(descriptor, 0);
+    for (auto _ : state) {
+        for (size_t i = 0; i < depth; ++i) {
+            memory->MakeWriteTransition(0, WriteLabel{AccessMode::RLX, i, static_cast<MemoryCell>(i % descriptor.memory_size)});
+        }
+        memory->MakeFenceTransition(0, FenceLabel{AccessMode::SEQ_CST});
+    }
+    state.SetItemsProcessed(state.iterations() * depth);
+}
+
+// a write followed by the propagation of some pending write, as an executor enumerates and selects it;
+// the total number of pending writes stays the same
+template <typename Model>
+void BM_WritePropagate(benchmark::State& state) {
+    auto descriptor = CreateDescriptor(state.range(0));
+    auto memory = CreateMemory<Model>(descriptor, state.range(1));
+    uint64_t value = 0;
+    for (auto _ : state) {
+        memory->MakeWriteTransition(0, WriteLabel{AccessMode::RLX, ++value, static_cast<MemoryCell>(value % descriptor.memory_size)});
+        auto propagations = memory->GetAvailablePropagations();
+        memory->MakePropagation(propagations[value % propagations.size()]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Model>
+void BM_GetAvailablePropagations(benchmark::State& state) {
+    auto descriptor = CreateDescriptor(state.range(0));
+    auto memory = CreateMemory<Model>(descriptor, state.range(1));
+    size_t propagations = 0;
+    for (auto _ : state) {
+        auto available = memory->GetAvailablePropagations();
+        propagations += available.size();
+        benchmark::DoNotOptimize(available.data());
+    }
+    state.SetItemsProcessed(propagations);
+}
+
+template <typename Model>
+void BM_Clone(benchmark::State& state) {
+    auto descriptor = CreateDescriptor(state.range(0));
+    auto memory = CreateMemory<Model>(descriptor, state.range(1));
+    for (auto _ : state) {
+        auto clone = memory->Clone();
+        benchmark::DoNotOptimize(clone.get());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+struct Example {
+    const char* file;
+    std::vector<size_t> instruction_pointers;
+};
+
+const std::vector<Example> kExamples = {
+        {"store_buffering.txt", {0, 6}},
+        {"simple_pso.txt", {0, 6}},
+        {"spin_lock.txt", {0, 14}},
+        {"private_scratch.txt", {0, 10}},
+};
+
+ProgramPtr OpenExample(const Example& example) {
+    return OpenProgram(std::string{WMM_EXAMPLES_DIR} + "/" + example.file);
+}
+
+// every outcome of an example, states are visited operational states or consistent graphs
+void BM_Explore(benchmark::State& state, const Example& example, ExplorationMode mode, const std::string& model) {
+    auto program = OpenExample(example);
+    ExplorationConfig config;
+    config.mode = mode;
+    config.model = model;
+    config.instruction_pointers = example.instruction_pointers;
+    config.stop_at_target = false;
+    Exploration exploration{program, config};
+    size_t states = 0;
+    for (auto _ : state) {
+        states += exploration.Run().states;
+    }
+    state.SetItemsProcessed(states);
+    state.counters["explorations"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// random walks from the initial state to a terminal one, selecting transitions as the random mode does
+void BM_RandomWalk(benchmark::State& state, const Example& example, const std::string& model) {
+    auto program = OpenExample(example);
+    auto& descriptor = program->descriptor;
+    auto initial = CreateControllableExecutor(CreateMemorySubsystem(descriptor, example.instruction_pointers.size(), model), descriptor, example.instruction_pointers);
+    std::mt19937 rng(0);
+    size_t steps = 0;
+    for (auto _ : state) {
+        auto executor = initial.Clone();
+        while (!executor.IsTerminal()) {
+            auto running_threads = executor.GetThreadsNextPossibleSteps();
+            auto propagations = executor.GetPropagateTransitions();
+            size_t options_cnt = running_threads.size() + propagations.size();
+            if (options_cnt == 0) {
+                break;
+            }
+            executor.SelectTransition(std::uniform_int_distribution<size_t>(0, options_cnt - 1)(rng), running_threads, propagations);
+            ++steps;
+        }
+        benchmark::DoNotOptimize(executor.GetOutcome());
+    }
+    state.SetItemsProcessed(steps);
+    state.counters["walks"] = benchmark::Counter(state.iterations(), benchmark::Counter::kIsRate);
+}
+
+// memory sizes and buffer depths; SC has no buffers
+void MemoryArguments(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({"cells", "depth"});
+    for (int64_t cells : {4, 64, 1024}) {
+        for (int64_t depth : {1, 8, 64}) {
+            benchmark->Args({cells, depth});
+        }
+    }
+}
+
+void ScMemoryArguments(benchmark::internal::Benchmark* benchmark) {
+    benchmark->ArgNames({"cells", "depth"});
+    for (int64_t cells : {4, 64, 1024}) {
+        benchmark->Args({cells, 1});
+    }
+}
+
+void RegisterExplorations() {
+    for (auto& example : kExamples) {
+        std::string name = example.file;
+        name = name.substr(0, name.find('.'));
+        for (std::string model : {"sc", "tso", "pso"}) {
+            benchmark::RegisterBenchmark(("BM_ModelChecking/" + name + "/" + model).c_str(), BM_Explore, example, ExplorationMode::OPERATIONAL, model);
+            benchmark::RegisterBenchmark(("BM_GraphExploration/" + name + "/" + model).c_str(), BM_Explore, example, ExplorationMode::GRAPH, model);
+            benchmark::RegisterBenchmark(("BM_RandomWalk/" + name + "/" + model).c_str(), BM_RandomWalk, example, model);
+        }
+        benchmark::RegisterBenchmark(("BM_ModelChecking/" + name + "/ra").c_str(), BM_Explore, example, ExplorationMode::OPERATIONAL, "ra");
+    }
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Read, ScMemorySubsystem)->Apply(ScMemoryArguments);
+BENCHMARK_TEMPLATE(BM_Read, TsoMemorySubsystem)->Apply(MemoryArguments);
+BENCHMARK_TEMPLATE(BM_Read, PsoMemorySubsystem)->Apply(MemoryArguments);
+BENCHMARK_TEMPLATE(BM_Write, ScMemorySubsystem)->Apply(ScMemoryArguments);
+BENCHMARK_TEMPLATE(BM_Write, TsoMemorySubsystem)->Apply(MemoryArguments);
+BENCHMARK_TEMPLATE(BM_Write, PsoMemorySubsystem)->Apply(MemoryArguments);
+BENCHMARK_TEMPLATE(BM_WritePropagate, TsoMemorySubsystem)->Apply(MemoryArguments);
+BENCHMARK_TEMPLATE(BM_WritePropagate, PsoMemorySubsystem)->Apply(MemoryArguments);
+BENCHMARK_TEMPLATE(BM_GetAvailablePropagations, TsoMemorySubsystem)->Apply(MemoryArguments);
+BENCHMARK_TEMPLATE(BM_GetAvailablePropagations, PsoMemorySubsystem)->Apply(MemoryArguments);
+BENCHMARK_TEMPLATE(BM_Clone, ScMemorySubsystem)->Apply(ScMemoryArguments);
+BENCHMARK_TEMPLATE(BM_Clone, TsoMemorySubsystem)->Apply(MemoryArguments);
+BENCHMARK_TEMPLATE(BM_Clone, PsoMemorySubsystem)->Apply(MemoryArguments);
+
+int main(int argc, char** argv) {
+    RegisterExplorations();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -19,6 +19,14 @@ void ThreadLocalStorage::SetRegisterValue(Register reg, uint64_t val) {
     value_[reg] = val;
 }
 
+const std::vector<uint64_t>& ThreadLocalStorage::GetValues() const {
+    return value_;
+}
+
+uint64_t* ThreadLocalStorage::GetRegisterFile() {
+    return value_.data();
+}
+
 void ThreadLocalStorage::Print(std::ostream& os, size_t indent) const {
     os << Indent{indent} << "Registers' state:\n";
     for (size_t i = 0; i < value_.size(); ++i) {
@@ -16,6 +16,11 @@ struct ThreadLocalStorage {
 
     void SetRegisterValue(Register reg, uint64_t val);
 
+    [[nodiscard]] const std::vector<uint64_t>& GetValues() const;
+
+    // unchecked access for interpreters of compiled programs, their registers are validated in advance
+    uint64_t* GetRegisterFile();
+
     void Print(std::ostream& os, size_t indent = 0) const;
 
 private:
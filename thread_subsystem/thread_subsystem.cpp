@@ -94,6 +94,18 @@ Instruction Thread::GetNextInstruction() const {
     return instructions_[instruction_pointer_];
 }
 
+size_t Thread::GetInstructionPointer() const {
+    return instruction_pointer_;
+}
+
+const Instruction& Thread::GetInstruction(size_t ip) const {
+    return instructions_[ip];
+}
+
 const ThreadLocalStorage& Thread::GetRegisters() const {
     return registers_;
 }
+
+uint64_t* Thread::GetRegisterFile() {
+    return registers_.GetRegisterFile();
+}
@@ -25,12 +25,15 @@ struct Thread {
     void AdvanceInstructionPointer();
     void MoveInstructionPointer(size_t where);
     Instruction GetNextInstruction() const;
+    size_t GetInstructionPointer() const;
+    const Instruction& GetInstruction(size_t ip) const;
 
     const ThreadLocalStorage& GetRegisters() const;
+    uint64_t* GetRegisterFile();
 
 private:
     const std::vector<Instruction>& instructions_;
-    const std::vector<std::string>& instructions_str_;
+    const InstructionText& instructions_str_;
     ThreadLocalStorage registers_;
     size_t instruction_pointer_ = 0;
     size_t thread_id_;
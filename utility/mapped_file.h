@@ -0,0 +1,24 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// whole file mapped read-only into memory, its contents are valid while the object lives
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] std::string_view GetContents() const;
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+#endif //MAPPED_FILE_H